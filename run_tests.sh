@@ -5,6 +5,7 @@
 #   ./run_tests.sh                    # Run all tests
 #   ./run_tests.sh test_usd_document  # Run specific test file
 #   ./run_tests.sh -v                 # Verbose output
+#   ./run_tests.sh --bench            # Run benchmarks in tests/bench
 
 set -e
 
@@ -40,7 +41,11 @@ echo ""
 GUT_ARGS="-d -s addons/gut/gut_cmdln.gd"
 
 # Handle arguments
-if [ "$1" == "-v" ] || [ "$1" == "--verbose" ]; then
+if [ "$1" == "--bench" ]; then
+    # Benchmarks are slow and only report timings, so they are opt-in
+    GUT_ARGS="$GUT_ARGS -gdir=res://tests/bench -gprefix=bench_ -glog=2"
+    shift
+elif [ "$1" == "-v" ] || [ "$1" == "--verbose" ]; then
     GUT_ARGS="$GUT_ARGS -glog=3"
     shift
 elif [ -n "$1" ]; then
@@ -298,7 +298,7 @@ std::string McpServer::handle_initialize(const std::string& id) {
     // usd/reflect_to_scene
     JsonValue tool11 = JsonValue::object();
     tool11.set("name", JsonValue::string("usd/reflect_to_scene"));
-    tool11.set("description", JsonValue::string("Import a USD stage to the current scene as a group. Returns confirmation token if group exists."));
+    tool11.set("description", JsonValue::string("Import a USD stage to the current scene as a group. Returns confirmation token if group exists. With force, an existing group is updated incrementally unless full_rebuild is set."));
     tools_array.push(tool11);
 
     // usd/confirm_reflect
@@ -346,7 +346,7 @@ std::string McpServer::handle_initialize(const std::string& id) {
     // godot/get_bounding_box (Phase 1)
     JsonValue tool19 = JsonValue::object();
     tool19.set("name", JsonValue::string("godot/get_bounding_box"));
-    tool19.set("description", JsonValue::string("Get the axis-aligned bounding box (AABB) of a node and all its children. Params: node_path. Returns min/max bounds and size in world space."));
+    tool19.set("description", JsonValue::string("Get the axis-aligned bounding box (AABB) of a node and all its children. Params: node_path. Returns min/max bounds, center and size in world space, and source: 'usd' when the node belongs to a reflected USD group and was answered from the stage's cached bounds hierarchy, 'scene' when it was measured from the scene tree."));
     tools_array.push(tool19);
 
     // godot/get_selection (Phase 1)
@@ -1117,12 +1117,14 @@ std::string McpServer::handle_create_scene_group(const std::string& id, const st
 std::string McpServer::handle_reflect_to_scene(const std::string& id, const std::string& request) {
     std::string file_path = extract_string_param(request, "file_path");
     bool force = extract_bool_param(request, "force");
+    bool full_rebuild = extract_bool_param(request, "full_rebuild");
 
     if (file_path.empty()) {
         return build_error(id, -32602, "Missing required parameter: file_path");
     }
 
-    log_operation("usd/reflect_to_scene", "Reflecting " + file_path + " (force=" + (force ? "true" : "false") + ")");
+    log_operation("usd/reflect_to_scene", "Reflecting " + file_path + " (force=" + (force ? "true" : "false") +
+            ", full_rebuild=" + (full_rebuild ? "true" : "false") + ")");
 
     godot::UsdStageGroupMapping* mapping = godot::UsdStageGroupMapping::get_singleton();
     if (!mapping) {
@@ -1172,8 +1174,10 @@ std::string McpServer::handle_reflect_to_scene(const std::string& id, const std:
         return build_error(id, -32603, "Import functionality not available");
     }
 
-    // Call import callback (runs on main thread via call_deferred)
-    int node_count = import_callback_(file_path, group_name_str, true);
+    // Call import callback (runs on main thread via call_deferred). Unless a
+    // full rebuild is requested, an already reflected group is only updated
+    // with what changed.
+    int node_count = import_callback_(file_path, group_name_str, true, !full_rebuild);
 
     if (node_count < 0) {
         return build_error(id, -32603, "Failed to import USD to scene");
@@ -1238,7 +1242,7 @@ std::string McpServer::handle_confirm_reflect(const std::string& id, const std::
     }
 
     // Call import callback with force=true (user already confirmed)
-    int node_count = import_callback_(confirmation.file_path, confirmation.group_name, true);
+    int node_count = import_callback_(confirmation.file_path, confirmation.group_name, true, false);
 
     if (node_count < 0) {
         return build_error(id, -32603, "Failed to import USD to scene");
@@ -19,8 +19,9 @@ public:
     // Callback for logging operations to control panel
     using LogCallback = std::function<void(const std::string&, const std::string&)>;
 
-    // Callback for importing USD to scene group (returns node count on success, -1 on failure)
-    using ImportCallback = std::function<int(const std::string& file_path, const std::string& group_name, bool force)>;
+    // Callback for importing USD to scene group (returns node count on success, -1 on failure).
+    // With incremental, an existing group only receives the changes since the last reflect.
+    using ImportCallback = std::function<int(const std::string& file_path, const std::string& group_name, bool force, bool incremental)>;
 
     // Callback for querying scene tree (returns JSON string with node data)
     using QuerySceneCallback = std::function<std::string(const std::string& path)>;
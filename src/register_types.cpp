@@ -5,6 +5,9 @@
 #include "usd_state.h"
 #include "usd_stage_proxy.h"
 #include "usd_prim_proxy.h"
+#include "usd_stage_player.h"
+#include "usd_payload_loader.h"
+#include "usd_group_reflector.h"
 #include "mcp_server.h"
 #include "mcp_http_server.h"
 #include "mcp_control_panel.h"
@@ -150,6 +153,9 @@ void initialize_godot_usd_module(ModuleInitializationLevel p_level) {
         ClassDB::register_class<UsdState>();
         ClassDB::register_class<UsdStageProxy>();
         ClassDB::register_class<UsdPrimProxy>();
+        ClassDB::register_class<UsdStagePlayer>();
+        ClassDB::register_class<UsdPayloadLoader>();
+        ClassDB::register_class<UsdGroupReflector>();
         ClassDB::register_class<McpControlPanel>();
         ClassDB::register_class<UsdStageManagerPanel>();
 
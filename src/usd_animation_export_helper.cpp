@@ -0,0 +1,257 @@
+#include "usd_animation_export_helper.h"
+#include "usd_layer_writer.h"
+#include "usd_parallel.h"
+#include <godot_cpp/classes/skeleton3d.hpp>
+#include <godot_cpp/core/math.hpp>
+
+// USD headers
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/sdf/types.h>
+#include <pxr/usd/usdGeom/xformOp.h>
+#include <pxr/base/gf/quatf.h>
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/base/gf/vec3f.h>
+
+#include <algorithm>
+
+namespace godot {
+
+// Everything sampled from one node, in frame order
+struct UsdAnimationExportHelper::NodeSamples {
+    SdfTimeSampleMap translate;
+    SdfTimeSampleMap orient;
+    SdfTimeSampleMap scale;
+};
+
+// Nodes sampled per batch; bounds the samples held before they are
+// handed to the layer
+static const size_t NODE_BATCH_SIZE = 256;
+
+static const TfToken &_TranslateOpName() {
+    static const TfToken name = UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeTranslate);
+    return name;
+}
+
+static const TfToken &_OrientOpName() {
+    static const TfToken name = UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeOrient);
+    return name;
+}
+
+static const TfToken &_ScaleOpName() {
+    static const TfToken name = UsdGeomXformOp::GetOpName(UsdGeomXformOp::TypeScale);
+    return name;
+}
+
+static StringName _PickAnimation(AnimationPlayer *p_player) {
+    if (!String(p_player->get_assigned_animation()).is_empty()) {
+        return p_player->get_assigned_animation();
+    }
+    if (!String(p_player->get_autoplay()).is_empty()) {
+        return p_player->get_autoplay();
+    }
+    const PackedStringArray names = p_player->get_animation_list();
+    for (int64_t i = 0; i < names.size(); ++i) {
+        if (names[i] != "RESET") {
+            return StringName(names[i]);
+        }
+    }
+    return StringName();
+}
+
+UsdAnimationExportHelper::UsdAnimationExportHelper() {
+}
+
+UsdAnimationExportHelper::~UsdAnimationExportHelper() {
+}
+
+void UsdAnimationExportHelper::add_player(AnimationPlayer *p_player) {
+    const StringName animation_name = _PickAnimation(p_player);
+    if (String(animation_name).is_empty() || !p_player->has_animation(animation_name)) {
+        return;
+    }
+    Ref<Animation> animation = p_player->get_animation(animation_name);
+    Node *root = p_player->get_node_or_null(p_player->get_root_node());
+    if (animation.is_null() || !root) {
+        return;
+    }
+
+    for (int32_t track = 0; track < animation->get_track_count(); ++track) {
+        if (!animation->track_is_enabled(track)) {
+            continue;
+        }
+        const NodePath path = animation->track_get_path(track);
+        Node3D *node = Object::cast_to<Node3D>(root->get_node_or_null(NodePath(String(path).get_slice(":", 0))));
+        if (!node) {
+            continue;
+        }
+        const String property = path.get_concatenated_subnames();
+        if (Object::cast_to<Skeleton3D>(node) && !property.is_empty()) {
+            continue; // bone track
+        }
+
+        ComponentTrack component;
+        component.track = track;
+        int component_index = -1; // 0 position, 1 rotation, 2 scale
+        switch (animation->track_get_type(track)) {
+            case Animation::TYPE_POSITION_3D:
+                component_index = 0;
+                break;
+            case Animation::TYPE_ROTATION_3D:
+                component_index = 1;
+                break;
+            case Animation::TYPE_SCALE_3D:
+                component_index = 2;
+                break;
+            case Animation::TYPE_VALUE:
+                component.value_track = true;
+                if (property == "position") {
+                    component_index = 0;
+                } else if (property == "quaternion") {
+                    component_index = 1;
+                } else if (property == "rotation") {
+                    component_index = 1;
+                    component.euler = true;
+                } else if (property == "scale") {
+                    component_index = 2;
+                }
+                break;
+            default:
+                break;
+        }
+        if (component_index < 0) {
+            continue;
+        }
+
+        // A node animated by several players keeps the first player's
+        // animation, since USD has a single timeline
+        auto found = _node_indices.find(node->get_instance_id());
+        if (found == _node_indices.end()) {
+            AnimatedNode animated;
+            animated.node_id = node->get_instance_id();
+            animated.animation = animation;
+            animated.rest = node->get_transform();
+            animated.rotation_order = node->get_rotation_order();
+            found = _node_indices.emplace(animated.node_id, _nodes.size()).first;
+            _nodes.push_back(animated);
+        }
+        AnimatedNode &animated = _nodes[found->second];
+        if (animated.animation != animation) {
+            continue;
+        }
+        ComponentTrack &slot = component_index == 0 ? animated.position : (component_index == 1 ? animated.rotation : animated.scale);
+        if (slot.track < 0) {
+            slot = component;
+        }
+    }
+}
+
+bool UsdAnimationExportHelper::is_animated(const Node *p_node) const {
+    return p_node && _node_indices.count(p_node->get_instance_id()) > 0;
+}
+
+void UsdAnimationExportHelper::define_ops(const Node3D *p_node, UsdLayerWriter &p_writer, const SdfPath &p_prim_path) {
+    auto found = _node_indices.find(p_node->get_instance_id());
+    if (found == _node_indices.end()) {
+        return;
+    }
+    AnimatedNode &animated = _nodes[found->second];
+
+    const Transform3D &rest = animated.rest;
+    const Quaternion rotation = rest.basis.get_rotation_quaternion();
+    const Vector3 scale = rest.basis.get_scale();
+
+    p_writer.set_attribute(p_prim_path, _TranslateOpName(), SdfValueTypeNames->Double3, VtValue(GfVec3d(rest.origin.x, rest.origin.y, rest.origin.z)));
+    p_writer.set_attribute(p_prim_path, _OrientOpName(), SdfValueTypeNames->Quatf, VtValue(GfQuatf(rotation.w, rotation.x, rotation.y, rotation.z)));
+    p_writer.set_attribute(p_prim_path, _ScaleOpName(), SdfValueTypeNames->Float3, VtValue(GfVec3f(scale.x, scale.y, scale.z)));
+    p_writer.set_xform_op_order(p_prim_path, VtArray<TfToken>{ _TranslateOpName(), _OrientOpName(), _ScaleOpName() });
+
+    animated.prim_path = p_prim_path;
+}
+
+void UsdAnimationExportHelper::_sample_node(const AnimatedNode &p_node, NodeSamples *r_samples) const {
+    Animation *animation = p_node.animation.ptr();
+    const double fps = _options.fps;
+    const double length = animation->get_length();
+    const int64_t last_frame = (int64_t)Math::ceil(length * fps - CMP_EPSILON);
+
+    for (int64_t frame = 0; frame <= last_frame; ++frame) {
+        const double time = MIN(frame / fps, length);
+        const double time_code = (double)frame;
+
+        if (p_node.position.track >= 0) {
+            const Vector3 position = p_node.position.value_track
+                    ? (Vector3)animation->value_track_interpolate(p_node.position.track, time)
+                    : animation->position_track_interpolate(p_node.position.track, time);
+            r_samples->translate.emplace_hint(r_samples->translate.end(), time_code, VtValue(GfVec3d(position.x, position.y, position.z)));
+        }
+
+        if (p_node.rotation.track >= 0) {
+            Quaternion rotation;
+            if (!p_node.rotation.value_track) {
+                rotation = animation->rotation_track_interpolate(p_node.rotation.track, time);
+            } else {
+                const Variant value = animation->value_track_interpolate(p_node.rotation.track, time);
+                rotation = p_node.rotation.euler ? Basis::from_euler((Vector3)value, p_node.rotation_order).get_rotation_quaternion() : (Quaternion)value;
+            }
+            r_samples->orient.emplace_hint(r_samples->orient.end(), time_code, VtValue(GfQuatf(rotation.w, rotation.x, rotation.y, rotation.z)));
+        }
+
+        if (p_node.scale.track >= 0) {
+            const Vector3 scale = p_node.scale.value_track
+                    ? (Vector3)animation->value_track_interpolate(p_node.scale.track, time)
+                    : animation->scale_track_interpolate(p_node.scale.track, time);
+            r_samples->scale.emplace_hint(r_samples->scale.end(), time_code, VtValue(GfVec3f(scale.x, scale.y, scale.z)));
+        }
+    }
+}
+
+int64_t UsdAnimationExportHelper::write_time_samples(UsdLayerWriter &p_writer) {
+    std::vector<const AnimatedNode *> nodes;
+    nodes.reserve(_nodes.size());
+    int64_t last_time_code = -1;
+    for (const AnimatedNode &animated : _nodes) {
+        if (!animated.prim_path.IsEmpty() && animated.animation.is_valid()) {
+            nodes.push_back(&animated);
+            last_time_code = std::max(last_time_code, (int64_t)Math::ceil(animated.animation->get_length() * _options.fps - CMP_EPSILON));
+        }
+    }
+    if (nodes.empty()) {
+        return -1;
+    }
+
+    const int thread_count = UsdParallel::resolve_thread_count(_options.thread_count);
+
+    // Samples are built off-thread a batch of nodes at a time; each op's
+    // whole map then goes to the layer as one field write
+    SdfChangeBlock change_block;
+    std::vector<NodeSamples> batch;
+    for (size_t batch_begin = 0; batch_begin < nodes.size(); batch_begin += NODE_BATCH_SIZE) {
+        const size_t batch_size = std::min(NODE_BATCH_SIZE, nodes.size() - batch_begin);
+        batch.clear();
+        batch.resize(batch_size);
+        UsdParallel::for_range(batch_size, thread_count, [&](int64_t p_begin, int64_t p_end) {
+            for (int64_t i = p_begin; i < p_end; ++i) {
+                _sample_node(*nodes[batch_begin + i], &batch[i]);
+            }
+        });
+
+        for (size_t i = 0; i < batch_size; ++i) {
+            const AnimatedNode &animated = *nodes[batch_begin + i];
+            auto write_op = [&](const TfToken &p_op_name, SdfTimeSampleMap &r_samples) {
+                const int64_t count = (int64_t)r_samples.size();
+                if (count > 0 && p_writer.set_time_samples(animated.prim_path, p_op_name, r_samples)) {
+                    _sample_count += count;
+                }
+            };
+            write_op(_TranslateOpName(), batch[i].translate);
+            write_op(_OrientOpName(), batch[i].orient);
+            write_op(_ScaleOpName(), batch[i].scale);
+        }
+        _written_node_count += (int64_t)batch_size;
+    }
+
+    return last_time_code;
+}
+
+} // namespace godot
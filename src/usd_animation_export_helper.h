@@ -0,0 +1,101 @@
+#ifndef USD_ANIMATION_EXPORT_HELPER_H
+#define USD_ANIMATION_EXPORT_HELPER_H
+
+#include <godot_cpp/classes/animation.hpp>
+#include <godot_cpp/classes/animation_player.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+// USD headers
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/base/tf/token.h>
+
+#include <unordered_map>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+struct UsdAnimationExportOptions {
+    // Samples per second; also the stage's timeCodesPerSecond
+    double fps = 30.0;
+
+    // Worker threads for sampling; zero means one per core
+    int thread_count = 0;
+};
+
+// Exports AnimationPlayer tracks as xformOp time samples.
+//
+// add_player() runs before the scene is converted and records which
+// Node3Ds the player's animation moves. The exporter gives those nodes a
+// translate/orient/scale op stack through define_ops() instead of a single
+// matrix, and write_time_samples() then samples every track at the export
+// frame rate and writes one time sample map per op straight into the
+// layer.
+//
+// Position, rotation and scale tracks are supported, as are value tracks
+// on position, rotation, quaternion and scale. Skeleton bone tracks are
+// not exported.
+class UsdLayerWriter;
+
+class UsdAnimationExportHelper {
+public:
+    UsdAnimationExportHelper();
+    ~UsdAnimationExportHelper();
+
+    void set_options(const UsdAnimationExportOptions &p_options) { _options = p_options; }
+
+    // Record the nodes moved by the animation p_player would play: its
+    // assigned animation, else its autoplay animation, else its first
+    void add_player(AnimationPlayer *p_player);
+    bool has_animated_nodes() const { return !_nodes.empty(); }
+    bool is_animated(const Node *p_node) const;
+
+    // Author translate, orient and scale ops holding p_node's current
+    // transform on the prim at p_prim_path, and remember it for sampling
+    void define_ops(const Node3D *p_node, UsdLayerWriter &p_writer, const SdfPath &p_prim_path);
+
+    // Sample and write every animated node whose ops were defined. Returns
+    // the last time code written, or -1 if nothing was written.
+    int64_t write_time_samples(UsdLayerWriter &p_writer);
+
+    int64_t get_animated_node_count() const { return _written_node_count; }
+    int64_t get_sample_count() const { return _sample_count; }
+
+private:
+    // A track driving one transform component
+    struct ComponentTrack {
+        int32_t track = -1;
+        bool value_track = false;
+        bool euler = false; // value track on "rotation"
+    };
+
+    struct AnimatedNode {
+        uint64_t node_id = 0;
+        Ref<Animation> animation;
+        Transform3D rest;
+        EulerOrder rotation_order = EULER_ORDER_YXZ;
+
+        ComponentTrack position;
+        ComponentTrack rotation;
+        ComponentTrack scale;
+
+        SdfPath prim_path;
+    };
+
+    struct NodeSamples;
+    void _sample_node(const AnimatedNode &p_node, NodeSamples *r_samples) const;
+
+    UsdAnimationExportOptions _options;
+    std::vector<AnimatedNode> _nodes;
+    std::unordered_map<uint64_t, size_t> _node_indices;
+
+    int64_t _written_node_count = 0;
+    int64_t _sample_count = 0;
+};
+
+} // namespace godot
+
+#endif // USD_ANIMATION_EXPORT_HELPER_H
@@ -0,0 +1,329 @@
+#include "usd_animation_import_helper.h"
+#include "usd_parallel.h"
+#include "usd_transform_batch.h"
+#include <godot_cpp/core/math.hpp>
+
+// USD headers
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdGeom/xformable.h>
+#include <pxr/usd/usdGeom/xformOp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace godot {
+
+// Rotation keys are slerped along the shortest arc, so two keys 180
+// degrees or more apart turn the wrong way, or not at all. Neither the
+// baked samples nor decimation leave a gap larger than this.
+static const double MAX_ROTATION_STEP_DEGREES = 90.0;
+
+// Indices of the keys to keep. A key is dropped when interpolating the
+// last kept key and the next key reproduces it, and every key skipped so
+// far, within p_tolerance, and the samples in between travel less than
+// p_max_span. Held (step) curves only drop repeats.
+template <typename T, typename Interpolate, typename Distance>
+static std::vector<size_t> _DecimateKeys(const std::vector<double> &p_times, const std::vector<T> &p_values, double p_tolerance,
+        bool p_held, Interpolate p_interpolate, Distance p_distance, double p_max_span = std::numeric_limits<double>::infinity()) {
+    std::vector<size_t> kept;
+    const size_t count = p_values.size();
+    if (count == 0) {
+        return kept;
+    }
+    kept.push_back(0);
+    if (count == 1) {
+        return kept;
+    }
+
+    // Distance travelled along the samples up to each key. Rotations only
+    // compare by their shortest arc, so the endpoints of a full turn look
+    // identical; the path between them does not.
+    std::vector<double> travelled(count, 0.0);
+    for (size_t i = 1; i < count; ++i) {
+        travelled[i] = travelled[i - 1] + p_distance(p_values[i - 1], p_values[i]);
+    }
+
+    size_t anchor = 0;
+    for (size_t i = 1; i + 1 < count; ++i) {
+        bool redundant = true;
+        if (p_held) {
+            redundant = p_distance(p_values[anchor], p_values[i]) <= p_tolerance;
+        } else {
+            const size_t next = i + 1;
+            redundant = travelled[next] - travelled[anchor] < p_max_span;
+            const double span = p_times[next] - p_times[anchor];
+            for (size_t j = anchor + 1; j <= i && redundant; ++j) {
+                const double weight = span > 0.0 ? (p_times[j] - p_times[anchor]) / span : 0.0;
+                redundant = p_distance(p_interpolate(p_values[anchor], p_values[next], weight), p_values[j]) <= p_tolerance;
+            }
+        }
+        if (!redundant) {
+            kept.push_back(i);
+            anchor = i;
+        }
+    }
+
+    // A constant curve needs a single key
+    if (kept.size() == 1 && p_distance(p_values[0], p_values[count - 1]) <= p_tolerance) {
+        return kept;
+    }
+    kept.push_back(count - 1);
+    return kept;
+}
+
+static std::vector<size_t> _AllKeys(size_t p_count) {
+    std::vector<size_t> kept(p_count);
+    for (size_t i = 0; i < p_count; ++i) {
+        kept[i] = i;
+    }
+    return kept;
+}
+
+// Rotate ops whose angle is time-sampled, i.e. the ones that can turn
+// the prim between two keys
+static std::vector<UsdGeomXformOp> _AnimatedRotateOps(const std::vector<UsdGeomXformOp> &p_ops) {
+    std::vector<UsdGeomXformOp> rotate_ops;
+    for (const UsdGeomXformOp &op : p_ops) {
+        const UsdGeomXformOp::Type type = op.GetOpType();
+        if (type >= UsdGeomXformOp::TypeRotateX && type <= UsdGeomXformOp::TypeRotateZYX && op.GetNumTimeSamples() > 1) {
+            rotate_ops.push_back(op);
+        }
+    }
+    return rotate_ops;
+}
+
+// Degrees p_rotate_ops turn between two of the ops' sample times, summed
+// over every op and axis. Each op is linear in between, so this is exact
+// per op and bounds the turn of the composed rotation.
+static double _RotateOpsTurn(const std::vector<UsdGeomXformOp> &p_rotate_ops, double p_from, double p_to) {
+    double turn = 0.0;
+    for (const UsdGeomXformOp &op : p_rotate_ops) {
+        VtValue from;
+        VtValue to;
+        if (!op.Get(&from, UsdTimeCode(p_from)) || !op.Get(&to, UsdTimeCode(p_to))) {
+            continue;
+        }
+        const UsdGeomXformOp::Type type = op.GetOpType();
+        if (type == UsdGeomXformOp::TypeRotateX || type == UsdGeomXformOp::TypeRotateY || type == UsdGeomXformOp::TypeRotateZ) {
+            const VtValue a = VtValue::Cast<double>(from);
+            const VtValue b = VtValue::Cast<double>(to);
+            if (!a.IsEmpty() && !b.IsEmpty()) {
+                turn += std::abs(b.UncheckedGet<double>() - a.UncheckedGet<double>());
+            }
+        } else {
+            const VtValue a = VtValue::Cast<GfVec3d>(from);
+            const VtValue b = VtValue::Cast<GfVec3d>(to);
+            if (!a.IsEmpty() && !b.IsEmpty()) {
+                const GfVec3d delta = b.UncheckedGet<GfVec3d>() - a.UncheckedGet<GfVec3d>();
+                turn += std::abs(delta[0]) + std::abs(delta[1]) + std::abs(delta[2]);
+            }
+        }
+    }
+    return turn;
+}
+
+UsdAnimationImportHelper::UsdAnimationImportHelper() {
+}
+
+UsdAnimationImportHelper::~UsdAnimationImportHelper() {
+}
+
+bool UsdAnimationImportHelper::add_prim(const UsdPrim &p_prim, const NodePath &p_node_path) {
+    const UsdGeomXformable xformable(p_prim);
+    if (!xformable) {
+        return false;
+    }
+
+    AnimatedPrim animated;
+    animated.prim = p_prim;
+    animated.node_path = p_node_path;
+    animated.transform = xformable.TransformMightBeTimeVarying();
+    animated.visibility = xformable.GetVisibilityAttr().ValueMightBeTimeVarying();
+    if (!animated.transform && !animated.visibility) {
+        return false;
+    }
+
+    _prims.push_back(animated);
+    return true;
+}
+
+void UsdAnimationImportHelper::_sample_prim(const AnimatedPrim &p_animated, bool p_held, PrimSamples *r_samples) const {
+    const UsdGeomXformable xformable(p_animated.prim);
+
+    if (p_animated.transform) {
+        // Union of the authored sample times of every op in the stack; the
+        // op list is fetched once and reused for each evaluation
+        bool resets_xform_stack = false;
+        const std::vector<UsdGeomXformOp> ops = xformable.GetOrderedXformOps(&resets_xform_stack);
+        std::vector<double> &times = r_samples->transform_times;
+        std::vector<double> op_times;
+        for (const UsdGeomXformOp &op : ops) {
+            op_times.clear();
+            op.GetTimeSamples(&op_times);
+            times.insert(times.end(), op_times.begin(), op_times.end());
+        }
+        std::sort(times.begin(), times.end());
+        times.erase(std::unique(times.begin(), times.end()), times.end());
+
+        // Split every gap the rotate ops turn too far in; a 0 to 360 degree
+        // spin between two samples would otherwise bake as no rotation
+        const std::vector<UsdGeomXformOp> rotate_ops = p_held ? std::vector<UsdGeomXformOp>() : _AnimatedRotateOps(ops);
+        if (!rotate_ops.empty() && times.size() > 1) {
+            std::vector<double> split_times;
+            split_times.reserve(times.size());
+            for (size_t i = 0; i + 1 < times.size(); ++i) {
+                split_times.push_back(times[i]);
+                const double turn = _RotateOpsTurn(rotate_ops, times[i], times[i + 1]);
+                const int steps = (int)std::ceil(turn / MAX_ROTATION_STEP_DEGREES);
+                for (int step = 1; step < steps; ++step) {
+                    split_times.push_back(times[i] + (times[i + 1] - times[i]) * step / steps);
+                }
+            }
+            split_times.push_back(times.back());
+            times.swap(split_times);
+        }
+
+        r_samples->positions.reserve(times.size());
+        r_samples->rotations.reserve(times.size());
+        r_samples->scales.reserve(times.size());
+        for (double time : times) {
+            GfMatrix4d matrix(1.0);
+            xformable.GetLocalTransformation(&matrix, ops, UsdTimeCode(time));
+            const Transform3D transform = UsdTransformBatch::to_transform(matrix);
+            r_samples->positions.push_back(transform.origin);
+            r_samples->rotations.push_back(transform.basis.get_rotation_quaternion());
+            r_samples->scales.push_back(transform.basis.get_scale());
+        }
+    }
+
+    if (p_animated.visibility) {
+        const UsdAttribute attribute = xformable.GetVisibilityAttr();
+        attribute.GetTimeSamples(&r_samples->visibility_times);
+        r_samples->visible.reserve(r_samples->visibility_times.size());
+        for (double time : r_samples->visibility_times) {
+            TfToken visibility;
+            attribute.Get(&visibility, UsdTimeCode(time));
+            r_samples->visible.push_back(visibility != UsdGeomTokens->invisible);
+        }
+    }
+}
+
+Ref<Animation> UsdAnimationImportHelper::bake(const UsdStageRefPtr &p_stage) {
+    if (_prims.empty() || !p_stage) {
+        return Ref<Animation>();
+    }
+
+    const bool held = p_stage->GetInterpolationType() == UsdInterpolationTypeHeld;
+    std::vector<PrimSamples> samples(_prims.size());
+    UsdParallel::for_range(_prims.size(), UsdParallel::resolve_thread_count(_options.thread_count), [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t i = p_begin; i < p_end; ++i) {
+            _sample_prim(_prims[i], held, &samples[i]);
+        }
+    });
+
+    // Animation time zero is the stage's start time code when authored,
+    // otherwise the earliest sample
+    double begin = std::numeric_limits<double>::max();
+    double end = std::numeric_limits<double>::lowest();
+    for (const PrimSamples &prim_samples : samples) {
+        for (const std::vector<double> *times : { &prim_samples.transform_times, &prim_samples.visibility_times }) {
+            if (!times->empty()) {
+                begin = std::min(begin, times->front());
+                end = std::max(end, times->back());
+            }
+        }
+    }
+    if (p_stage->HasAuthoredTimeCodeRange()) {
+        begin = p_stage->GetStartTimeCode();
+        end = p_stage->GetEndTimeCode();
+    }
+    if (begin > end) {
+        return Ref<Animation>();
+    }
+
+    const double seconds_per_code = 1.0 / p_stage->GetTimeCodesPerSecond();
+    const double tolerance = _options.decimation_tolerance;
+    const bool decimate = tolerance > 0.0;
+
+    auto lerp_vector = [](const Vector3 &p_a, const Vector3 &p_b, double p_weight) { return p_a.lerp(p_b, p_weight); };
+    auto vector_distance = [](const Vector3 &p_a, const Vector3 &p_b) { return (double)p_a.distance_to(p_b); };
+    auto slerp = [](const Quaternion &p_a, const Quaternion &p_b, double p_weight) { return p_a.slerp(p_b, p_weight); };
+    auto angle = [](const Quaternion &p_a, const Quaternion &p_b) { return (double)p_a.angle_to(p_b); };
+
+    Ref<Animation> animation;
+    animation.instantiate();
+    animation->set_length(MAX((end - begin) * seconds_per_code, 0.001));
+
+    const Animation::InterpolationType interpolation = held ? Animation::INTERPOLATION_NEAREST : Animation::INTERPOLATION_LINEAR;
+
+    for (size_t i = 0; i < _prims.size(); ++i) {
+        const AnimatedPrim &animated = _prims[i];
+        const PrimSamples &prim_samples = samples[i];
+        const std::vector<double> &times = prim_samples.transform_times;
+
+        if (!times.empty()) {
+            const size_t count = times.size();
+
+            const std::vector<size_t> position_keys = decimate
+                    ? _DecimateKeys(times, prim_samples.positions, tolerance, held, lerp_vector, vector_distance)
+                    : _AllKeys(count);
+            int32_t track = animation->add_track(Animation::TYPE_POSITION_3D);
+            animation->track_set_path(track, animated.node_path);
+            animation->track_set_interpolation_type(track, interpolation);
+            for (size_t key : position_keys) {
+                animation->position_track_insert_key(track, (times[key] - begin) * seconds_per_code, prim_samples.positions[key]);
+            }
+
+            const std::vector<size_t> rotation_keys = decimate
+                    ? _DecimateKeys(times, prim_samples.rotations, tolerance, held, slerp, angle, Math::deg_to_rad(MAX_ROTATION_STEP_DEGREES))
+                    : _AllKeys(count);
+            track = animation->add_track(Animation::TYPE_ROTATION_3D);
+            animation->track_set_path(track, animated.node_path);
+            animation->track_set_interpolation_type(track, interpolation);
+            for (size_t key : rotation_keys) {
+                animation->rotation_track_insert_key(track, (times[key] - begin) * seconds_per_code, prim_samples.rotations[key]);
+            }
+
+            const std::vector<size_t> scale_keys = decimate
+                    ? _DecimateKeys(times, prim_samples.scales, tolerance, held, lerp_vector, vector_distance)
+                    : _AllKeys(count);
+            track = animation->add_track(Animation::TYPE_SCALE_3D);
+            animation->track_set_path(track, animated.node_path);
+            animation->track_set_interpolation_type(track, interpolation);
+            for (size_t key : scale_keys) {
+                animation->scale_track_insert_key(track, (times[key] - begin) * seconds_per_code, prim_samples.scales[key]);
+            }
+
+            _track_count += 3;
+            const int64_t written = position_keys.size() + rotation_keys.size() + scale_keys.size();
+            _key_count += written;
+            _keys_removed += (int64_t)count * 3 - written;
+        }
+
+        if (!prim_samples.visibility_times.empty()) {
+            // Visibility only ever changes in steps, so repeats are always
+            // redundant
+            int32_t track = animation->add_track(Animation::TYPE_VALUE);
+            animation->track_set_path(track, NodePath(String(animated.node_path) + ":visible"));
+            animation->value_track_set_update_mode(track, Animation::UPDATE_DISCRETE);
+            int64_t written = 0;
+            for (size_t key = 0; key < prim_samples.visible.size(); ++key) {
+                if (key > 0 && prim_samples.visible[key] == prim_samples.visible[key - 1]) {
+                    continue;
+                }
+                animation->track_insert_key(track, (prim_samples.visibility_times[key] - begin) * seconds_per_code, prim_samples.visible[key]);
+                written++;
+            }
+
+            _track_count++;
+            _key_count += written;
+            _keys_removed += (int64_t)prim_samples.visible.size() - written;
+        }
+    }
+
+    _prims.clear();
+    return animation;
+}
+
+} // namespace godot
@@ -0,0 +1,91 @@
+#ifndef USD_ANIMATION_IMPORT_HELPER_H
+#define USD_ANIMATION_IMPORT_HELPER_H
+
+#include <godot_cpp/classes/animation.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/quaternion.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+
+// USD headers
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/stage.h>
+
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+struct UsdAnimationImportOptions {
+    // Keys that linear interpolation of their neighbours reproduces within
+    // this distance (radians for rotations) are dropped. Zero keeps every
+    // authored sample.
+    double decimation_tolerance = 0.0;
+
+    // Worker threads for sampling; zero means one per core
+    int thread_count = 0;
+};
+
+// Bakes time-sampled xformOps and visibility into one Animation.
+//
+// The hierarchy walk registers each prim with its node path; bake() then
+// reads only the authored sample times of each prim (GetTimeSamples on its
+// xformOps or visibility) instead of evaluating every frame, and builds
+// position/rotation/scale and visibility tracks from them. Sampling only
+// reads USD, so it runs on worker threads; the Animation itself is built
+// on the calling thread.
+class UsdAnimationImportHelper {
+public:
+    UsdAnimationImportHelper();
+    ~UsdAnimationImportHelper();
+
+    void set_options(const UsdAnimationImportOptions &p_options) { _options = p_options; }
+
+    // Register p_prim if its transform or visibility might vary over time.
+    // p_node_path is relative to the node the AnimationPlayer animates.
+    bool add_prim(const UsdPrim &p_prim, const NodePath &p_node_path);
+    bool has_prims() const { return !_prims.empty(); }
+
+    // Sample every registered prim and build the tracks. Returns an
+    // invalid Ref if nothing was registered.
+    Ref<Animation> bake(const UsdStageRefPtr &p_stage);
+
+    int64_t get_track_count() const { return _track_count; }
+    int64_t get_key_count() const { return _key_count; }
+    int64_t get_keys_removed() const { return _keys_removed; }
+
+private:
+    struct AnimatedPrim {
+        UsdPrim prim;
+        NodePath node_path;
+        bool transform = false;
+        bool visibility = false;
+    };
+
+    // Everything read from one prim, in stage time codes
+    struct PrimSamples {
+        std::vector<double> transform_times;
+        std::vector<Vector3> positions;
+        std::vector<Quaternion> rotations;
+        std::vector<Vector3> scales;
+
+        std::vector<double> visibility_times;
+        std::vector<bool> visible;
+    };
+
+    // Authored transform and visibility samples of one prim. Unless
+    // p_held, gaps that rotate ops turn 180 degrees or more in get extra
+    // samples so slerping the keys follows the authored rotation.
+    void _sample_prim(const AnimatedPrim &p_animated, bool p_held, PrimSamples *r_samples) const;
+
+    UsdAnimationImportOptions _options;
+    std::vector<AnimatedPrim> _prims;
+
+    int64_t _track_count = 0;
+    int64_t _key_count = 0;
+    int64_t _keys_removed = 0;
+};
+
+} // namespace godot
+
+#endif // USD_ANIMATION_IMPORT_HELPER_H
@@ -0,0 +1,145 @@
+#include "usd_array_utils.h"
+
+#include <cstring>
+#include <type_traits>
+
+namespace godot {
+
+// Both sides are tightly packed float/int tuples of the same width, so the
+// bytes can be copied as-is. False for Vector3/Vector2 in double builds.
+template <typename A, typename B>
+static constexpr bool _SameLayout() {
+    return sizeof(A) == sizeof(B) && std::is_trivially_copyable<A>::value && std::is_trivially_copyable<B>::value;
+}
+
+void UsdArrayUtils::to_vt_array(const PackedVector3Array &p_src, pxr::VtArray<pxr::GfVec3f> *r_dst) {
+    r_dst->resize(p_src.size());
+    to_vt_array(p_src, r_dst, 0);
+}
+
+void UsdArrayUtils::to_vt_array(const PackedVector2Array &p_src, pxr::VtArray<pxr::GfVec2f> *r_dst) {
+    r_dst->resize(p_src.size());
+    to_vt_array(p_src, r_dst, 0);
+}
+
+void UsdArrayUtils::to_vt_array(const PackedVector3Array &p_src, pxr::VtArray<pxr::GfVec3f> *r_dst, size_t p_offset) {
+    const int64_t count = p_src.size();
+    if (count == 0) {
+        return;
+    }
+    const Vector3 *src = p_src.ptr();
+    pxr::GfVec3f *dst = r_dst->data() + p_offset;
+    if constexpr (_SameLayout<Vector3, pxr::GfVec3f>()) {
+        memcpy(dst, src, count * sizeof(pxr::GfVec3f));
+    } else {
+        for (int64_t i = 0; i < count; ++i) {
+            dst[i] = pxr::GfVec3f(src[i].x, src[i].y, src[i].z);
+        }
+    }
+}
+
+void UsdArrayUtils::to_vt_array(const PackedVector2Array &p_src, pxr::VtArray<pxr::GfVec2f> *r_dst, size_t p_offset) {
+    const int64_t count = p_src.size();
+    if (count == 0) {
+        return;
+    }
+    const Vector2 *src = p_src.ptr();
+    pxr::GfVec2f *dst = r_dst->data() + p_offset;
+    if constexpr (_SameLayout<Vector2, pxr::GfVec2f>()) {
+        memcpy(dst, src, count * sizeof(pxr::GfVec2f));
+    } else {
+        for (int64_t i = 0; i < count; ++i) {
+            dst[i] = pxr::GfVec2f(src[i].x, src[i].y);
+        }
+    }
+}
+
+void UsdArrayUtils::to_vt_array(const PackedColorArray &p_src, pxr::VtArray<pxr::GfVec4f> *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    static_assert(_SameLayout<Color, pxr::GfVec4f>(), "Color is always four floats");
+    memcpy(r_dst->data(), p_src.ptr(), count * sizeof(pxr::GfVec4f));
+}
+
+void UsdArrayUtils::to_vt_array(const PackedInt32Array &p_src, pxr::VtArray<int> *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    static_assert(_SameLayout<int32_t, int>(), "USD int arrays are 32-bit");
+    memcpy(r_dst->data(), p_src.ptr(), count * sizeof(int));
+}
+
+void UsdArrayUtils::to_packed_array(const pxr::VtArray<pxr::GfVec3f> &p_src, PackedVector3Array *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    const pxr::GfVec3f *src = p_src.cdata();
+    Vector3 *dst = r_dst->ptrw();
+    if constexpr (_SameLayout<Vector3, pxr::GfVec3f>()) {
+        memcpy(dst, src, count * sizeof(pxr::GfVec3f));
+    } else {
+        for (int64_t i = 0; i < count; ++i) {
+            dst[i] = Vector3(src[i][0], src[i][1], src[i][2]);
+        }
+    }
+}
+
+void UsdArrayUtils::to_packed_array(const pxr::VtArray<pxr::GfVec2f> &p_src, PackedVector2Array *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    const pxr::GfVec2f *src = p_src.cdata();
+    Vector2 *dst = r_dst->ptrw();
+    if constexpr (_SameLayout<Vector2, pxr::GfVec2f>()) {
+        memcpy(dst, src, count * sizeof(pxr::GfVec2f));
+    } else {
+        for (int64_t i = 0; i < count; ++i) {
+            dst[i] = Vector2(src[i][0], src[i][1]);
+        }
+    }
+}
+
+void UsdArrayUtils::to_packed_array(const pxr::VtArray<pxr::GfVec4f> &p_src, PackedColorArray *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    memcpy(r_dst->ptrw(), p_src.cdata(), count * sizeof(pxr::GfVec4f));
+}
+
+void UsdArrayUtils::to_packed_array(const pxr::VtArray<int> &p_src, PackedInt32Array *r_dst) {
+    const int64_t count = p_src.size();
+    r_dst->resize(count);
+    if (count == 0) {
+        return;
+    }
+    memcpy(r_dst->ptrw(), p_src.cdata(), count * sizeof(int));
+}
+
+void UsdArrayUtils::flip_v(PackedVector2Array *r_uvs) {
+    const int64_t count = r_uvs->size();
+    Vector2 *uvs = r_uvs->ptrw();
+    for (int64_t i = 0; i < count; ++i) {
+        uvs[i].y = 1.0f - uvs[i].y;
+    }
+}
+
+void UsdArrayUtils::flip_v(pxr::VtArray<pxr::GfVec2f> *r_uvs) {
+    const size_t count = r_uvs->size();
+    pxr::GfVec2f *uvs = r_uvs->data();
+    for (size_t i = 0; i < count; ++i) {
+        uvs[i][1] = 1.0f - uvs[i][1];
+    }
+}
+
+} // namespace godot
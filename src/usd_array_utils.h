@@ -0,0 +1,49 @@
+#ifndef USD_ARRAY_UTILS_H
+#define USD_ARRAY_UTILS_H
+
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_color_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+
+// USD headers
+#include <pxr/base/vt/array.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/gf/vec4f.h>
+
+namespace godot {
+
+// Bulk conversion between Godot packed arrays and USD VtArrays.
+//
+// Every function sizes its output once and writes through ptrw()/data(),
+// never append()/push_back() or per-element operator[]. When the element
+// layouts match (GfVec3f <-> Vector3 in single-precision builds, GfVec4f <->
+// Color, int <-> int32_t) the copy is a single memcpy.
+class UsdArrayUtils {
+public:
+    // Godot -> USD
+    static void to_vt_array(const PackedVector3Array &p_src, pxr::VtArray<pxr::GfVec3f> *r_dst);
+    static void to_vt_array(const PackedVector2Array &p_src, pxr::VtArray<pxr::GfVec2f> *r_dst);
+    static void to_vt_array(const PackedColorArray &p_src, pxr::VtArray<pxr::GfVec4f> *r_dst);
+    static void to_vt_array(const PackedInt32Array &p_src, pxr::VtArray<int> *r_dst);
+
+    // Godot -> USD into [p_offset, p_offset + p_src.size()) of an already
+    // sized array, for merging several sources into one VtArray
+    static void to_vt_array(const PackedVector3Array &p_src, pxr::VtArray<pxr::GfVec3f> *r_dst, size_t p_offset);
+    static void to_vt_array(const PackedVector2Array &p_src, pxr::VtArray<pxr::GfVec2f> *r_dst, size_t p_offset);
+
+    // USD -> Godot
+    static void to_packed_array(const pxr::VtArray<pxr::GfVec3f> &p_src, PackedVector3Array *r_dst);
+    static void to_packed_array(const pxr::VtArray<pxr::GfVec2f> &p_src, PackedVector2Array *r_dst);
+    static void to_packed_array(const pxr::VtArray<pxr::GfVec4f> &p_src, PackedColorArray *r_dst);
+    static void to_packed_array(const pxr::VtArray<int> &p_src, PackedInt32Array *r_dst);
+
+    // Godot and USD disagree on the V direction of texture coordinates
+    static void flip_v(PackedVector2Array *r_uvs);
+    static void flip_v(pxr::VtArray<pxr::GfVec2f> *r_uvs);
+};
+
+} // namespace godot
+
+#endif // USD_ARRAY_UTILS_H
@@ -0,0 +1,400 @@
+#include "usd_bounds_hierarchy.h"
+
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/gprim.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/base/tf/stringUtils.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace usd_godot {
+
+// Leaf nodes hold up to this many leaves
+static const int _MAX_NODE_LEAVES = 4;
+
+// Ray entry distance into p_box, clipped to [0, p_max_distance]
+static bool _IntersectRay(const GfRange3d &p_box, const GfVec3d &p_origin, const GfVec3d &p_direction, double p_max_distance, double *r_distance) {
+    double enter = 0.0;
+    double exit = p_max_distance;
+    for (int axis = 0; axis < 3; ++axis) {
+        const double min = p_box.GetMin()[axis];
+        const double max = p_box.GetMax()[axis];
+        if (p_direction[axis] == 0.0) {
+            if (p_origin[axis] < min || p_origin[axis] > max) {
+                return false;
+            }
+            continue;
+        }
+        double t0 = (min - p_origin[axis]) / p_direction[axis];
+        double t1 = (max - p_origin[axis]) / p_direction[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+        if (enter > exit) {
+            return false;
+        }
+    }
+    *r_distance = enter;
+    return true;
+}
+
+static bool _IsOutsidePlane(const GfRange3d &p_box, const UsdBoundsHierarchy::Plane &p_plane) {
+    // The corner furthest along -normal is the last one to leave
+    GfVec3d corner;
+    for (int axis = 0; axis < 3; ++axis) {
+        corner[axis] = p_plane.normal[axis] >= 0.0 ? p_box.GetMin()[axis] : p_box.GetMax()[axis];
+    }
+    return GfDot(p_plane.normal, corner) > p_plane.distance;
+}
+
+// Properties that never move or resize anything
+static bool _IsBoundsNeutral(const SdfPath &p_path) {
+    if (!p_path.IsPropertyPath()) {
+        return false;
+    }
+    const std::string &name = p_path.GetName();
+    return TfStringStartsWith(name, "primvars:") || TfStringStartsWith(name, "material:") ||
+            TfStringStartsWith(name, "inputs:") || TfStringStartsWith(name, "outputs:");
+}
+
+UsdBoundsHierarchy::UsdBoundsHierarchy(const UsdStageRefPtr &p_stage) :
+        _stage(p_stage),
+        _time(UsdTimeCode::Default()),
+        _cache(UsdTimeCode::Default(), { UsdGeomTokens->default_, UsdGeomTokens->render }, true) {
+    _listener.attach(_stage);
+}
+
+UsdBoundsHierarchy::~UsdBoundsHierarchy() {
+    _listener.detach();
+}
+
+void UsdBoundsHierarchy::set_time(UsdTimeCode p_time) {
+    if (p_time == _time) {
+        return;
+    }
+    _time = p_time;
+    _cache.SetTime(p_time);
+    if (!_built) {
+        return;
+    }
+
+    // Everything may be animated; refresh every leaf
+    bool structure_changed = false;
+    for (auto &entry : _leaves) {
+        _refresh_leaf(entry.first, entry.second, &structure_changed);
+    }
+    _build_tree();
+}
+
+void UsdBoundsHierarchy::update() {
+    if (!_built) {
+        _rebuild_all();
+        return;
+    }
+
+    StageChanges changes;
+    if (!_listener.take_changes(&changes)) {
+        return;
+    }
+    _cache.Clear();
+
+    // Prim resyncs re-read that subtree from the stage; property changes
+    // only refresh the bounds of the leaves below the prim
+    SdfPathSet reread;
+    SdfPathSet refresh;
+    for (const SdfPath &path : changes.resynced) {
+        if (path.IsPropertyPath()) {
+            if (!_IsBoundsNeutral(path)) {
+                refresh.insert(path.GetPrimPath());
+            }
+        } else if (path.IsAbsoluteRootPath() || UsdPrim::IsPathInPrototype(path)) {
+            // Layer reloads and prototype edits can move anything
+            _rebuild_all();
+            return;
+        } else {
+            reread.insert(path);
+        }
+    }
+    for (const SdfPath &path : changes.changed_info) {
+        if (_IsBoundsNeutral(path)) {
+            continue;
+        }
+        // Instances follow their prototype, so that refreshes everything
+        refresh.insert(UsdPrim::IsPathInPrototype(path) ? SdfPath::AbsoluteRootPath() : path.GetPrimPath());
+    }
+
+    // Sets are ordered, so a path's ancestors come before it
+    auto subtree = [this](const SdfPath &p_path) {
+        return SdfPathFindPrefixedRange(_leaves.begin(), _leaves.end(), p_path,
+                [](const std::pair<const SdfPath, Leaf> &p_entry) -> const SdfPath & { return p_entry.first; });
+    };
+
+    bool structure_changed = false;
+    SdfPath covered;
+    for (const SdfPath &path : reread) {
+        if (!covered.IsEmpty() && path.HasPrefix(covered)) {
+            continue;
+        }
+        covered = path;
+        auto range = subtree(path);
+        _leaves.erase(range.first, range.second);
+        UsdPrim prim = _stage->GetPrimAtPath(path);
+        if (prim) {
+            _collect_leaves(prim);
+        }
+        structure_changed = true;
+    }
+
+    std::vector<int> dirty_nodes;
+    covered = SdfPath();
+    for (const SdfPath &path : refresh) {
+        if (!covered.IsEmpty() && path.HasPrefix(covered)) {
+            continue;
+        }
+        covered = path;
+        auto range = subtree(path);
+        for (auto it = range.first; it != range.second; ++it) {
+            _refresh_leaf(it->first, it->second, &structure_changed);
+            if (it->second.node >= 0) {
+                dirty_nodes.push_back(it->second.node);
+            }
+            _stats.refit_count++;
+        }
+    }
+
+    if (structure_changed) {
+        _build_tree();
+    } else if (!dirty_nodes.empty()) {
+        _refit(dirty_nodes);
+    }
+}
+
+GfRange3d UsdBoundsHierarchy::get_bounds(const SdfPath &p_path) const {
+    if (p_path.IsAbsoluteRootPath()) {
+        return _nodes.empty() ? GfRange3d() : _nodes[0].bounds;
+    }
+
+    GfRange3d bounds;
+    auto range = SdfPathFindPrefixedRange(_leaves.begin(), _leaves.end(), p_path,
+            [](const std::pair<const SdfPath, Leaf> &p_entry) -> const SdfPath & { return p_entry.first; });
+    for (auto it = range.first; it != range.second; ++it) {
+        bounds.UnionWith(it->second.bounds);
+    }
+    return bounds;
+}
+
+bool UsdBoundsHierarchy::raycast(const GfVec3d &p_origin, const GfVec3d &p_direction, double p_max_distance, RayHit *r_hit) const {
+    const double length = p_direction.GetLength();
+    if (_nodes.empty() || length <= 0.0) {
+        return false;
+    }
+    const GfVec3d direction = p_direction / length;
+
+    double best = p_max_distance;
+    const SdfPath *best_path = nullptr;
+
+    // Depth first, nearer child first, skipping boxes beyond the best hit
+    std::vector<std::pair<int, double>> stack;
+    double distance = 0.0;
+    if (_IntersectRay(_nodes[0].bounds, p_origin, direction, best, &distance)) {
+        stack.emplace_back(0, distance);
+    }
+    while (!stack.empty()) {
+        const std::pair<int, double> entry = stack.back();
+        stack.pop_back();
+        if (entry.second > best) {
+            continue;
+        }
+
+        const Node &node = _nodes[entry.first];
+        if (node.left < 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                if (_IntersectRay(_order[i]->second.bounds, p_origin, direction, best, &distance) &&
+                        (!best_path || distance < best)) {
+                    best = distance;
+                    best_path = &_order[i]->first;
+                }
+            }
+            continue;
+        }
+
+        double left_distance = 0.0;
+        double right_distance = 0.0;
+        const bool left_hit = _IntersectRay(_nodes[node.left].bounds, p_origin, direction, best, &left_distance);
+        const bool right_hit = _IntersectRay(_nodes[node.right].bounds, p_origin, direction, best, &right_distance);
+        if (left_hit && right_hit && left_distance < right_distance) {
+            stack.emplace_back(node.right, right_distance);
+            stack.emplace_back(node.left, left_distance);
+        } else {
+            if (left_hit) {
+                stack.emplace_back(node.left, left_distance);
+            }
+            if (right_hit) {
+                stack.emplace_back(node.right, right_distance);
+            }
+        }
+    }
+
+    if (!best_path) {
+        return false;
+    }
+    r_hit->path = *best_path;
+    r_hit->distance = best;
+    return true;
+}
+
+template <typename Test>
+void UsdBoundsHierarchy::_collect(Test p_test, SdfPathVector *r_paths) const {
+    if (_nodes.empty()) {
+        return;
+    }
+    std::vector<int> stack = { 0 };
+    while (!stack.empty()) {
+        const Node &node = _nodes[stack.back()];
+        stack.pop_back();
+        if (!p_test(node.bounds)) {
+            continue;
+        }
+        if (node.left >= 0) {
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            if (p_test(_order[i]->second.bounds)) {
+                r_paths->push_back(_order[i]->first);
+            }
+        }
+    }
+}
+
+void UsdBoundsHierarchy::query_frustum(const std::vector<Plane> &p_planes, SdfPathVector *r_paths) const {
+    _collect([&p_planes](const GfRange3d &p_box) {
+        for (const Plane &plane : p_planes) {
+            if (_IsOutsidePlane(p_box, plane)) {
+                return false;
+            }
+        }
+        return true;
+    }, r_paths);
+}
+
+void UsdBoundsHierarchy::query_box(const GfRange3d &p_box, SdfPathVector *r_paths) const {
+    _collect([&p_box](const GfRange3d &p_node_box) { return !p_box.IsOutside(p_node_box); }, r_paths);
+}
+
+void UsdBoundsHierarchy::_rebuild_all() {
+    // Notices up to now are covered by reading the whole stage
+    StageChanges discarded;
+    _listener.take_changes(&discarded);
+    _cache.Clear();
+    _leaves.clear();
+    _collect_leaves(_stage->GetPseudoRoot());
+    _build_tree();
+    _built = true;
+}
+
+void UsdBoundsHierarchy::_collect_leaves(const UsdPrim &p_root) {
+    // Unloaded payloads are kept so their extentsHint can stand in for
+    // their contents; instance proxies make each instance its own leaf
+    UsdPrimRange range(p_root, UsdTraverseInstanceProxies(UsdPrimIsActive && UsdPrimIsDefined && !UsdPrimIsAbstract));
+    bool structure_changed = false;
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        const UsdPrim &prim = *it;
+        const bool unloaded_payload = prim.HasAuthoredPayloads() && !prim.IsLoaded();
+        const bool instancer = prim.IsA<UsdGeomPointInstancer>();
+        if (unloaded_payload || instancer || prim.IsA<UsdGeomGprim>()) {
+            Leaf &leaf = _leaves[prim.GetPath()];
+            _refresh_leaf(prim.GetPath(), leaf, &structure_changed);
+        }
+        if (unloaded_payload || instancer) {
+            it.PruneChildren();
+        }
+    }
+}
+
+void UsdBoundsHierarchy::_refresh_leaf(const SdfPath &p_path, Leaf &p_leaf, bool *r_structure_changed) {
+    const UsdPrim prim = _stage->GetPrimAtPath(p_path);
+    const GfRange3d bounds = prim ? _cache.ComputeWorldBound(prim).ComputeAlignedRange() : GfRange3d();
+    if (p_leaf.bounds.IsEmpty() != bounds.IsEmpty()) {
+        *r_structure_changed = true;
+    }
+    p_leaf.bounds = bounds;
+}
+
+void UsdBoundsHierarchy::_build_tree() {
+    _nodes.clear();
+    _order.clear();
+    for (auto it = _leaves.begin(); it != _leaves.end(); ++it) {
+        it->second.node = -1;
+        if (!it->second.bounds.IsEmpty()) {
+            _order.push_back(it);
+        }
+    }
+    if (!_order.empty()) {
+        _nodes.reserve(2 * (_order.size() / _MAX_NODE_LEAVES + 1));
+        _build_node(0, (int)_order.size(), -1);
+    }
+
+    _stats.leaf_count = (int64_t)_order.size();
+    _stats.node_count = (int64_t)_nodes.size();
+    _stats.rebuild_count++;
+}
+
+int UsdBoundsHierarchy::_build_node(int p_first, int p_count, int p_parent) {
+    const int index = (int)_nodes.size();
+    _nodes.push_back(Node());
+
+    GfRange3d bounds;
+    GfRange3d centers;
+    for (int i = p_first; i < p_first + p_count; ++i) {
+        const GfRange3d &leaf_bounds = _order[i]->second.bounds;
+        bounds.UnionWith(leaf_bounds);
+        centers.UnionWith(leaf_bounds.GetMidpoint());
+    }
+    _nodes[index].bounds = bounds;
+    _nodes[index].parent = p_parent;
+
+    // Split at the median center along the widest axis
+    const GfVec3d extent = centers.GetSize();
+    const int axis = extent[0] >= extent[1] && extent[0] >= extent[2] ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+    if (p_count <= _MAX_NODE_LEAVES || extent[axis] <= 0.0) {
+        _nodes[index].first = p_first;
+        _nodes[index].count = p_count;
+        for (int i = p_first; i < p_first + p_count; ++i) {
+            _order[i]->second.node = index;
+        }
+        return index;
+    }
+
+    const int middle = p_first + p_count / 2;
+    std::nth_element(_order.begin() + p_first, _order.begin() + middle, _order.begin() + p_first + p_count,
+            [axis](const std::map<SdfPath, Leaf>::iterator &p_a, const std::map<SdfPath, Leaf>::iterator &p_b) {
+                return p_a->second.bounds.GetMidpoint()[axis] < p_b->second.bounds.GetMidpoint()[axis];
+            });
+    const int left = _build_node(p_first, middle - p_first, index);
+    const int right = _build_node(middle, p_first + p_count - middle, index);
+    _nodes[index].left = left;
+    _nodes[index].right = right;
+    return index;
+}
+
+void UsdBoundsHierarchy::_refit(const std::vector<int> &p_nodes) {
+    for (int index : p_nodes) {
+        Node &node = _nodes[index];
+        node.bounds = GfRange3d();
+        for (int i = node.first; i < node.first + node.count; ++i) {
+            node.bounds.UnionWith(_order[i]->second.bounds);
+        }
+        for (int parent = node.parent; parent >= 0; parent = _nodes[parent].parent) {
+            Node &interior = _nodes[parent];
+            interior.bounds = GfRange3d::GetUnion(_nodes[interior.left].bounds, _nodes[interior.right].bounds);
+        }
+    }
+}
+
+} // namespace usd_godot
@@ -0,0 +1,127 @@
+#ifndef USD_GODOT_BOUNDS_HIERARCHY_H
+#define USD_GODOT_BOUNDS_HIERARCHY_H
+
+#include "usd_change_listener.h"
+
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/timeCode.h>
+#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/base/gf/range3d.h>
+#include <pxr/base/gf/vec3d.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usd_godot {
+
+// Bounding volume hierarchy over the world-space bounds of a stage's
+// leaves: gprims, point instancers (as a whole) and prims whose payload is
+// not loaded (from their extentsHint). Bounds come from UsdGeomBBoxCache,
+// so they are exact for rotated and sheared transforms.
+//
+// Built on first use; afterwards update() applies the UsdNotice changes
+// collected since the previous call. Value changes refresh only the leaves
+// below the changed prim and refit their ancestors; added or removed prims
+// re-read that subtree from the stage and rebuild the tree from the cached
+// leaf bounds. Queries never touch the Godot scene tree.
+//
+// Not thread-safe: update and query from one thread.
+class UsdBoundsHierarchy {
+public:
+    // Points p with GfDot(normal, p) > distance are outside, the way Godot
+    // frustum planes face
+    struct Plane {
+        GfVec3d normal;
+        double distance = 0.0;
+    };
+
+    struct RayHit {
+        SdfPath path;
+        double distance = 0.0; // along the normalized direction, to the leaf's box
+    };
+
+    struct Stats {
+        int64_t leaf_count = 0;
+        int64_t node_count = 0;
+        int64_t rebuild_count = 0; // tree rebuilt from leaf bounds
+        int64_t refit_count = 0; // leaves refreshed in place
+    };
+
+    explicit UsdBoundsHierarchy(const UsdStageRefPtr &p_stage);
+    ~UsdBoundsHierarchy();
+
+    UsdBoundsHierarchy(const UsdBoundsHierarchy &) = delete;
+    UsdBoundsHierarchy &operator=(const UsdBoundsHierarchy &) = delete;
+
+    // Evaluate transforms and extents at p_time. Changing it refreshes
+    // every leaf.
+    void set_time(UsdTimeCode p_time);
+    UsdTimeCode get_time() const { return _time; }
+
+    // Build on first call, then apply pending change notices
+    void update();
+
+    // Union of the leaves at or below p_path. Empty if there are none.
+    GfRange3d get_bounds(const SdfPath &p_path = SdfPath::AbsoluteRootPath()) const;
+
+    // Nearest leaf whose box the ray enters within p_max_distance
+    bool raycast(const GfVec3d &p_origin, const GfVec3d &p_direction, double p_max_distance, RayHit *r_hit) const;
+
+    // Leaves whose boxes are not entirely outside any of the planes
+    void query_frustum(const std::vector<Plane> &p_planes, SdfPathVector *r_paths) const;
+
+    // Leaves whose boxes intersect p_box
+    void query_box(const GfRange3d &p_box, SdfPathVector *r_paths) const;
+
+    const Stats &get_stats() const { return _stats; }
+
+private:
+    struct Leaf {
+        GfRange3d bounds;
+        int node = -1; // tree node holding the leaf; -1 while its bounds are empty
+    };
+
+    struct Node {
+        GfRange3d bounds;
+        int parent = -1;
+        int left = -1; // interior nodes
+        int right = -1;
+        int first = 0; // leaf nodes: range in _order
+        int count = 0;
+    };
+
+    void _rebuild_all();
+    void _collect_leaves(const UsdPrim &p_root);
+    void _refresh_leaf(const SdfPath &p_path, Leaf &p_leaf, bool *r_structure_changed);
+    void _build_tree();
+    int _build_node(int p_first, int p_count, int p_parent);
+    void _refit(const std::vector<int> &p_nodes);
+
+    // Leaves in every node whose box passes p_test
+    template <typename Test>
+    void _collect(Test p_test, SdfPathVector *r_paths) const;
+
+    UsdStageRefPtr _stage;
+    UsdTimeCode _time;
+    UsdGeomBBoxCache _cache;
+    UsdChangeListener _listener;
+    bool _built = false;
+
+    // Ordered so a prim's subtree is one contiguous range
+    std::map<SdfPath, Leaf> _leaves;
+
+    // Tree over the leaves with non-empty bounds; leaf nodes own a range
+    // of _order
+    std::vector<Node> _nodes;
+    std::vector<std::map<SdfPath, Leaf>::iterator> _order;
+
+    Stats _stats;
+};
+
+} // namespace usd_godot
+
+#endif // USD_GODOT_BOUNDS_HIERARCHY_H
@@ -0,0 +1,59 @@
+#include "usd_change_listener.h"
+
+#include <chrono>
+
+namespace usd_godot {
+
+UsdChangeListener::~UsdChangeListener() {
+    detach();
+}
+
+void UsdChangeListener::attach(const UsdStageRefPtr &p_stage) {
+    detach();
+    if (p_stage) {
+        _key = TfNotice::Register(TfCreateWeakPtr(this), &UsdChangeListener::_on_objects_changed, UsdStagePtr(p_stage));
+    }
+}
+
+void UsdChangeListener::detach() {
+    if (_key.IsValid()) {
+        TfNotice::Revoke(_key);
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _changes = StageChanges();
+}
+
+bool UsdChangeListener::has_changes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_changes.empty();
+}
+
+bool UsdChangeListener::take_changes(StageChanges *r_changes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_changes.empty()) {
+        return false;
+    }
+    *r_changes = std::move(_changes);
+    _changes = StageChanges();
+    return true;
+}
+
+int64_t UsdChangeListener::now_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void UsdChangeListener::_on_objects_changed(const UsdNotice::ObjectsChanged &p_notice, const UsdStageWeakPtr &p_sender) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_changes.empty()) {
+        _changes.first_change_usec = now_usec();
+    }
+    for (const SdfPath &path : p_notice.GetResyncedPaths()) {
+        _changes.resynced.insert(path);
+    }
+    for (const SdfPath &path : p_notice.GetChangedInfoOnlyPaths()) {
+        _changes.changed_info.insert(path);
+    }
+}
+
+} // namespace usd_godot
@@ -0,0 +1,62 @@
+#ifndef USD_GODOT_CHANGE_LISTENER_H
+#define USD_GODOT_CHANGE_LISTENER_H
+
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/notice.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+
+#include <cstdint>
+#include <mutex>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace usd_godot {
+
+// Paths reported by UsdNotice::ObjectsChanged since the last take
+struct StageChanges {
+    SdfPathSet resynced;     // prims added, removed or recomposed; properties added or removed
+    SdfPathSet changed_info; // property values and metadata
+
+    // steady_clock time of the first notice in this batch, in microseconds
+    int64_t first_change_usec = 0;
+
+    bool empty() const { return resynced.empty() && changed_info.empty(); }
+};
+
+// Collects UsdNotice::ObjectsChanged for one stage. Notices arrive on
+// whichever thread edits the stage; consumers drain the accumulated paths
+// once per frame on their own thread, so any number of edits between two
+// frames costs one update.
+class UsdChangeListener : public TfWeakBase {
+public:
+    UsdChangeListener() = default;
+    ~UsdChangeListener();
+
+    UsdChangeListener(const UsdChangeListener &) = delete;
+    UsdChangeListener &operator=(const UsdChangeListener &) = delete;
+
+    // Listen to p_stage only, replacing any previous stage
+    void attach(const UsdStageRefPtr &p_stage);
+    void detach();
+
+    bool has_changes() const;
+
+    // Move the accumulated changes into r_changes. Returns false if there
+    // were none.
+    bool take_changes(StageChanges *r_changes);
+
+    static int64_t now_usec();
+
+private:
+    TfNotice::Key _key;
+    mutable std::mutex _mutex;
+    StageChanges _changes;
+
+    void _on_objects_changed(const UsdNotice::ObjectsChanged &p_notice, const UsdStageWeakPtr &p_sender);
+};
+
+} // namespace usd_godot
+
+#endif // USD_GODOT_CHANGE_LISTENER_H
@@ -2,6 +2,14 @@
 #include "usd_state.h"
 #include "usd_mesh_import_helper.h"
 #include "usd_mesh_export_helper.h"
+#include "usd_instance_import_helper.h"
+#include "usd_animation_import_helper.h"
+#include "usd_animation_export_helper.h"
+#include "usd_layer_writer.h"
+#include "usd_material_export_helper.h"
+#include "usd_parallel.h"
+#include "usd_texture_loader.h"
+#include "usd_transform_batch.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
@@ -17,24 +25,99 @@
 #include <godot_cpp/classes/camera3d.hpp>
 #include <godot_cpp/classes/light3d.hpp>
 #include <godot_cpp/classes/animation_player.hpp>
+#include <godot_cpp/classes/animation_library.hpp>
 #include <godot_cpp/variant/packed_vector3_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
 #include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
 
 // USD headers
 #include <pxr/usd/usdGeom/xform.h>
 #include <pxr/usd/usdGeom/camera.h>
 #include <pxr/usd/usdGeom/gprim.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/mesh.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/boundable.h>
+#include <pxr/usd/usdGeom/modelAPI.h>
+#include <pxr/usd/usdGeom/xformCache.h>
+#include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/changeBlock.h>
+#include <pxr/usd/sdf/schema.h>
 #include <pxr/usd/sdf/types.h>
 #include <pxr/usd/sdf/copyUtils.h>
 #include <pxr/base/tf/token.h>
 #include <pxr/base/vt/value.h>
 #include <pxr/base/gf/matrix4d.h>
 #include <pxr/usd/usdLux/sphereLight.h>
+#include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/attributeSpec.h>
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
 
 namespace godot {
 
+// State shared across one import_from_file call
+struct UsdImportContext {
+    // Material textures, decoded on worker threads during the walk
+    UsdTextureLoader texture_loader;
+
+    UsdMeshImportHelper mesh_helper;
+
+    // Point instancers and instanceable prims, imported as MultiMeshes
+    UsdInstanceImportHelper instance_helper{ mesh_helper };
+
+    // UsdGeomMesh geometry converted ahead of node creation, by prim path
+    std::unordered_map<pxr::SdfPath, UsdMeshSurfaceData, pxr::SdfPath::Hash> prebuilt_meshes;
+
+    // Time-sampled prims, baked into an AnimationPlayer under import_root
+    // when UsdState.import_animation is set
+    bool import_animation = false;
+    Node *import_root = nullptr;
+    UsdAnimationImportHelper animation_helper;
+
+    // Prims whose payload is not loaded, imported as bare Node3Ds
+    int64_t payload_placeholder_count = 0;
+};
+
+// State shared across one append_from_scene call
+struct UsdExportContext {
+    // Generic meshes are queued during the walk and converted in parallel
+    // afterwards; meshes used by several nodes are authored once under
+    // /Prototypes and referenced
+    UsdMeshExportHelper mesh_helper;
+
+    // One UsdPreviewSurface network per Godot material, bound per surface
+    UsdMaterialExportHelper material_helper{ pxr::SdfPath("/Root/Materials") };
+
+    // Nodes moved by AnimationPlayers, exported as xformOp time samples
+    // when UsdState.export_animations is set
+    UsdAnimationExportHelper animation_helper;
+};
+
+// p_file relative to the directory of p_layer_path, as an anchored "./"
+// or "../" asset path. Files that have no relative path from there, such
+// as another drive, stay absolute.
+static std::string _RelativeAssetPath(const std::string &p_file, const std::string &p_layer_path) {
+    std::error_code error;
+    const std::filesystem::path base = std::filesystem::path(p_layer_path).parent_path();
+    const std::filesystem::path relative = std::filesystem::relative(p_file, base, error);
+    if (error || relative.empty()) {
+        return p_file;
+    }
+    const std::string path = relative.generic_string();
+    return path.rfind("..", 0) == 0 ? path : "./" + path;
+}
+
+// Children the hierarchy walk visits. Unlike GetChildren() this keeps
+// prims whose payload is not loaded, so they can become placeholders.
+static pxr::UsdPrimSiblingRange _GetImportChildren(const pxr::UsdPrim &p_prim) {
+    return p_prim.GetFilteredChildren(pxr::UsdPrimIsActive && pxr::UsdPrimIsDefined && !pxr::UsdPrimIsAbstract);
+}
+
 void UsdDocument::_bind_methods() {
     ClassDB::bind_method(D_METHOD("append_from_scene", "scene_root", "state", "flags"), &UsdDocument::append_from_scene, DEFVAL(0));
     ClassDB::bind_method(D_METHOD("write_to_filesystem", "state", "path"), &UsdDocument::write_to_filesystem);
@@ -63,36 +146,92 @@ Error UsdDocument::append_from_scene(Node *p_scene_root, Ref<UsdState> p_state,
     //UtilityFunctions::print("USD Export: Appending scene ", p_scene_root->get_name(), " to USD document");
     
     try {
-        // Create a new USD stage in memory
-        pxr::UsdStageRefPtr stage = pxr::UsdStage::CreateInMemory();
+        // Author into an anonymous layer through the Sdf API, with change
+        // processing deferred to a single SdfChangeBlock; the stage is only
+        // opened once every spec exists
+        pxr::SdfLayerRefPtr layer = pxr::SdfLayer::CreateAnonymous("export.usda");
+        if (!layer) {
+            UtilityFunctions::printerr("USD Export: Failed to create USD layer");
+            return ERR_CANT_CREATE;
+        }
+        UsdLayerWriter writer(layer);
+        UsdExportContext context;
+        context.mesh_helper.set_prototype_scope(pxr::SdfPath("/Prototypes"));
+        context.material_helper.set_export_textures(p_state->get_export_textures());
+
+        {
+            pxr::SdfChangeBlock change_block;
+
+            // Set up the stage metadata
+            layer->SetStartTimeCode(1);
+            layer->SetEndTimeCode(1);
+            layer->SetTimeCodesPerSecond(p_state->get_bake_fps());
+
+            // Create a root prim for the scene
+            const pxr::SdfPath root_path("/Root");
+            writer.define_prim(root_path, pxr::TfToken("Xform"));
+            layer->SetDefaultPrim(root_path.GetNameToken());
+
+            // Add metadata (using custom layer data for copyright)
+            if (!p_state->get_copyright().is_empty()) {
+                auto customData = layer->GetCustomLayerData();
+                customData["copyright"] = pxr::VtValue(std::string(p_state->get_copyright().utf8().get_data()));
+                layer->SetCustomLayerData(customData);
+            }
+
+            if (p_state->get_export_animations()) {
+                UsdAnimationExportOptions animation_options;
+                animation_options.fps = p_state->get_bake_fps();
+                animation_options.thread_count = p_state->get_thread_count();
+                context.animation_helper.set_options(animation_options);
+
+                // Find animated nodes first so they get op stacks that can
+                // hold time samples
+                TypedArray<Node> players = p_scene_root->find_children("*", "AnimationPlayer", true, false);
+                if (AnimationPlayer *root_player = Object::cast_to<AnimationPlayer>(p_scene_root)) {
+                    context.animation_helper.add_player(root_player);
+                }
+                for (int64_t i = 0; i < players.size(); ++i) {
+                    context.animation_helper.add_player(Object::cast_to<AnimationPlayer>(players[i]));
+                }
+            }
+
+            // Traverse the scene and convert nodes to USD prims
+            _convert_node_to_prim(p_scene_root, writer, root_path, p_state, context);
+
+            // Mesh geometry: converted on worker threads, authored here
+            context.mesh_helper.export_queued_meshes(writer, p_state->get_thread_count());
+            if (context.mesh_helper.get_mesh_count() > 0) {
+                UtilityFunctions::print("USD Export: Exported ", context.mesh_helper.get_mesh_count(), " meshes (",
+                        context.mesh_helper.get_unique_mesh_count(), " unique, ",
+                        context.mesh_helper.get_prototype_count(), " shared through /Prototypes, ",
+                        context.mesh_helper.get_surface_count(), " surfaces)");
+            }
+            if (context.material_helper.get_material_count() > 0) {
+                UtilityFunctions::print("USD Export: Exported ", context.material_helper.get_material_count(), " materials (",
+                        context.material_helper.get_texture_count(), " textures)");
+            }
+
+            if (context.animation_helper.has_animated_nodes()) {
+                int64_t last_time_code = context.animation_helper.write_time_samples(writer);
+                if (last_time_code >= 0) {
+                    layer->SetStartTimeCode(0);
+                    layer->SetEndTimeCode(last_time_code);
+                    UtilityFunctions::print("USD Export: Wrote ", context.animation_helper.get_sample_count(), " time samples for ",
+                            context.animation_helper.get_animated_node_count(), " animated nodes");
+                }
+            }
+        }
+
+        pxr::UsdStageRefPtr stage = pxr::UsdStage::Open(layer);
         if (!stage) {
             UtilityFunctions::printerr("USD Export: Failed to create USD stage");
             return ERR_CANT_CREATE;
         }
-        
-        // Set up the stage
-        stage->SetStartTimeCode(1);
-        stage->SetEndTimeCode(1);
-        stage->SetTimeCodesPerSecond(p_state->get_bake_fps());
-        
-        // Create a root prim for the scene
-        pxr::UsdGeomXform root = pxr::UsdGeomXform::Define(stage, pxr::SdfPath("/Root"));
-        stage->SetDefaultPrim(root.GetPrim());
-        
-        // Add metadata (using custom layer data for copyright)
-        if (!p_state->get_copyright().is_empty()) {
-            auto rootLayer = stage->GetRootLayer();
-            auto customData = rootLayer->GetCustomLayerData();
-            customData["copyright"] = pxr::VtValue(std::string(p_state->get_copyright().utf8().get_data()));
-            rootLayer->SetCustomLayerData(customData);
-        }
-        
+
         // Store the stage in the state for later use in write_to_filesystem
         p_state->set_stage(stage);
-        
-        // Traverse the scene and convert nodes to USD prims
-        _convert_node_to_prim(p_scene_root, stage, pxr::SdfPath("/Root"), p_state);
-        
+        p_state->set_texture_files(context.material_helper.get_texture_files());
         return OK;
     } catch (const std::exception& e) {
         UtilityFunctions::printerr("USD Export: Exception occurred: ", e.what());
@@ -100,7 +239,7 @@ Error UsdDocument::append_from_scene(Node *p_scene_root, Ref<UsdState> p_state,
     }
 }
 
-void UsdDocument::_convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath &p_parent_path, Ref<UsdState> p_state) {
+void UsdDocument::_convert_node_to_prim(Node *p_node, UsdLayerWriter &p_writer, const pxr::SdfPath &p_parent_path, Ref<UsdState> p_state, UsdExportContext &p_context) {
     // Check if the node is valid
     if (!p_node) {
         UtilityFunctions::printerr("USD Export: Invalid node");
@@ -119,11 +258,14 @@ void UsdDocument::_convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stag
     // Create a USD prim based on the node type
     if (p_node->is_class("Node3D")) {
         // Create a transform prim
-        pxr::UsdGeomXform xform = pxr::UsdGeomXform::Define(p_stage, node_path);
+        p_writer.define_prim(node_path, pxr::TfToken("Xform"));
         
         // Set the transform
         Node3D *node_3d = Object::cast_to<Node3D>(p_node);
-        if (node_3d) {
+        if (node_3d && p_context.animation_helper.is_animated(node_3d)) {
+            // Animated: translate/orient/scale ops, sampled after the walk
+            p_context.animation_helper.define_ops(node_3d, p_writer, node_path);
+        } else if (node_3d) {
             // Get the transform
             Transform3D transform = node_3d->get_transform();
             
@@ -141,10 +283,9 @@ void UsdDocument::_convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stag
             matrix.SetRow(3, pxr::GfVec4d(origin.x, origin.y, origin.z, 1.0));
             
             // Add a transform op
-            pxr::UsdGeomXformOp transformOp = xform.AddTransformOp();
-            transformOp.Set(matrix);
-            
-            //UtilityFunctions::print("USD Export: Set transform for ", node_name);
+            static const pxr::TfToken transform_op("xformOp:transform");
+            p_writer.set_attribute(node_path, transform_op, pxr::SdfValueTypeNames->Matrix4d, pxr::VtValue(matrix));
+            p_writer.set_xform_op_order(node_path, pxr::VtArray<pxr::TfToken>{ transform_op });
         }
         
         // Check if it's a MeshInstance3D
@@ -156,14 +297,19 @@ void UsdDocument::_convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stag
                 if (mesh.is_valid()) {
                     // Create a path for the mesh
                     pxr::SdfPath mesh_path = node_path.AppendChild(pxr::TfToken("Mesh"));
+
+                    // Material bound to each surface, honoring overrides
+                    pxr::SdfPathVector surface_materials;
+                    if (p_state->get_export_materials()) {
+                        surface_materials.resize(mesh->get_surface_count());
+                        for (int surface = 0; surface < mesh->get_surface_count(); surface++) {
+                            surface_materials[surface] = p_context.material_helper.get_or_define_material(
+                                    mesh_instance->get_active_material(surface), p_writer);
+                        }
+                    }
                     
                     // Use the mesh export helper to convert the Godot mesh to a USD prim
-                    UsdMeshExportHelper mesh_helper;
-                    pxr::UsdPrim mesh_prim = mesh_helper.export_mesh_to_prim(mesh, p_stage, mesh_path);
-                    
-                    if (mesh_prim) {
-                        UtilityFunctions::print("USD Export: Exported mesh for ", node_name);
-                    } else {
+                    if (!p_context.mesh_helper.export_mesh_to_prim(mesh, surface_materials, p_writer, mesh_path)) {
                         UtilityFunctions::printerr("USD Export: Failed to export mesh for ", node_name);
                     }
                 }
@@ -173,15 +319,13 @@ void UsdDocument::_convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stag
         // Process children
         for (int i = 0; i < p_node->get_child_count(); i++) {
             Node *child = p_node->get_child(i);
-            _convert_node_to_prim(child, p_stage, node_path, p_state);
+            _convert_node_to_prim(child, p_writer, node_path, p_state, p_context);
         }
     } else {
-        UtilityFunctions::print("USD Export: Skipping non-Node3D node: ", node_name);
-        
         // Process children even for non-Node3D nodes
         for (int i = 0; i < p_node->get_child_count(); i++) {
             Node *child = p_node->get_child(i);
-            _convert_node_to_prim(child, p_stage, p_parent_path, p_state);
+            _convert_node_to_prim(child, p_writer, p_parent_path, p_state, p_context);
         }
     }
 }
@@ -209,8 +353,70 @@ Error UsdDocument::write_to_filesystem(Ref<UsdState> p_state, const String &p_pa
             return ERR_INVALID_PARAMETER;
         }
         
-        // Export the stage to the file
-        stage->Export(p_path.utf8().get_data());
+        // Convert Godot path to filesystem path
+        String abs_path = p_path;
+        if (p_path.begins_with("res://") || p_path.begins_with("user://")) {
+            abs_path = ProjectSettings::get_singleton()->globalize_path(p_path);
+        }
+
+        // .usda and .usdc pick their own format; a plain .usd follows
+        // use_binary_format
+        const bool binary = p_state->get_use_binary_format();
+        const String extension = p_path.get_extension().to_lower();
+        pxr::SdfLayer::FileFormatArguments format_args;
+        if (extension == "usd") {
+            format_args["format"] = binary ? "usdc" : "usda";
+        } else if (extension == "usda" && binary) {
+            UtilityFunctions::print("USD Export: Writing text because the path ends in .usda; use .usd or .usdc for binary");
+        }
+
+        // A stage built by append_from_scene is one layer with no arcs, so
+        // it is written straight from that layer: crate output streams to
+        // the file without a flattened copy of the scene. Anything else is
+        // flattened first.
+        pxr::SdfLayerHandle root_layer = stage->GetRootLayer();
+        pxr::SdfLayerHandle session_layer = stage->GetSessionLayer();
+        bool single_layer = !session_layer || session_layer->IsEmpty();
+        for (const pxr::SdfLayerHandle &layer : stage->GetUsedLayers()) {
+            if (layer != root_layer && layer != session_layer) {
+                single_layer = false;
+                break;
+            }
+        }
+
+        // Texture paths are authored absolute because the layer has no
+        // location until now; write them relative to the output file so the
+        // export can be moved with its textures, then restore them for
+        // later writes to other paths
+        const std::string layer_path = abs_path.utf8().get_data();
+        const std::vector<std::pair<pxr::SdfPath, std::string>> &texture_files = p_state->get_texture_files();
+        auto set_texture_files = [&](const pxr::SdfLayerHandle &p_layer, bool p_relative) {
+            pxr::SdfChangeBlock change_block;
+            for (const std::pair<pxr::SdfPath, std::string> &texture_file : texture_files) {
+                pxr::SdfAttributeSpecHandle attribute = p_layer->GetAttributeAtPath(texture_file.first);
+                if (attribute) {
+                    const std::string asset_path = p_relative ? _RelativeAssetPath(texture_file.second, layer_path) : texture_file.second;
+                    attribute->SetDefaultValue(pxr::VtValue(pxr::SdfAssetPath(asset_path)));
+                }
+            }
+        };
+
+        bool exported = false;
+        if (single_layer) {
+            set_texture_files(root_layer, true);
+            exported = root_layer->Export(layer_path, std::string(), format_args);
+            set_texture_files(root_layer, false);
+        } else {
+            pxr::SdfLayerRefPtr flattened = stage->Flatten();
+            if (flattened) {
+                set_texture_files(flattened, true);
+                exported = flattened->Export(layer_path, std::string(), format_args);
+            }
+        }
+        if (!exported) {
+            UtilityFunctions::printerr("USD Export: Failed to write ", p_path);
+            return ERR_FILE_CANT_WRITE;
+        }
         
         UtilityFunctions::print("USD Export: Successfully exported scene to ", p_path);
         return OK;
@@ -252,8 +458,10 @@ Error UsdDocument::import_from_file(const String &p_path, Node *p_parent, Ref<Us
     }
 
     try {
-        // Open the USD stage
-        pxr::UsdStageRefPtr stage = pxr::UsdStage::Open(abs_path.utf8().get_data());
+        // Lazy imports leave every payload unloaded; payload prims become
+        // placeholders that UsdPayloadLoader converts on demand
+        const pxr::UsdStage::InitialLoadSet load_set = p_state->get_lazy_payloads() ? pxr::UsdStage::LoadNone : pxr::UsdStage::LoadAll;
+        pxr::UsdStageRefPtr stage = pxr::UsdStage::Open(abs_path.utf8().get_data(), load_set);
         if (!stage) {
             UtilityFunctions::printerr("USD Import: Failed to open USD stage");
             return ERR_CANT_OPEN;
@@ -268,16 +476,187 @@ Error UsdDocument::import_from_file(const String &p_path, Node *p_parent, Ref<Us
             // If there's no default prim, use the pseudo-root
             default_prim = stage->GetPseudoRoot();
         }
-        
-        // Import the prim hierarchy
-        return _import_prim_hierarchy(stage, default_prim.GetPath(), p_parent, p_state);
+
+        return _import_subtree(stage, default_prim, p_parent, p_state, p_path);
     } catch (const std::exception& e) {
         UtilityFunctions::printerr("USD Import: Exception occurred: ", e.what());
         return ERR_CANT_OPEN;
     }
 }
 
-Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state) {
+Error UsdDocument::import_prim(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state) {
+    if (!p_stage || !p_parent || p_state.is_null()) {
+        UtilityFunctions::printerr("USD Import: import_prim needs a stage, a parent and a state");
+        return ERR_INVALID_PARAMETER;
+    }
+
+    pxr::UsdPrim prim = p_stage->GetPrimAtPath(p_prim_path);
+    if (!prim) {
+        UtilityFunctions::printerr("USD Import: Invalid prim path: ", String(p_prim_path.GetText()));
+        return ERR_INVALID_PARAMETER;
+    }
+
+    try {
+        // No animation baking: the AnimationPlayer belongs to the whole
+        // import, not to one prim
+        return _import_subtree(p_stage, prim, p_parent, p_state, String());
+    } catch (const std::exception& e) {
+        UtilityFunctions::printerr("USD Import: Exception occurred: ", e.what());
+        return ERR_CANT_OPEN;
+    }
+}
+
+Node3D *UsdDocument::create_payload_placeholder(const pxr::UsdPrim &p_prim) {
+    Node3D *node = memnew(Node3D);
+    node->set_name(String(p_prim.GetName().GetText()));
+    node->set_meta("usd_payload", String(p_prim.GetPath().GetText()));
+
+    // extentsHint is authored next to the payload arc precisely so bounds
+    // are known without loading it; its first range is the default purpose.
+    // Boundable prims may carry a plain extent instead.
+    pxr::VtVec3fArray extent;
+    if (!pxr::UsdGeomModelAPI(p_prim).GetExtentsHint(&extent) || extent.size() < 2) {
+        extent.clear();
+        pxr::UsdGeomBoundable boundable(p_prim);
+        if (boundable) {
+            boundable.GetExtentAttr().Get(&extent);
+        }
+    }
+    if (extent.size() >= 2) {
+        const Vector3 min(extent[0][0], extent[0][1], extent[0][2]);
+        const Vector3 max(extent[1][0], extent[1][1], extent[1][2]);
+        node->set_meta("usd_payload_bounds", AABB(min, max - min));
+    }
+    return node;
+}
+
+// Converts p_root and everything loaded below it. p_path names the baked
+// animation; without one nothing is baked.
+Error UsdDocument::_import_subtree(const pxr::UsdStageRefPtr &p_stage, const pxr::UsdPrim &p_root, Node *p_parent, Ref<UsdState> p_state, const String &p_path) {
+    // One mesh helper for the whole import so statistics and the mesh
+    // cache cover every prim
+    UsdMeshImportOptions mesh_options;
+    mesh_options.weld_vertices = p_state->get_weld_vertices();
+    mesh_options.parallel_face_threshold = p_state->get_parallel_face_threshold();
+    mesh_options.thread_count = p_state->get_thread_count();
+    mesh_options.deduplicate_meshes = p_state->get_deduplicate_meshes();
+    UsdImportContext context;
+    context.mesh_helper.set_options(mesh_options);
+    context.texture_loader.start(mesh_options.thread_count);
+    context.mesh_helper.set_texture_loader(&context.texture_loader);
+
+    UsdAnimationImportOptions animation_options;
+    animation_options.decimation_tolerance = p_state->get_animation_decimation_tolerance();
+    animation_options.thread_count = p_state->get_thread_count();
+    context.animation_helper.set_options(animation_options);
+    context.import_animation = p_state->get_import_animation() && !p_path.is_empty();
+    context.import_root = p_parent;
+
+    // Convert all mesh geometry on worker threads first, then build the
+    // node hierarchy on this thread from the prebuilt arrays
+    _prebuild_meshes(p_root, context, UsdParallel::resolve_thread_count(mesh_options.thread_count));
+    Error err = _import_prim_hierarchy(p_stage, p_root.GetPath(), p_parent, p_state, context);
+
+    // Instanceable prims were collected during the walk. Their transforms
+    // are in stage world space, so groups under a prim's parent node are
+    // offset back out of that parent's world transform (identity when
+    // importing the whole stage).
+    if (err == OK && context.instance_helper.has_instances()) {
+        const int64_t first_group = p_parent->get_child_count();
+        context.instance_helper.build_instance_groups(p_parent, p_parent->get_owner() ? p_parent->get_owner() : p_parent);
+        const pxr::UsdPrim world_parent = p_root.GetParent();
+        if (world_parent && !world_parent.IsPseudoRoot()) {
+            const Transform3D to_parent = UsdTransformBatch::to_transform(pxr::UsdGeomXformCache().GetLocalToWorldTransform(world_parent)).affine_inverse();
+            for (int64_t i = first_group; i < p_parent->get_child_count(); ++i) {
+                if (Node3D *group = Object::cast_to<Node3D>(p_parent->get_child(i))) {
+                    group->set_transform(to_parent);
+                }
+            }
+        }
+    }
+    if (context.instance_helper.get_instance_count() > 0) {
+        UtilityFunctions::print("USD Import: ", context.instance_helper.get_instance_count(), " instances in ",
+                context.instance_helper.get_multimesh_count(), " MultiMeshes");
+    }
+    if (context.payload_placeholder_count > 0) {
+        UtilityFunctions::print("USD Import: ", context.payload_placeholder_count, " unloaded payloads imported as placeholders");
+    }
+
+    if (err == OK && context.animation_helper.has_prims()) {
+        _create_animation_player(p_stage, p_path, p_parent, context);
+    }
+
+    // Materials hold placeholders until their textures are swapped in
+    context.texture_loader.finish();
+
+    context.mesh_helper.print_stats();
+    return err;
+}
+
+void UsdDocument::_create_animation_player(const pxr::UsdStageRefPtr &p_stage, const String &p_path, Node *p_parent, UsdImportContext &p_context) {
+    UsdAnimationImportHelper &helper = p_context.animation_helper;
+    Ref<Animation> animation = helper.bake(p_stage);
+    if (animation.is_null()) {
+        return;
+    }
+
+    Ref<AnimationLibrary> library;
+    library.instantiate();
+    library->add_animation(StringName(p_path.get_file().get_basename()), animation);
+
+    // The player's default root node is its parent, so track paths are
+    // relative to p_parent
+    AnimationPlayer *player = memnew(AnimationPlayer);
+    player->set_name("AnimationPlayer");
+    player->add_animation_library(StringName(), library);
+    p_parent->add_child(player);
+    player->set_owner(p_parent->get_owner() ? p_parent->get_owner() : p_parent);
+
+    UtilityFunctions::print("USD Import: Baked ", helper.get_track_count(), " animation tracks, ", helper.get_key_count(),
+            " keys (", helper.get_keys_removed(), " redundant keys removed)");
+}
+
+void UsdDocument::_prebuild_meshes(const pxr::UsdPrim &p_root, UsdImportContext &p_context, int p_thread_count) {
+    // Gather every mesh the hierarchy walk will visit. Point instancer
+    // prototypes are imported by UsdInstanceImportHelper instead.
+    std::vector<pxr::UsdPrim> mesh_prims;
+    pxr::UsdPrimRange range(p_root);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        if (it->IsA<pxr::UsdGeomPointInstancer>()) {
+            it.PruneChildren();
+        } else if (it->IsA<pxr::UsdGeomMesh>()) {
+            mesh_prims.push_back(*it);
+        }
+    }
+    if (mesh_prims.empty()) {
+        return;
+    }
+
+    // Parallelize across meshes rather than inside them when there are
+    // several, so worker threads don't each spawn their own
+    UsdMeshImportOptions worker_options = p_context.mesh_helper.get_options();
+    if (mesh_prims.size() > 1) {
+        worker_options.thread_count = 1;
+    }
+    UsdMeshImportHelper worker_helper;
+    worker_helper.set_options(worker_options);
+
+    // Workers only read the stage and fill packed arrays; no Godot objects
+    // or scene tree access until _import_prim_hierarchy
+    std::vector<UsdMeshSurfaceData> surfaces(mesh_prims.size());
+    UsdParallel::for_range(mesh_prims.size(), p_thread_count, [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t i = p_begin; i < p_end; ++i) {
+            worker_helper.build_geom_mesh_surface(pxr::UsdGeomMesh(mesh_prims[i]), &surfaces[i]);
+        }
+    });
+
+    p_context.prebuilt_meshes.reserve(mesh_prims.size());
+    for (size_t i = 0; i < mesh_prims.size(); ++i) {
+        p_context.prebuilt_meshes.emplace(mesh_prims[i].GetPath(), surfaces[i]);
+    }
+}
+
+Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state, UsdImportContext &p_context) {
     // This method will recursively import a USD prim hierarchy into a Godot scene
     
     // Get the prim
@@ -290,8 +669,8 @@ Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, co
     // Skip the pseudo-root
     if (prim.IsPseudoRoot()) {
         // Process children
-        for (const pxr::UsdPrim &child : prim.GetChildren()) {
-            Error err = _import_prim_hierarchy(p_stage, child.GetPath(), p_parent, p_state);
+        for (const pxr::UsdPrim &child : _GetImportChildren(prim)) {
+            Error err = _import_prim_hierarchy(p_stage, child.GetPath(), p_parent, p_state, p_context);
             if (err != OK) {
                 return err;
             }
@@ -299,22 +678,64 @@ Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, co
         return OK;
     }
     
+    // Materials, shaders and GeomSubsets have no node of their own; meshes
+    // pick up their bindings when they are imported. Untyped prims are
+    // still walked, as they often just group Xforms.
+    if (!prim.GetTypeName().IsEmpty() && !prim.IsA<pxr::UsdGeomImageable>()) {
+        return OK;
+    }
+
+    // Instances of the same prototype become one MultiMeshInstance3D,
+    // created once the walk is done
+    if (prim.IsInstance()) {
+        p_context.instance_helper.add_instance(prim);
+        return OK;
+    }
+
     // Create the appropriate node type for this prim
     Node3D *node = nullptr;
     String prim_name = String(prim.GetName().GetString().c_str());
+    bool import_children = true;
 
     // Handle specific prim types - create the right node type directly
-    if (prim.IsA<pxr::UsdGeomGprim>()) {
+    if (prim.HasAuthoredPayloads() && !prim.IsLoaded()) {
+        // Nothing below an unloaded payload is composed yet; UsdPayloadLoader
+        // replaces the placeholder once the payload is loaded
+        node = create_payload_placeholder(prim);
+        import_children = false;
+        p_context.payload_placeholder_count++;
+    } else if (prim.IsA<pxr::UsdGeomPointInstancer>()) {
+        // Prototypes are imported as MultiMeshInstance3D children, so the
+        // instancer's own children are not walked
+        node = p_context.instance_helper.import_point_instancer(pxr::UsdGeomPointInstancer(prim));
+        import_children = false;
+    } else if (prim.IsA<pxr::UsdGeomGprim>()) {
         // Create a MeshInstance3D directly for geometric primitives
         MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
         mesh_instance->set_name(prim_name);
 
-        // Use the mesh import helper to convert the USD prim to a Godot mesh
-        UsdMeshImportHelper mesh_helper;
-        Ref<Mesh> mesh = mesh_helper.import_mesh_from_prim(prim);
+        // Use the mesh import helper to convert the USD prim to a Godot mesh,
+        // picking up geometry converted by _prebuild_meshes when available
+        Ref<Mesh> mesh;
+        auto prebuilt = p_context.prebuilt_meshes.find(prim.GetPath());
+        if (prebuilt != p_context.prebuilt_meshes.end()) {
+            mesh = p_context.mesh_helper.create_geom_mesh(prebuilt->second);
+            p_context.prebuilt_meshes.erase(prebuilt);
+        } else {
+            mesh = p_context.mesh_helper.import_mesh_from_prim(prim);
+        }
 
         if (mesh.is_valid()) {
             mesh_instance->set_mesh(mesh);
+
+            // Prims bound to the same USD material share one Godot material;
+            // surfaces split from GeomSubsets take the subset's binding
+            for (int surface = 0; surface < mesh->get_surface_count(); surface++) {
+                Ref<Material> material = p_context.mesh_helper.get_surface_material(prim, mesh, surface);
+                if (material.is_valid()) {
+                    mesh_instance->set_surface_override_material(surface, material);
+                }
+            }
         }
 
         node = mesh_instance;
@@ -349,7 +770,11 @@ Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, co
 
     // Add the node to the parent and set ownership
     p_parent->add_child(node);
-    node->set_owner(p_parent->get_owner() ? p_parent->get_owner() : p_parent);
+    Node *owner = p_parent->get_owner() ? p_parent->get_owner() : p_parent;
+    node->set_owner(owner);
+    for (int i = 0; i < node->get_child_count(); ++i) {
+        node->get_child(i)->set_owner(owner);
+    }
 
     // Set the transform if the prim is transformable
     if (prim.IsA<pxr::UsdGeomXformable>()) {
@@ -376,11 +801,19 @@ Error UsdDocument::_import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, co
         transform.set_basis(basis);
         transform.set_origin(origin);
         node->set_transform(transform);
+
+        if (p_context.import_animation) {
+            p_context.animation_helper.add_prim(prim, p_context.import_root->get_path_to(node));
+        }
+    }
+
+    if (!import_children) {
+        return OK;
     }
 
     // Process children
-    for (const pxr::UsdPrim &child : prim.GetChildren()) {
-        Error err = _import_prim_hierarchy(p_stage, child.GetPath(), node, p_state);
+    for (const pxr::UsdPrim &child : _GetImportChildren(prim)) {
+        Error err = _import_prim_hierarchy(p_stage, child.GetPath(), node, p_state, p_context);
         if (err != OK) {
             return err;
         }
@@ -3,6 +3,7 @@
 
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/node3d.hpp>
 #include <godot_cpp/variant/string.hpp>
 
 // USD headers
@@ -12,6 +13,9 @@
 namespace godot {
 
 class UsdState;
+struct UsdImportContext;
+struct UsdExportContext;
+class UsdLayerWriter;
 
 class UsdDocument : public Resource {
     GDCLASS(UsdDocument, Resource);
@@ -30,12 +34,25 @@ public:
     // Import methods
     Error import_from_file(const String &p_path, Node *p_parent, Ref<UsdState> p_state);
 
+    // Import one prim and what is loaded below it under p_parent, from a
+    // stage the caller keeps open. UsdPayloadLoader uses this to convert
+    // payloads as they are loaded.
+    Error import_prim(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state);
+
+    // Node standing in for a prim whose payload is not loaded: a Node3D
+    // with "usd_payload" (prim path) and, when the prim has an extentsHint
+    // or extent, "usd_payload_bounds" (local AABB) metadata
+    static Node3D *create_payload_placeholder(const pxr::UsdPrim &p_prim);
+
 private:
     // Export helpers
-    void _convert_node_to_prim(Node *p_node, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath &p_parent_path, Ref<UsdState> p_state);
+    void _convert_node_to_prim(Node *p_node, UsdLayerWriter &p_writer, const pxr::SdfPath &p_parent_path, Ref<UsdState> p_state, UsdExportContext &p_context);
 
     // Import helpers
-    Error _import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state);
+    Error _import_subtree(const pxr::UsdStageRefPtr &p_stage, const pxr::UsdPrim &p_root, Node *p_parent, Ref<UsdState> p_state, const String &p_path);
+    Error _import_prim_hierarchy(const pxr::UsdStageRefPtr &p_stage, const pxr::SdfPath &p_prim_path, Node *p_parent, Ref<UsdState> p_state, UsdImportContext &p_context);
+    void _prebuild_meshes(const pxr::UsdPrim &p_root, UsdImportContext &p_context, int p_thread_count);
+    void _create_animation_player(const pxr::UsdStageRefPtr &p_stage, const String &p_path, Node *p_parent, UsdImportContext &p_context);
 };
 
 } // namespace godot
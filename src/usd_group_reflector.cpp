@@ -0,0 +1,514 @@
+#include "usd_group_reflector.h"
+#include "usd_mesh_import_helper.h"
+#include "usd_mesh_disk_cache.h"
+#include "usd_instance_import_helper.h"
+#include "usd_stage_manager.h"
+#include "usd_transform_batch.h"
+#include <godot_cpp/classes/mesh_instance3d.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+// USD headers
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/gprim.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/xform.h>
+#include <pxr/usd/usdGeom/xformable.h>
+
+namespace godot {
+
+void UsdGroupReflector::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("reflect", "file_path", "parent", "group_name"), &UsdGroupReflector::reflect);
+    ClassDB::bind_method(D_METHOD("sync"), &UsdGroupReflector::sync);
+    ClassDB::bind_method(D_METHOD("is_reflected"), &UsdGroupReflector::is_reflected);
+    ClassDB::bind_method(D_METHOD("has_pending_changes"), &UsdGroupReflector::has_pending_changes);
+    ClassDB::bind_method(D_METHOD("get_group_root"), &UsdGroupReflector::get_group_root);
+    ClassDB::bind_method(D_METHOD("get_file_path"), &UsdGroupReflector::get_file_path);
+    ClassDB::bind_method(D_METHOD("get_group_name"), &UsdGroupReflector::get_group_name);
+    ClassDB::bind_method(D_METHOD("get_sync_stats"), &UsdGroupReflector::get_sync_stats);
+    ClassDB::bind_method(D_METHOD("get_reflect_stats"), &UsdGroupReflector::get_reflect_stats);
+}
+
+UsdGroupReflector::UsdGroupReflector() {
+}
+
+UsdGroupReflector::~UsdGroupReflector() {
+}
+
+// True if p_prim or anything below it is a native instance
+static bool _SubtreeHasInstances(const UsdPrim &p_prim) {
+    for (const UsdPrim &prim : UsdPrimRange(p_prim)) {
+        if (prim.IsInstance()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void _AddToGroupRecursive(Node *p_node, const String &p_group_name) {
+    p_node->add_to_group(p_group_name);
+    for (int i = 0; i < p_node->get_child_count(); i++) {
+        _AddToGroupRecursive(p_node->get_child(i), p_group_name);
+    }
+}
+
+bool UsdGroupReflector::_apply_transform(const UsdPrim &p_prim, Node3D *p_node) {
+    if (!p_node) {
+        return false;
+    }
+    
+    // Extract transform from USD prim
+    UsdGeomXform usdXform(p_prim);
+    bool reset_xform_stack = false;
+    std::vector<UsdGeomXformOp> xform_ops = usdXform.GetOrderedXformOps(&reset_xform_stack);
+    
+    if (xform_ops.empty()) {
+        //UtilityFunctions::print("USD Import: No transform found for node: ", p_node->get_name());
+        return false;
+    }
+    
+    // Get the transform matrix
+    GfMatrix4d usd_matrix;
+    bool resetsXformStack = false;
+    usdXform.GetLocalTransformation(&usd_matrix, &resetsXformStack);
+    
+    // Convert USD matrix to Godot transform
+    Transform3D transform;
+    
+    // Extract basis (rotation and scale)
+    Basis basis(
+        Vector3(usd_matrix[0][0], usd_matrix[0][1], usd_matrix[0][2]),
+        Vector3(usd_matrix[1][0], usd_matrix[1][1], usd_matrix[1][2]),
+        Vector3(usd_matrix[2][0], usd_matrix[2][1], usd_matrix[2][2])
+    );
+    
+    // Extract translation
+    Vector3 origin(usd_matrix[3][0], usd_matrix[3][1], usd_matrix[3][2]);
+    
+    // Set the transform
+    transform.set_basis(basis);
+    transform.set_origin(origin);
+    
+    // Apply the transform to the node
+    p_node->set_transform(transform);
+    
+    //UtilityFunctions::print("USD Import: Applied transform to node: ", p_node->get_name());
+    return true;
+}
+
+// Helper method to convert a USD prim to a Godot node
+Node *UsdGroupReflector::convert_prim(const UsdPrim &p_prim, Node *p_parent, Node *p_owner,
+        UsdMeshImportHelper &p_mesh_helper, UsdInstanceImportHelper &p_instance_helper,
+        UsdGroupSync *p_sync) {
+    // Skip the pseudo-root
+    if (p_prim.IsPseudoRoot()) {
+        // Process children
+        for (UsdPrim child : p_prim.GetChildren()) {
+            convert_prim(child, p_parent, p_owner ? p_owner : p_parent, p_mesh_helper, p_instance_helper, p_sync);
+        }
+        return p_parent;
+    }
+
+    // Instances of one prototype are gathered into a single
+    // MultiMeshInstance3D by build_instance_groups
+    if (p_prim.IsInstance()) {
+        p_instance_helper.add_instance(p_prim);
+        return nullptr;
+    }
+    
+    // Get the prim type and name
+    String prim_type = String(p_prim.GetTypeName().GetText());
+    String prim_name = String(p_prim.GetName().GetText());
+    
+    bool prim_is_mesh = !!pxr::UsdGeomGprim(p_prim);
+
+    // Debug output
+    //UtilityFunctions::print("USD Import: Converting prim: ", prim_name, " with type: ", prim_type);
+    
+    // Create a node based on the prim type
+    Node *node = nullptr;
+    bool convert_children = true;
+    
+    if (prim_type == "PointInstancer") {
+        // One MultiMeshInstance3D per prototype; the prototypes themselves
+        // live under the instancer and must not be converted again
+        Node3D *instancer = p_instance_helper.import_point_instancer(pxr::UsdGeomPointInstancer(p_prim));
+        _apply_transform(p_prim, instancer);
+        node = instancer;
+        convert_children = false;
+    } else if (prim_type == "Xform") {
+        // Create a Node3D for Xform prims
+        Node3D *xform = memnew(Node3D);
+        xform->set_name(prim_name);
+        
+        // Apply transform from USD prim
+        _apply_transform(p_prim, xform);
+        
+        node = xform;
+    } else if (prim_type == "Scope") {
+        // Create a Node3D for Scope prims (organizational)
+        Node3D *scope = memnew(Node3D);
+        scope->set_name(prim_name);
+        
+        // Apply transform from USD prim
+        _apply_transform(p_prim, scope);
+        
+        //UtilityFunctions::print("USD Import: Created Scope node: ", prim_name);
+        node = scope;
+    } else if (prim_type == "Material" || prim_type == "Shader" || prim_type == "GeomSubset") {
+        // Materials and subsets are picked up by the gprims bound to them
+    } else if (prim_is_mesh) {
+        // Create a MeshInstance3D with a BoxMesh for Cube prims
+        MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
+        mesh_instance->set_name(prim_name);
+        
+        Ref<Mesh> box_mesh = p_mesh_helper.import_mesh_from_prim(p_prim);
+        if (box_mesh.is_valid()) {
+            mesh_instance->set_mesh(box_mesh);
+            // Apply the materials to the mesh, one per GeomSubset surface
+            for (int surface = 0; surface < box_mesh->get_surface_count(); surface++) {
+                Ref<Material> mat = p_mesh_helper.get_surface_material(p_prim, box_mesh, surface);
+                if (mat.is_valid()) {
+                    mesh_instance->set_surface_override_material(surface, mat);
+                }
+            }
+
+            // Apply transform from USD prim
+            _apply_transform(p_prim, mesh_instance);
+        }        
+        //UtilityFunctions::print("USD Import: Created ", prim_type, " node: ", prim_name);
+        node = mesh_instance;
+    } else {
+        // For empty or unknown prim types, create a Node3D
+        // This handles cases like "Shapes" and "Materials" which have empty type names
+        Node3D *generic = memnew(Node3D);
+        generic->set_name(prim_name);
+        
+        // Apply transform from USD prim
+        _apply_transform(p_prim, generic);
+        
+        //UtilityFunctions::print("USD Import: Created generic node for type: ", prim_type, " prim: ", prim_name);
+        node = generic;
+    }
+    
+    // Add the node to the parent
+    if (node) {
+        p_parent->add_child(node);
+        
+        // Set the owner for proper serialization
+        if (p_owner) {
+            node->set_owner(p_owner);
+        } else {
+            // Without an owner, share the parent's
+            node->set_owner(p_parent->get_owner());
+        }
+        for (int i = 0; i < node->get_child_count(); i++) {
+            node->get_child(i)->set_owner(node->get_owner());
+        }
+        if (p_sync) {
+            p_sync->bind_node(p_prim.GetPath(), node);
+        }
+        
+        // Process children
+        if (convert_children) {
+            for (UsdPrim child : p_prim.GetChildren()) {
+                convert_prim(child, node, p_owner, p_mesh_helper, p_instance_helper, p_sync);
+            }
+        }
+    }
+    
+    return node;
+}
+
+Node3D *UsdGroupReflector::reflect(const String &p_file_path, Node *p_parent, const String &p_group_name) {
+    if (!p_parent) {
+        UtilityFunctions::printerr("USD Import: No parent node to reflect ", p_file_path, " into");
+        return nullptr;
+    }
+    _sync.reset();
+    _group_name = p_group_name;
+    _mesh_count = 0;
+    _disk_cache_hits = 0;
+    _disk_cache_path = String();
+
+    // The stage shares its layers with UsdStageManager, which the MCP
+    // thread edits; keep it out until the group is built
+    std::unique_lock<std::recursive_mutex> layers_lock = usd_godot::UsdStageManager::get_singleton().lock_layers();
+
+    try {
+        // Open the USD stage
+        String abs_path = p_file_path;
+        if (p_file_path.begins_with("res://") || p_file_path.begins_with("user://")) {
+            abs_path = ProjectSettings::get_singleton()->globalize_path(p_file_path);
+        }
+        UsdStageRefPtr stage = UsdStage::Open(abs_path.utf8().get_data());
+        if (!stage) {
+            UtilityFunctions::printerr("USD Import: Failed to open USD stage from ", p_file_path);
+            return nullptr;
+        }
+
+        // Get the default prim
+        UsdPrim default_prim = stage->GetDefaultPrim();
+        if (!default_prim) {
+            default_prim = stage->GetPseudoRoot();
+        }
+
+        // Create a parent node for the imported hierarchy and add it to
+        // the tree before converting, so children can take its owner
+        Node *owner = p_parent->get_owner() ? p_parent->get_owner() : p_parent;
+        Node3D *group_root = memnew(Node3D);
+        group_root->set_name(p_group_name);
+        p_parent->add_child(group_root);
+        group_root->set_owner(owner);
+
+        // One mesh helper for the whole group, so identical meshes become
+        // one resource
+        UsdMeshImportHelper mesh_helper;
+        UsdInstanceImportHelper instance_helper(mesh_helper);
+
+        // Reflecting an unchanged file loads converted meshes from user://
+        UsdMeshDiskCache disk_cache;
+        if (disk_cache.open(stage, mesh_helper.get_options())) {
+            mesh_helper.set_disk_cache(&disk_cache);
+            _disk_cache_path = disk_cache.get_cache_path();
+        }
+
+        // Remember which node each prim became for incremental syncs
+        _sync = std::make_unique<UsdGroupSync>(stage, p_file_path, group_root);
+        convert_prim(default_prim, group_root, owner, mesh_helper, instance_helper, _sync.get());
+        _sync->set_has_instance_groups(instance_helper.has_instances());
+        instance_helper.build_instance_groups(group_root, owner);
+        mesh_helper.print_stats();
+        disk_cache.save();
+        _mesh_count = mesh_helper.get_stats().mesh_count;
+        _disk_cache_hits = mesh_helper.get_stats().disk_cache_hits;
+
+        _AddToGroupRecursive(group_root, p_group_name);
+        return group_root;
+    } catch (const std::exception &e) {
+        UtilityFunctions::printerr("USD Import: Exception occurred: ", e.what());
+        _sync.reset();
+        return nullptr;
+    }
+}
+
+// Apply the changes collected since the last reflect to the group.
+// Returns false when the group has to be rebuilt instead.
+bool UsdGroupReflector::sync() {
+    if (!_sync) {
+        return false;
+    }
+    UsdGroupSync &sync = *_sync;
+    Node *group_root = sync.get_group_root();
+    if (!group_root || !group_root->is_inside_tree()) {
+        return false;
+    }
+    // New nodes join the scene the group root was saved with
+    Node *owner = group_root->get_owner() ? group_root->get_owner() : group_root;
+
+    // Every read below goes to layers the MCP thread may be editing
+    std::unique_lock<std::recursive_mutex> layers_lock = usd_godot::UsdStageManager::get_singleton().lock_layers();
+
+    const uint64_t start_usec = Time::get_singleton()->get_ticks_usec();
+    sync.reload_layers();
+    UsdGroupSync::Changes changes = sync.take_changes();
+    _change_count = (int64_t)(changes.resynced.size() + changes.changed_info.size());
+    _rebuilt_count = 0;
+    _updated_count = 0;
+    _sync_usec = 0;
+    _latency_usec = 0;
+    if (changes.empty()) {
+        return true;
+    }
+
+    const UsdStageRefPtr &stage = sync.get_stage();
+    const SdfPath &import_root = sync.get_import_root();
+
+    // Property-level resyncs (properties added or removed) are value changes
+    // as far as nodes are concerned; prim resyncs rebuild that prim's nodes
+    SdfPathSet resynced_prims;
+    for (const SdfPath &path : changes.resynced) {
+        if (path.IsPropertyPath()) {
+            changes.changed_info.insert(path);
+        } else {
+            // A resync of the pseudo-root (e.g. a reloaded layer) rebuilds
+            // everything that was imported
+            resynced_prims.insert(path.HasPrefix(import_root) ? path : import_root);
+        }
+    }
+
+    UsdMeshImportHelper mesh_helper;
+    UsdInstanceImportHelper instance_helper(mesh_helper);
+    UsdTransformBatch transforms;
+    int64_t rebuilt_count = 0;
+    int64_t updated_count = 0;
+
+    // Rebuild resynced prims. SdfPathSet is sorted, so an ancestor comes
+    // before its descendants and covers them.
+    SdfPath last_rebuilt;
+    for (const SdfPath &path : resynced_prims) {
+        if (!last_rebuilt.IsEmpty() && path.HasPrefix(last_rebuilt)) {
+            continue;
+        }
+        if (!path.HasPrefix(import_root) || path == SdfPath::AbsoluteRootPath()) {
+            continue;
+        }
+        last_rebuilt = path;
+
+        UsdPrim prim = stage->GetPrimAtPath(path);
+        if (sync.has_instance_groups() || (prim && _SubtreeHasInstances(prim))) {
+            return false;
+        }
+
+        // Replace the old nodes in place, keeping the sibling order
+        Node *old_node = sync.get_node(path);
+        Node *parent = old_node ? old_node->get_parent() : sync.get_node(path.GetParentPath());
+        if (!parent) {
+            // Parent was not imported either (e.g. a Material scope); the
+            // nearest imported ancestor's rebuild covers this prim
+            if (!prim || stage->GetPrimAtPath(path.GetParentPath())) {
+                continue;
+            }
+            return false;
+        }
+        int index = -1;
+        if (old_node) {
+            index = old_node->get_index();
+            parent->remove_child(old_node);
+            old_node->queue_free();
+        }
+        sync.unbind_subtree(path);
+
+        if (prim && prim.IsActive()) {
+            Node *node = convert_prim(prim, parent, owner, mesh_helper, instance_helper, &sync);
+            if (node) {
+                if (index >= 0) {
+                    parent->move_child(node, index);
+                }
+                _AddToGroupRecursive(node, _group_name);
+            }
+        }
+        rebuilt_count++;
+    }
+
+    // Update property values on the nodes that show them
+    SdfPathSet transformed_prims;
+    for (const SdfPath &path : changes.changed_info) {
+        const SdfPath prim_path = path.GetPrimPath();
+        if (!prim_path.HasPrefix(import_root) || (!last_rebuilt.IsEmpty() && prim_path.HasPrefix(last_rebuilt)) ||
+                resynced_prims.count(prim_path)) {
+            continue;
+        }
+        if (!path.IsPropertyPath()) {
+            // Prim metadata; anything that changes composition arrives as
+            // a resync instead
+            continue;
+        }
+
+        UsdPrim prim = stage->GetPrimAtPath(prim_path);
+        if (!prim) {
+            continue;
+        }
+
+        // Instance MultiMeshes hold world transforms of their own, and
+        // instances have no node to update
+        const TfToken &name = path.GetNameToken();
+        const bool transform_changed = UsdGeomXformable::IsTransformationAffectedByAttrNamed(name);
+        if (transform_changed && sync.has_instance_groups() && _SubtreeHasInstances(prim)) {
+            return false;
+        }
+
+        Node *node = sync.get_node(prim_path);
+        if (!node) {
+            continue;
+        }
+
+        if (transform_changed) {
+            // Applied together once every change is known; a prim with
+            // several changed xformOps is only evaluated once
+            Node3D *node_3d = Object::cast_to<Node3D>(node);
+            if (node_3d && transformed_prims.insert(prim_path).second) {
+                transforms.add(prim, node_3d);
+            }
+        } else if (prim.IsA<UsdGeomPointInstancer>()) {
+            // Instancer attributes feed every prototype's MultiMesh
+            Node *parent = node->get_parent();
+            const int index = node->get_index();
+            parent->remove_child(node);
+            node->queue_free();
+            sync.unbind_subtree(prim_path);
+            Node *rebuilt = convert_prim(prim, parent, owner, mesh_helper, instance_helper, &sync);
+            if (rebuilt) {
+                parent->move_child(rebuilt, index);
+                _AddToGroupRecursive(rebuilt, _group_name);
+            }
+        } else if (MeshInstance3D *mesh_instance = Object::cast_to<MeshInstance3D>(node)) {
+            // Geometry or display attributes of a gprim
+            Ref<Mesh> mesh = mesh_helper.import_mesh_from_prim(prim);
+            if (mesh.is_valid()) {
+                mesh_instance->set_mesh(mesh);
+                for (int surface = 0; surface < mesh->get_surface_count(); surface++) {
+                    Ref<Material> material = mesh_helper.get_surface_material(prim, mesh, surface);
+                    if (material.is_valid()) {
+                        mesh_instance->set_surface_override_material(surface, material);
+                    }
+                }
+            }
+        } else {
+            // No Godot counterpart for this property
+            continue;
+        }
+        updated_count++;
+    }
+
+    transforms.update(UsdTimeCode::Default());
+
+    _rebuilt_count = rebuilt_count;
+    _updated_count = updated_count;
+    _sync_usec = (int64_t)(Time::get_singleton()->get_ticks_usec() - start_usec);
+    _latency_usec = usd_godot::UsdChangeListener::now_usec() - changes.first_change_usec;
+    return true;
+}
+
+bool UsdGroupReflector::is_reflected() const {
+    return _sync && _sync->get_group_root();
+}
+
+bool UsdGroupReflector::has_pending_changes() const {
+    return _sync && _sync->has_pending_changes();
+}
+
+Node3D *UsdGroupReflector::get_group_root() const {
+    return _sync ? Object::cast_to<Node3D>(_sync->get_group_root()) : nullptr;
+}
+
+String UsdGroupReflector::get_file_path() const {
+    return _sync ? _sync->get_file_path() : String();
+}
+
+String UsdGroupReflector::get_group_name() const {
+    return _group_name;
+}
+
+Dictionary UsdGroupReflector::get_sync_stats() const {
+    Dictionary stats;
+    stats["change_count"] = _change_count;
+    stats["rebuilt_count"] = _rebuilt_count;
+    stats["updated_count"] = _updated_count;
+    stats["sync_usec"] = _sync_usec;
+    stats["latency_usec"] = _latency_usec;
+    return stats;
+}
+
+Dictionary UsdGroupReflector::get_reflect_stats() const {
+    Dictionary stats;
+    stats["mesh_count"] = _mesh_count;
+    stats["disk_cache_hits"] = _disk_cache_hits;
+    stats["disk_cache_path"] = _disk_cache_path;
+    return stats;
+}
+
+} // namespace godot
@@ -0,0 +1,116 @@
+#ifndef USD_GROUP_REFLECTOR_H
+#define USD_GROUP_REFLECTOR_H
+
+#include "usd_group_sync.h"
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+// USD headers
+#include <pxr/usd/usd/prim.h>
+
+#include <memory>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+class UsdMeshImportHelper;
+class UsdInstanceImportHelper;
+
+/**
+ * UsdGroupReflector - Reflects a USD file into a scene group and keeps it
+ * up to date with edits to the stage.
+ *
+ * reflect() converts the stage's default prim into a Node3D named after
+ * the group, the way the editor's Reflect button does, and remembers which
+ * node every prim became. sync() then applies only the edits made since
+ * the previous call: resynced prims are rebuilt in place (keeping their
+ * sibling order), xformOp edits update transforms, gprim attributes
+ * re-import the mesh and point instancer attributes rebuild the instancer.
+ * Nodes of untouched prims are kept as they are. When an edit reaches
+ * prims merged into instance MultiMeshes, sync() returns false and the
+ * group has to be reflected again.
+ *
+ * The editor plugin keeps one reflector per group and calls sync() once
+ * per frame while edits arrive.
+ *
+ * Example GDScript usage:
+ *   var reflector = UsdGroupReflector.new()
+ *   reflector.reflect("res://scene.usda", self, "my_group")
+ *   var stage = UsdStageProxy.new()
+ *   stage.open("res://scene.usda")
+ *   stage.set_prim_transform("/Root/Cube", 1, 0, 0, 0, 0, 0, 1, 1, 1)
+ *   reflector.sync()
+ */
+class UsdGroupReflector : public RefCounted {
+    GDCLASS(UsdGroupReflector, RefCounted);
+
+private:
+    std::unique_ptr<UsdGroupSync> _sync;
+    String _group_name;
+
+    // What the last sync() did
+    int64_t _change_count = 0;
+    int64_t _rebuilt_count = 0;
+    int64_t _updated_count = 0;
+    int64_t _sync_usec = 0;
+    int64_t _latency_usec = 0;
+
+    // What the last reflect() did
+    int64_t _mesh_count = 0;
+    int64_t _disk_cache_hits = 0;
+    String _disk_cache_path;
+
+    static bool _apply_transform(const UsdPrim &p_prim, Node3D *p_node);
+
+protected:
+    static void _bind_methods();
+
+public:
+    UsdGroupReflector();
+    ~UsdGroupReflector();
+
+    /// Convert p_prim and its descendants into nodes under p_parent, owned
+    /// by p_owner (or p_parent's owner if null). Instances are handed to
+    /// p_instance_helper; with p_sync, every node is bound to its prim.
+    static Node *convert_prim(const UsdPrim &p_prim, Node *p_parent, Node *p_owner,
+            UsdMeshImportHelper &p_mesh_helper, UsdInstanceImportHelper &p_instance_helper,
+            UsdGroupSync *p_sync = nullptr);
+
+    /// Open p_file_path and convert it into a new group root under
+    /// p_parent. Every node joins the scene group p_group_name. Returns the
+    /// group root, or null if the stage could not be opened.
+    Node3D *reflect(const String &p_file_path, Node *p_parent, const String &p_group_name);
+
+    /// Apply the edits made since the last reflect or sync. Returns false
+    /// if the group has to be reflected again instead.
+    bool sync();
+
+    bool is_reflected() const;
+    bool has_pending_changes() const;
+
+    Node3D *get_group_root() const;
+    String get_file_path() const;
+    String get_group_name() const;
+
+    /// What the last sync() did: "change_count" (changed paths),
+    /// "rebuilt_count" (prims rebuilt), "updated_count" (properties applied
+    /// to nodes), "sync_usec" (time spent in sync) and "latency_usec"
+    /// (from the first edit of the batch to the end of the sync).
+    Dictionary get_sync_stats() const;
+
+    /// What the last reflect() did: "mesh_count" (UsdGeomMeshes converted
+    /// or loaded), "disk_cache_hits" (meshes loaded from the mesh disk
+    /// cache) and "disk_cache_path" (empty if the stage can't be cached).
+    Dictionary get_reflect_stats() const;
+
+    /// Prim to node mapping and bounds, for C++ callers
+    UsdGroupSync *get_group_sync() const { return _sync.get(); }
+};
+
+} // namespace godot
+
+#endif // USD_GROUP_REFLECTOR_H
@@ -0,0 +1,84 @@
+#include "usd_group_sync.h"
+#include <godot_cpp/core/object.hpp>
+
+#include <pxr/usd/sdf/layer.h>
+
+namespace godot {
+
+UsdGroupSync::UsdGroupSync(const UsdStageRefPtr &p_stage, const String &p_file_path, Node *p_group_root) :
+        _stage(p_stage),
+        _file_path(p_file_path),
+        _group_root(p_group_root->get_instance_id()) {
+    UsdPrim default_prim = _stage->GetDefaultPrim();
+    _import_root = default_prim ? default_prim.GetPath() : SdfPath::AbsoluteRootPath();
+
+    // Prims under the pseudo-root are parented to the group root
+    bind_node(SdfPath::AbsoluteRootPath(), p_group_root);
+
+    _listener.attach(_stage);
+}
+
+UsdGroupSync::~UsdGroupSync() {
+    _listener.detach();
+}
+
+Node *UsdGroupSync::get_group_root() const {
+    return Object::cast_to<Node>(ObjectDB::get_instance(_group_root));
+}
+
+void UsdGroupSync::bind_node(const SdfPath &p_prim_path, Node *p_node) {
+    _nodes[p_prim_path] = p_node->get_instance_id();
+}
+
+Node *UsdGroupSync::get_node(const SdfPath &p_prim_path) const {
+    auto found = _nodes.find(p_prim_path);
+    if (found == _nodes.end()) {
+        return nullptr;
+    }
+    return Object::cast_to<Node>(ObjectDB::get_instance(found->second));
+}
+
+SdfPath UsdGroupSync::get_prim_path(const Node *p_node) const {
+    if (!p_node) {
+        return SdfPath();
+    }
+    const uint64_t instance_id = p_node->get_instance_id();
+    for (const std::pair<const SdfPath, uint64_t> &entry : _nodes) {
+        if (entry.second == instance_id) {
+            return entry.first;
+        }
+    }
+    return SdfPath();
+}
+
+void UsdGroupSync::unbind_subtree(const SdfPath &p_prim_path) {
+    // Descendants sort directly after their ancestor
+    auto range = SdfPathFindPrefixedRange(_nodes.begin(), _nodes.end(), p_prim_path,
+            [](const std::pair<const SdfPath, uint64_t> &p_entry) -> const SdfPath & { return p_entry.first; });
+    _nodes.erase(range.first, range.second);
+}
+
+void UsdGroupSync::reload_layers() {
+    for (const SdfLayerHandle &layer : _stage->GetUsedLayers()) {
+        if (!layer->IsAnonymous() && !layer->IsDirty()) {
+            // Only reloads if the file changed on disk
+            layer->Reload();
+        }
+    }
+}
+
+UsdGroupSync::Changes UsdGroupSync::take_changes() {
+    Changes changes;
+    _listener.take_changes(&changes);
+    return changes;
+}
+
+usd_godot::UsdBoundsHierarchy *UsdGroupSync::get_bounds_hierarchy() {
+    if (!_bounds) {
+        _bounds = std::make_unique<usd_godot::UsdBoundsHierarchy>(_stage);
+    }
+    _bounds->update();
+    return _bounds.get();
+}
+
+} // namespace godot
@@ -0,0 +1,86 @@
+#ifndef USD_GROUP_SYNC_H
+#define USD_GROUP_SYNC_H
+
+#include "usd_bounds_hierarchy.h"
+#include "usd_change_listener.h"
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+// USD headers
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/sdf/path.h>
+
+#include <map>
+#include <memory>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// State kept for a scene group after it has been reflected from a USD
+// stage, so the next reflect can apply only what changed.
+//
+// The stage stays open and a UsdChangeListener collects changed paths as
+// edits arrive (from MCP, GDScript or a layer reload).
+// Every prim that produced a node is mapped to that node, so a change can
+// be applied to exactly the nodes it affects.
+class UsdGroupSync {
+public:
+    using Changes = usd_godot::StageChanges;
+
+    UsdGroupSync(const UsdStageRefPtr &p_stage, const String &p_file_path, Node *p_group_root);
+    ~UsdGroupSync();
+
+    const UsdStageRefPtr &get_stage() const { return _stage; }
+    const String &get_file_path() const { return _file_path; }
+
+    // Group root node, or nullptr if it has been freed
+    Node *get_group_root() const;
+
+    // Root of the imported prims: the default prim, or the pseudo-root
+    const SdfPath &get_import_root() const { return _import_root; }
+
+    // Instanceable prims are merged into MultiMeshes that no single prim
+    // maps to; changes reaching them need a full rebuild
+    void set_has_instance_groups(bool p_has_instance_groups) { _has_instance_groups = p_has_instance_groups; }
+    bool has_instance_groups() const { return _has_instance_groups; }
+
+    // Prim to node mapping
+    void bind_node(const SdfPath &p_prim_path, Node *p_node);
+    Node *get_node(const SdfPath &p_prim_path) const;
+
+    // Prim that produced p_node, or an empty path if it was not mapped
+    SdfPath get_prim_path(const Node *p_node) const;
+
+    // Forget p_prim_path and every prim below it
+    void unbind_subtree(const SdfPath &p_prim_path);
+
+    // Reload layers that changed on disk. Layers with unsaved edits are
+    // left alone so in-memory changes are not discarded.
+    void reload_layers();
+
+    // Paths changed since the last call
+    bool has_pending_changes() const { return _listener.has_changes(); }
+    Changes take_changes();
+
+    // World-space prim bounds in stage space, i.e. relative to the group
+    // root. Built on first use and updated from its own change listener,
+    // so it does not consume the changes take_changes() reports.
+    usd_godot::UsdBoundsHierarchy *get_bounds_hierarchy();
+
+private:
+    UsdStageRefPtr _stage;
+    String _file_path;
+    uint64_t _group_root; // instance ID
+    SdfPath _import_root;
+    bool _has_instance_groups = false;
+
+    std::map<SdfPath, uint64_t> _nodes; // prim path -> node instance ID
+
+    usd_godot::UsdChangeListener _listener;
+    std::unique_ptr<usd_godot::UsdBoundsHierarchy> _bounds;
+};
+
+} // namespace godot
+
+#endif // USD_GROUP_SYNC_H
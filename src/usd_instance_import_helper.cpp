@@ -0,0 +1,220 @@
+#include "usd_instance_import_helper.h"
+#include "usd_mesh_import_helper.h"
+#include "usd_parallel.h"
+#include "usd_transform_batch.h"
+#include <godot_cpp/classes/array_mesh.hpp>
+#include <godot_cpp/classes/multi_mesh.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/gprim.h>
+
+#include <algorithm>
+
+namespace godot {
+
+UsdInstanceImportHelper::UsdInstanceImportHelper(UsdMeshImportHelper &p_mesh_helper) :
+        _mesh_helper(p_mesh_helper) {
+}
+
+bool UsdInstanceImportHelper::_build_prototype_mesh(const UsdPrim &p_prototype, PrototypeMesh *r_prototype) {
+    // Every gprim under the prototype, including ones inside nested
+    // instances. Nested point instancers are not expanded.
+    std::vector<UsdPrim> gprims;
+    UsdPrimRange range(p_prototype, UsdTraverseInstanceProxies());
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        if (it->IsA<UsdGeomPointInstancer>()) {
+            it.PruneChildren();
+        } else if (it->IsA<UsdGeomGprim>()) {
+            gprims.push_back(*it);
+        }
+    }
+    if (gprims.empty()) {
+        return false;
+    }
+
+    bool resets_xform_stack = false;
+
+    // A single gprim keeps its (possibly shared) mesh resource; its offset
+    // from the prototype root is folded into the instance transforms.
+    // Meshes split by GeomSubsets need a material per surface, so they
+    // go through the merge below instead of a material override.
+    Ref<Mesh> single_mesh;
+    if (gprims.size() == 1) {
+        single_mesh = _mesh_helper.import_mesh_from_prim(gprims[0]);
+        if (single_mesh.is_null() || single_mesh->get_surface_count() <= 1) {
+            r_prototype->mesh = single_mesh;
+            r_prototype->local = _xform_cache.ComputeRelativeTransform(gprims[0], p_prototype, &resets_xform_stack);
+            r_prototype->material_override = _mesh_helper.get_material(gprims[0]);
+            return r_prototype->mesh.is_valid();
+        }
+    }
+
+    // Otherwise gprims are merged into one ArrayMesh, one surface per
+    // source surface, baked into the prototype root's space
+    Ref<ArrayMesh> merged;
+    merged.instantiate();
+    for (const UsdPrim &gprim : gprims) {
+        Ref<Mesh> mesh = single_mesh.is_valid() ? single_mesh : _mesh_helper.import_mesh_from_prim(gprim);
+        if (mesh.is_null()) {
+            continue;
+        }
+        const Transform3D xform = UsdTransformBatch::to_transform(_xform_cache.ComputeRelativeTransform(gprim, p_prototype, &resets_xform_stack));
+        const Basis normal_basis = xform.basis.inverse().transposed();
+        for (int32_t surface = 0; surface < mesh->get_surface_count(); ++surface) {
+            Ref<Material> material = _mesh_helper.get_surface_material(gprim, mesh, surface);
+            Array arrays = mesh->surface_get_arrays(surface);
+
+            PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+            Vector3 *vertex_data = vertices.ptrw();
+            for (int64_t i = 0; i < vertices.size(); ++i) {
+                vertex_data[i] = xform.xform(vertex_data[i]);
+            }
+            arrays[Mesh::ARRAY_VERTEX] = vertices;
+
+            PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
+            Vector3 *normal_data = normals.ptrw();
+            for (int64_t i = 0; i < normals.size(); ++i) {
+                normal_data[i] = normal_basis.xform(normal_data[i]).normalized();
+            }
+            arrays[Mesh::ARRAY_NORMAL] = normals;
+
+            // Primitive meshes carry tangents that no longer match once baked
+            arrays[Mesh::ARRAY_TANGENT] = Variant();
+
+            merged->add_surface_from_arrays(mesh->surface_get_primitive_type(surface), arrays);
+            if (material.is_valid()) {
+                merged->surface_set_material(merged->get_surface_count() - 1, material);
+            }
+        }
+    }
+
+    r_prototype->mesh = merged;
+    return merged->get_surface_count() > 0;
+}
+
+MultiMeshInstance3D *UsdInstanceImportHelper::_create_multimesh_instance(const String &p_name, const PrototypeMesh &p_prototype,
+        const GfMatrix4d *p_transforms, size_t p_count) {
+    // MultiMesh 3D buffer layout: the three basis rows, each followed by
+    // the matching origin component. USD matrices are row-vector, so
+    // Godot's basis row r is column r of the upper 3x3.
+    PackedFloat32Array buffer;
+    buffer.resize(p_count * 12);
+    float *dst = buffer.ptrw();
+    const GfMatrix4d local = p_prototype.local;
+    const int thread_count = UsdParallel::resolve_thread_count(_mesh_helper.get_options().thread_count);
+    UsdParallel::for_range(p_count, p_count >= 4096 ? thread_count : 1, [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t i = p_begin; i < p_end; ++i) {
+            const GfMatrix4d m = local * p_transforms[i];
+            float *out = dst + i * 12;
+            for (int r = 0; r < 3; ++r) {
+                out[r * 4 + 0] = (float)m[0][r];
+                out[r * 4 + 1] = (float)m[1][r];
+                out[r * 4 + 2] = (float)m[2][r];
+                out[r * 4 + 3] = (float)m[3][r];
+            }
+        }
+    });
+
+    Ref<MultiMesh> multimesh;
+    multimesh.instantiate();
+    multimesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+    multimesh->set_mesh(p_prototype.mesh);
+    multimesh->set_instance_count(p_count);
+    multimesh->set_buffer(buffer);
+
+    MultiMeshInstance3D *instance = memnew(MultiMeshInstance3D);
+    instance->set_name(p_name);
+    instance->set_multimesh(multimesh);
+    if (p_prototype.material_override.is_valid()) {
+        instance->set_material_override(p_prototype.material_override);
+    }
+
+    _instance_count += p_count;
+    _multimesh_count++;
+    return instance;
+}
+
+Node3D *UsdInstanceImportHelper::import_point_instancer(const UsdGeomPointInstancer &p_instancer) {
+    Node3D *node = memnew(Node3D);
+    node->set_name(String(p_instancer.GetPrim().GetName().GetText()));
+
+    const UsdTimeCode time = UsdTimeCode::Default();
+
+    // Per-instance transforms, including each prototype root's own
+    // transform. The mask is applied below so indices stay aligned with
+    // protoIndices.
+    VtArray<GfMatrix4d> transforms;
+    if (!p_instancer.ComputeInstanceTransformsAtTime(&transforms, time, time,
+                UsdGeomPointInstancer::IncludeProtoXform, UsdGeomPointInstancer::IgnoreMask)) {
+        UtilityFunctions::printerr("USD Import: Failed to compute instance transforms for ", String(p_instancer.GetPath().GetText()));
+        return node;
+    }
+
+    VtArray<int> proto_indices;
+    p_instancer.GetProtoIndicesAttr().Get(&proto_indices, time);
+    SdfPathVector prototype_paths;
+    p_instancer.GetPrototypesRel().GetForwardedTargets(&prototype_paths);
+    const std::vector<bool> mask = p_instancer.ComputeMaskAtTime(time);
+
+    // Bucket transforms by prototype
+    std::vector<std::vector<GfMatrix4d>> buckets(prototype_paths.size());
+    const size_t instance_count = std::min(transforms.size(), proto_indices.size());
+    for (size_t i = 0; i < instance_count; ++i) {
+        const int proto = proto_indices[i];
+        if (proto < 0 || (size_t)proto >= prototype_paths.size() || (!mask.empty() && !mask[i])) {
+            continue;
+        }
+        buckets[proto].push_back(transforms[i]);
+    }
+
+    UsdStagePtr stage = p_instancer.GetPrim().GetStage();
+    for (size_t proto = 0; proto < prototype_paths.size(); ++proto) {
+        if (buckets[proto].empty()) {
+            continue;
+        }
+        UsdPrim prototype = stage->GetPrimAtPath(prototype_paths[proto]);
+        PrototypeMesh prototype_mesh;
+        if (!prototype || !_build_prototype_mesh(prototype, &prototype_mesh)) {
+            UtilityFunctions::printerr("USD Import: Point instancer prototype has no geometry: ", String(prototype_paths[proto].GetText()));
+            continue;
+        }
+        node->add_child(_create_multimesh_instance(String(prototype.GetName().GetText()), prototype_mesh,
+                buckets[proto].data(), buckets[proto].size()));
+    }
+
+    return node;
+}
+
+void UsdInstanceImportHelper::add_instance(const UsdPrim &p_instance) {
+    UsdPrim prototype = p_instance.GetPrototype();
+    if (prototype) {
+        _instances[prototype.GetPath()].push_back(p_instance);
+    }
+}
+
+void UsdInstanceImportHelper::build_instance_groups(Node *p_parent, Node *p_owner) {
+    for (const auto &entry : _instances) {
+        const std::vector<UsdPrim> &instances = entry.second;
+        UsdPrim prototype = instances.front().GetPrototype();
+
+        PrototypeMesh prototype_mesh;
+        if (!_build_prototype_mesh(prototype, &prototype_mesh)) {
+            continue;
+        }
+
+        std::vector<GfMatrix4d> transforms(instances.size());
+        for (size_t i = 0; i < instances.size(); ++i) {
+            transforms[i] = _xform_cache.GetLocalToWorldTransform(instances[i]);
+        }
+
+        // Named after the first instance; prototype names are generated
+        String name = String(instances.front().GetName().GetText()) + "_instances";
+        MultiMeshInstance3D *node = _create_multimesh_instance(name, prototype_mesh, transforms.data(), transforms.size());
+        p_parent->add_child(node);
+        node->set_owner(p_owner);
+    }
+    _instances.clear();
+}
+
+} // namespace godot
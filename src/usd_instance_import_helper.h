@@ -0,0 +1,84 @@
+#ifndef USD_INSTANCE_IMPORT_HELPER_H
+#define USD_INSTANCE_IMPORT_HELPER_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/mesh.hpp>
+#include <godot_cpp/classes/multi_mesh_instance3d.hpp>
+
+// USD headers
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usdGeom/pointInstancer.h>
+#include <pxr/usd/usdGeom/xformCache.h>
+#include <pxr/base/gf/matrix4d.h>
+
+#include <map>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+class UsdMeshImportHelper;
+
+// Imports USD instancing as MultiMeshInstance3D nodes instead of one node
+// per instance:
+//
+// - UsdGeomPointInstancer: one MultiMeshInstance3D per prototype under the
+//   instancer's node, filled from ComputeInstanceTransformsAtTime.
+// - Instanceable prims (native instancing): the hierarchy walk hands each
+//   instance to add_instance() instead of expanding it, and
+//   build_instance_groups() then creates one MultiMeshInstance3D per
+//   prototype with every instance's world transform.
+//
+// Prototype geometry goes through the shared UsdMeshImportHelper, so it
+// is deduplicated like any other mesh. Transforms go to the MultiMesh as
+// a single bulk buffer.
+class UsdInstanceImportHelper {
+public:
+    explicit UsdInstanceImportHelper(UsdMeshImportHelper &p_mesh_helper);
+
+    // Node for a point instancer. Its prototypes are imported as
+    // MultiMeshInstance3D children, so callers must not also walk the
+    // instancer's children.
+    Node3D *import_point_instancer(const UsdGeomPointInstancer &p_instancer);
+
+    // Record an instanceable prim for build_instance_groups
+    void add_instance(const UsdPrim &p_instance);
+    bool has_instances() const { return !_instances.empty(); }
+
+    // Create a MultiMeshInstance3D per collected prototype under p_parent,
+    // whose space must be the stage's world space. Clears the collected
+    // instances.
+    void build_instance_groups(Node *p_parent, Node *p_owner);
+
+    int64_t get_instance_count() const { return _instance_count; }
+    int64_t get_multimesh_count() const { return _multimesh_count; }
+
+private:
+    // Geometry of one prototype, expressed in the prototype root's space
+    // once p_local is applied
+    struct PrototypeMesh {
+        Ref<Mesh> mesh;
+        Ref<Material> material_override;
+        GfMatrix4d local = GfMatrix4d(1.0);
+    };
+
+    UsdMeshImportHelper &_mesh_helper;
+    UsdGeomXformCache _xform_cache;
+
+    // Instanceable prims by prototype path; std::map keeps node order stable
+    std::map<SdfPath, std::vector<UsdPrim>> _instances;
+
+    int64_t _instance_count = 0;
+    int64_t _multimesh_count = 0;
+
+    bool _build_prototype_mesh(const UsdPrim &p_prototype, PrototypeMesh *r_prototype);
+    MultiMeshInstance3D *_create_multimesh_instance(const String &p_name, const PrototypeMesh &p_prototype,
+            const GfMatrix4d *p_transforms, size_t p_count);
+};
+
+} // namespace godot
+
+#endif // USD_INSTANCE_IMPORT_HELPER_H
@@ -0,0 +1,155 @@
+#include "usd_layer_writer.h"
+
+// USD headers
+#include <pxr/usd/sdf/attributeSpec.h>
+#include <pxr/usd/sdf/primSpec.h>
+#include <pxr/usd/sdf/reference.h>
+#include <pxr/usd/sdf/relationshipSpec.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/sdf/listOp.h>
+#include <pxr/usd/usd/tokens.h>
+#include <pxr/usd/usdGeom/tokens.h>
+
+#include <algorithm>
+
+namespace godot {
+
+UsdLayerWriter::UsdLayerWriter(const SdfLayerHandle &p_layer) :
+        _layer(p_layer) {
+}
+
+bool UsdLayerWriter::define_prim(const SdfPath &p_path, const TfToken &p_type_name, SdfSpecifier p_specifier) {
+    SdfPrimSpecHandle prim = _layer->GetPrimAtPath(p_path);
+    if (!prim) {
+        SdfPrimSpecHandle parent = _layer->GetPrimAtPath(p_path.GetParentPath());
+        if (!parent) {
+            return false;
+        }
+        prim = SdfPrimSpec::New(parent, p_path.GetName(), p_specifier, p_type_name.GetString());
+        return (bool)prim;
+    }
+    prim->SetSpecifier(p_specifier);
+    prim->SetTypeName(p_type_name.GetString());
+    return true;
+}
+
+bool UsdLayerWriter::override_prim(const SdfPath &p_path) {
+    if (_layer->GetPrimAtPath(p_path)) {
+        return true;
+    }
+    SdfPrimSpecHandle parent = _layer->GetPrimAtPath(p_path.GetParentPath());
+    if (!parent) {
+        return false;
+    }
+    return (bool)SdfPrimSpec::New(parent, p_path.GetName(), SdfSpecifierOver);
+}
+
+bool UsdLayerWriter::add_internal_reference(const SdfPath &p_prim_path, const SdfPath &p_target_path) {
+    SdfPrimSpecHandle prim = _layer->GetPrimAtPath(p_prim_path);
+    if (!prim) {
+        return false;
+    }
+    prim->GetReferenceList().Prepend(SdfReference(std::string(), p_target_path));
+    return true;
+}
+
+SdfAttributeSpecHandle UsdLayerWriter::_get_or_create_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+        SdfVariability p_variability) {
+    SdfAttributeSpecHandle attribute = _layer->GetAttributeAtPath(p_prim_path.AppendProperty(p_name));
+    if (!attribute) {
+        SdfPrimSpecHandle prim = _layer->GetPrimAtPath(p_prim_path);
+        if (!prim) {
+            return SdfAttributeSpecHandle();
+        }
+        attribute = SdfAttributeSpec::New(prim, p_name.GetString(), p_type, p_variability);
+    }
+    return attribute;
+}
+
+bool UsdLayerWriter::declare_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+        SdfVariability p_variability) {
+    return (bool)_get_or_create_attribute(p_prim_path, p_name, p_type, p_variability);
+}
+
+bool UsdLayerWriter::set_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+        const VtValue &p_value, SdfVariability p_variability) {
+    SdfAttributeSpecHandle attribute = _get_or_create_attribute(p_prim_path, p_name, p_type, p_variability);
+    if (!attribute) {
+        return false;
+    }
+    return attribute->SetDefaultValue(p_value);
+}
+
+bool UsdLayerWriter::connect_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+        const SdfPath &p_source) {
+    SdfAttributeSpecHandle attribute = _get_or_create_attribute(p_prim_path, p_name, p_type, SdfVariabilityVarying);
+    if (!attribute) {
+        return false;
+    }
+    attribute->GetConnectionPathList().ClearEditsAndMakeExplicit();
+    attribute->GetConnectionPathList().GetExplicitItems() = SdfPathVector{ p_source };
+    return true;
+}
+
+bool UsdLayerWriter::set_primvar(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+        const VtValue &p_value, const TfToken &p_interpolation) {
+    return set_attribute(p_prim_path, p_name, p_type, p_value) &&
+            set_attribute_metadata(p_prim_path, p_name, UsdGeomTokens->interpolation, VtValue(p_interpolation));
+}
+
+bool UsdLayerWriter::set_attribute_metadata(const SdfPath &p_prim_path, const TfToken &p_name, const TfToken &p_key, const VtValue &p_value) {
+    SdfAttributeSpecHandle attribute = _layer->GetAttributeAtPath(p_prim_path.AppendProperty(p_name));
+    if (!attribute) {
+        return false;
+    }
+    attribute->SetInfo(p_key, p_value);
+    return true;
+}
+
+bool UsdLayerWriter::set_time_samples(const SdfPath &p_prim_path, const TfToken &p_name, SdfTimeSampleMap &p_samples) {
+    const SdfPath attribute_path = p_prim_path.AppendProperty(p_name);
+    if (!_layer->GetAttributeAtPath(attribute_path)) {
+        return false;
+    }
+    _layer->SetField(attribute_path, SdfFieldKeys->TimeSamples, VtValue::Take(p_samples));
+    return true;
+}
+
+bool UsdLayerWriter::set_xform_op_order(const SdfPath &p_prim_path, const VtArray<TfToken> &p_op_order) {
+    return set_attribute(p_prim_path, UsdGeomTokens->xformOpOrder, SdfValueTypeNames->TokenArray, VtValue(p_op_order), SdfVariabilityUniform);
+}
+
+bool UsdLayerWriter::apply_api_schema(const SdfPath &p_prim_path, const TfToken &p_schema) {
+    SdfPrimSpecHandle prim = _layer->GetPrimAtPath(p_prim_path);
+    if (!prim) {
+        return false;
+    }
+    SdfTokenListOp schemas = prim->GetInfo(UsdTokens->apiSchemas).GetWithDefault<SdfTokenListOp>();
+    SdfTokenListOp::ItemVector prepended = schemas.GetPrependedItems();
+    if (std::find(prepended.begin(), prepended.end(), p_schema) != prepended.end()) {
+        return true;
+    }
+    prepended.push_back(p_schema);
+    schemas.SetPrependedItems(prepended);
+    prim->SetInfo(UsdTokens->apiSchemas, VtValue(schemas));
+    return true;
+}
+
+bool UsdLayerWriter::set_relationship_targets(const SdfPath &p_prim_path, const TfToken &p_name, const SdfPathVector &p_targets) {
+    SdfRelationshipSpecHandle relationship = _layer->GetRelationshipAtPath(p_prim_path.AppendProperty(p_name));
+    if (!relationship) {
+        SdfPrimSpecHandle prim = _layer->GetPrimAtPath(p_prim_path);
+        if (!prim) {
+            return false;
+        }
+        relationship = SdfRelationshipSpec::New(prim, p_name.GetString());
+        if (!relationship) {
+            return false;
+        }
+    }
+    relationship->GetTargetPathList().ClearEditsAndMakeExplicit();
+    relationship->GetTargetPathList().GetExplicitItems() = p_targets;
+    return true;
+}
+
+} // namespace godot
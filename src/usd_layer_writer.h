@@ -0,0 +1,82 @@
+#ifndef USD_LAYER_WRITER_H
+#define USD_LAYER_WRITER_H
+
+// USD headers
+#include <pxr/usd/sdf/attributeSpec.h>
+#include <pxr/usd/sdf/layer.h>
+#include <pxr/usd/sdf/path.h>
+#include <pxr/usd/sdf/types.h>
+#include <pxr/usd/sdf/valueTypeName.h>
+#include <pxr/base/tf/token.h>
+#include <pxr/base/vt/array.h>
+#include <pxr/base/vt/value.h>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// Authors prims and properties straight into an SdfLayer.
+//
+// Nothing goes through a UsdStage, so there is no change processing or
+// recomposition per call, and a whole export can run inside one
+// SdfChangeBlock. Open a stage on the layer once authoring is done.
+class UsdLayerWriter {
+public:
+    explicit UsdLayerWriter(const SdfLayerHandle &p_layer);
+
+    const SdfLayerHandle &get_layer() const { return _layer; }
+
+    // Define p_path with the given schema type name ("Xform", "Mesh", ...).
+    // The parent must already exist in the layer.
+    bool define_prim(const SdfPath &p_path, const TfToken &p_type_name, SdfSpecifier p_specifier = SdfSpecifierDef);
+
+    // Typeless "over" for p_path, unless the layer already has a spec there
+    bool override_prim(const SdfPath &p_path);
+
+    // Prepend a reference to p_target_path in this layer
+    bool add_internal_reference(const SdfPath &p_prim_path, const SdfPath &p_target_path);
+
+    // Create the attribute if needed and set its default value. Array
+    // values share their buffer with the caller's VtArray.
+    bool set_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+            const VtValue &p_value, SdfVariability p_variability = SdfVariabilityVarying);
+
+    // Create the attribute without a value, e.g. a shader output
+    bool declare_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+            SdfVariability p_variability = SdfVariabilityVarying);
+
+    // Create the attribute if needed and make p_source (an attribute path,
+    // e.g. a shader output) its only connection
+    bool connect_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+            const SdfPath &p_source);
+
+    // Attribute plus primvar interpolation metadata
+    bool set_primvar(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+            const VtValue &p_value, const TfToken &p_interpolation);
+
+    // Metadata on an existing attribute (interpolation, colorSpace, ...)
+    bool set_attribute_metadata(const SdfPath &p_prim_path, const TfToken &p_name, const TfToken &p_key, const VtValue &p_value);
+
+    // Replace the attribute's time samples; p_samples is left empty
+    bool set_time_samples(const SdfPath &p_prim_path, const TfToken &p_name, SdfTimeSampleMap &p_samples);
+
+    // Uniform xformOpOrder for the prim's op stack
+    bool set_xform_op_order(const SdfPath &p_prim_path, const VtArray<TfToken> &p_op_order);
+
+    // Add p_schema (e.g. "MaterialBindingAPI") to the prim's prepended
+    // apiSchemas
+    bool apply_api_schema(const SdfPath &p_prim_path, const TfToken &p_schema);
+
+    // Create the relationship if needed and make p_targets its explicit targets
+    bool set_relationship_targets(const SdfPath &p_prim_path, const TfToken &p_name, const SdfPathVector &p_targets);
+
+private:
+    SdfLayerHandle _layer;
+
+    SdfAttributeSpecHandle _get_or_create_attribute(const SdfPath &p_prim_path, const TfToken &p_name, const SdfValueTypeName &p_type,
+            SdfVariability p_variability);
+};
+
+} // namespace godot
+
+#endif // USD_LAYER_WRITER_H
@@ -0,0 +1,227 @@
+#include "usd_material_export_helper.h"
+#include "usd_layer_writer.h"
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+// USD headers
+#include <pxr/usd/sdf/assetPath.h>
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/gf/vec4f.h>
+#include <pxr/base/tf/stringUtils.h>
+
+namespace godot {
+
+// StandardMaterial3D colors are sRGB; UsdPreviewSurface colors are linear
+static GfVec3f _ToLinearColor(const Color &p_color, float p_scale = 1.0f) {
+    const Color linear = p_color.srgb_to_linear();
+    return GfVec3f(linear.r * p_scale, linear.g * p_scale, linear.b * p_scale);
+}
+
+static const char *_ChannelOutput(BaseMaterial3D::TextureChannel p_channel) {
+    switch (p_channel) {
+        case BaseMaterial3D::TEXTURE_CHANNEL_GREEN:
+            return "outputs:g";
+        case BaseMaterial3D::TEXTURE_CHANNEL_BLUE:
+            return "outputs:b";
+        case BaseMaterial3D::TEXTURE_CHANNEL_ALPHA:
+            return "outputs:a";
+        default:
+            return "outputs:r";
+    }
+}
+
+// Declare p_output on the texture shader and connect the surface input to it
+static void _ConnectInput(UsdLayerWriter &p_writer, const SdfPath &p_surface_path, const char *p_input, const SdfValueTypeName &p_input_type,
+        const SdfPath &p_texture_path, const char *p_output) {
+    const TfToken output(p_output);
+    const SdfValueTypeName output_type = output == "outputs:rgb" ? SdfValueTypeNames->Float3 : SdfValueTypeNames->Float;
+    p_writer.declare_attribute(p_texture_path, output, output_type);
+    p_writer.connect_attribute(p_surface_path, TfToken(p_input), p_input_type, p_texture_path.AppendProperty(output));
+}
+
+UsdMaterialExportHelper::UsdMaterialExportHelper(const SdfPath &p_scope_path) :
+        _scope_path(p_scope_path) {
+}
+
+SdfPath UsdMaterialExportHelper::get_or_define_material(const Ref<Material> &p_material, UsdLayerWriter &p_writer) {
+    if (p_material.is_null()) {
+        return SdfPath();
+    }
+    auto found = _material_paths.find(p_material->get_instance_id());
+    if (found != _material_paths.end()) {
+        return found->second;
+    }
+
+    if (!_scope_defined) {
+        _scope_defined = p_writer.define_prim(_scope_path, TfToken("Scope"));
+    }
+
+    // Prim name from the resource name, made unique within the scope
+    std::string base_name = "Material";
+    const String resource_name = p_material->get_name();
+    if (!resource_name.is_empty()) {
+        base_name = TfMakeValidIdentifier(resource_name.utf8().get_data());
+    }
+    std::string name = base_name;
+    for (int suffix = 1; _used_names.count(name) > 0; ++suffix) {
+        name = base_name + "_" + std::to_string(suffix);
+    }
+
+    const SdfPath material_path = _scope_path.AppendChild(TfToken(name));
+    if (!p_writer.define_prim(material_path, TfToken("Material"))) {
+        return SdfPath();
+    }
+
+    Ref<BaseMaterial3D> base_material = p_material;
+    if (base_material.is_valid()) {
+        _author_preview_surface(base_material, p_writer, material_path);
+    }
+    _used_names.insert(name);
+    _material_paths.emplace(p_material->get_instance_id(), material_path);
+    return material_path;
+}
+
+void UsdMaterialExportHelper::bind_material(UsdLayerWriter &p_writer, const SdfPath &p_prim_path, const SdfPath &p_material_path) {
+    if (p_material_path.IsEmpty()) {
+        return;
+    }
+    static const TfToken binding_api("MaterialBindingAPI");
+    static const TfToken binding("material:binding");
+    p_writer.apply_api_schema(p_prim_path, binding_api);
+    p_writer.set_relationship_targets(p_prim_path, binding, SdfPathVector{ p_material_path });
+}
+
+void UsdMaterialExportHelper::_author_preview_surface(const Ref<BaseMaterial3D> &p_material, UsdLayerWriter &p_writer, const SdfPath &p_material_path) {
+    static const TfToken info_id("info:id");
+    static const TfToken surface_output("outputs:surface");
+    static const TfToken srgb("sRGB");
+    static const TfToken raw("raw");
+
+    const SdfPath surface_path = p_material_path.AppendChild(TfToken("PreviewSurface"));
+    p_writer.define_prim(surface_path, TfToken("Shader"));
+    p_writer.set_attribute(surface_path, info_id, SdfValueTypeNames->Token, VtValue(TfToken("UsdPreviewSurface")), SdfVariabilityUniform);
+    p_writer.declare_attribute(surface_path, surface_output, SdfValueTypeNames->Token);
+    p_writer.connect_attribute(p_material_path, surface_output, SdfValueTypeNames->Token, surface_path.AppendProperty(surface_output));
+
+    // Godot multiplies textures by the matching scalar or color, which
+    // maps to UsdUVTexture's scale input
+    const Color albedo = p_material->get_albedo();
+    const GfVec3f albedo_linear = _ToLinearColor(albedo);
+    const SdfPath albedo_texture = _author_texture(p_material->get_texture(BaseMaterial3D::TEXTURE_ALBEDO), "AlbedoTexture", srgb, p_writer, p_material_path);
+    if (albedo_texture.IsEmpty()) {
+        p_writer.set_attribute(surface_path, TfToken("inputs:diffuseColor"), SdfValueTypeNames->Color3f, VtValue(albedo_linear));
+    } else {
+        p_writer.set_attribute(albedo_texture, TfToken("inputs:scale"), SdfValueTypeNames->Float4,
+                VtValue(GfVec4f(albedo_linear[0], albedo_linear[1], albedo_linear[2], albedo.a)));
+        _ConnectInput(p_writer, surface_path, "inputs:diffuseColor", SdfValueTypeNames->Color3f, albedo_texture, "outputs:rgb");
+    }
+
+    // ORMMaterial3D packs occlusion, roughness and metallic into one texture
+    const bool orm = p_material->is_class("ORMMaterial3D");
+    const Ref<Texture2D> orm_texture = orm ? p_material->get_texture(BaseMaterial3D::TEXTURE_ORM) : Ref<Texture2D>();
+
+    const float roughness = p_material->get_roughness();
+    const SdfPath roughness_texture = _author_texture(orm ? orm_texture : p_material->get_texture(BaseMaterial3D::TEXTURE_ROUGHNESS),
+            orm ? "OrmTexture" : "RoughnessTexture", raw, p_writer, p_material_path);
+    if (roughness_texture.IsEmpty()) {
+        p_writer.set_attribute(surface_path, TfToken("inputs:roughness"), SdfValueTypeNames->Float, VtValue(roughness));
+    } else {
+        _ConnectInput(p_writer, surface_path, "inputs:roughness", SdfValueTypeNames->Float, roughness_texture,
+                orm ? "outputs:g" : _ChannelOutput(p_material->get_roughness_texture_channel()));
+        if (!orm && roughness != 1.0f) {
+            p_writer.set_attribute(roughness_texture, TfToken("inputs:scale"), SdfValueTypeNames->Float4, VtValue(GfVec4f(roughness)));
+        }
+    }
+
+    const float metallic = p_material->get_metallic();
+    const SdfPath metallic_texture = orm ? roughness_texture :
+            _author_texture(p_material->get_texture(BaseMaterial3D::TEXTURE_METALLIC), "MetallicTexture", raw, p_writer, p_material_path);
+    if (metallic_texture.IsEmpty()) {
+        p_writer.set_attribute(surface_path, TfToken("inputs:metallic"), SdfValueTypeNames->Float, VtValue(metallic));
+    } else {
+        _ConnectInput(p_writer, surface_path, "inputs:metallic", SdfValueTypeNames->Float, metallic_texture,
+                orm ? "outputs:b" : _ChannelOutput(p_material->get_metallic_texture_channel()));
+        if (!orm && metallic != 1.0f) {
+            p_writer.set_attribute(metallic_texture, TfToken("inputs:scale"), SdfValueTypeNames->Float4, VtValue(GfVec4f(metallic)));
+        }
+    }
+
+    if (p_material->get_feature(BaseMaterial3D::FEATURE_NORMAL_MAPPING)) {
+        // Tangent-space normals stored as 0..1 colors
+        const SdfPath normal_texture = _author_texture(p_material->get_texture(BaseMaterial3D::TEXTURE_NORMAL), "NormalTexture", raw, p_writer, p_material_path);
+        if (!normal_texture.IsEmpty()) {
+            p_writer.set_attribute(normal_texture, TfToken("inputs:scale"), SdfValueTypeNames->Float4, VtValue(GfVec4f(2.0f, 2.0f, 2.0f, 1.0f)));
+            p_writer.set_attribute(normal_texture, TfToken("inputs:bias"), SdfValueTypeNames->Float4, VtValue(GfVec4f(-1.0f, -1.0f, -1.0f, 0.0f)));
+            _ConnectInput(p_writer, surface_path, "inputs:normal", SdfValueTypeNames->Normal3f, normal_texture, "outputs:rgb");
+        }
+    }
+
+    if (p_material->get_feature(BaseMaterial3D::FEATURE_EMISSION)) {
+        const GfVec3f emission = _ToLinearColor(p_material->get_emission(), p_material->get_emission_energy_multiplier());
+        const SdfPath emission_texture = _author_texture(p_material->get_texture(BaseMaterial3D::TEXTURE_EMISSION), "EmissionTexture", srgb, p_writer, p_material_path);
+        if (emission_texture.IsEmpty()) {
+            p_writer.set_attribute(surface_path, TfToken("inputs:emissiveColor"), SdfValueTypeNames->Color3f, VtValue(emission));
+        } else {
+            p_writer.set_attribute(emission_texture, TfToken("inputs:scale"), SdfValueTypeNames->Float4,
+                    VtValue(GfVec4f(emission[0], emission[1], emission[2], 1.0f)));
+            _ConnectInput(p_writer, surface_path, "inputs:emissiveColor", SdfValueTypeNames->Color3f, emission_texture, "outputs:rgb");
+        }
+    }
+
+    // Alpha comes from the albedo in Godot
+    const BaseMaterial3D::Transparency transparency = p_material->get_transparency();
+    if (transparency != BaseMaterial3D::TRANSPARENCY_DISABLED) {
+        if (albedo_texture.IsEmpty()) {
+            p_writer.set_attribute(surface_path, TfToken("inputs:opacity"), SdfValueTypeNames->Float, VtValue((float)albedo.a));
+        } else {
+            _ConnectInput(p_writer, surface_path, "inputs:opacity", SdfValueTypeNames->Float, albedo_texture, "outputs:a");
+        }
+        if (transparency == BaseMaterial3D::TRANSPARENCY_ALPHA_SCISSOR) {
+            p_writer.set_attribute(surface_path, TfToken("inputs:opacityThreshold"), SdfValueTypeNames->Float,
+                    VtValue((float)p_material->get_alpha_scissor_threshold()));
+        }
+    }
+}
+
+SdfPath UsdMaterialExportHelper::_author_texture(const Ref<Texture2D> &p_texture, const char *p_name, const TfToken &p_color_space,
+        UsdLayerWriter &p_writer, const SdfPath &p_material_path) {
+    if (!_export_textures || p_texture.is_null()) {
+        return SdfPath();
+    }
+
+    // Only textures saved as files can be referenced; embedded and
+    // generated textures fall back to the scalar value
+    const String resource_path = p_texture->get_path();
+    if (resource_path.is_empty() || resource_path.contains("::")) {
+        UtilityFunctions::print("USD Export: Skipping texture without a file in ", String(p_material_path.GetText()));
+        return SdfPath();
+    }
+    const std::string file_path = ProjectSettings::get_singleton()->globalize_path(resource_path).utf8().get_data();
+
+    static const TfToken info_id("info:id");
+    static const TfToken result_output("outputs:result");
+
+    // One st reader per material, shared by its textures
+    const SdfPath reader_path = p_material_path.AppendChild(TfToken("TexCoordReader"));
+    if (!p_writer.get_layer()->GetPrimAtPath(reader_path)) {
+        p_writer.define_prim(reader_path, TfToken("Shader"));
+        p_writer.set_attribute(reader_path, info_id, SdfValueTypeNames->Token, VtValue(TfToken("UsdPrimvarReader_float2")), SdfVariabilityUniform);
+        p_writer.set_attribute(reader_path, TfToken("inputs:varname"), SdfValueTypeNames->String, VtValue(std::string("st")));
+        p_writer.declare_attribute(reader_path, result_output, SdfValueTypeNames->Float2);
+    }
+
+    const SdfPath texture_path = p_material_path.AppendChild(TfToken(p_name));
+    p_writer.define_prim(texture_path, TfToken("Shader"));
+    p_writer.set_attribute(texture_path, info_id, SdfValueTypeNames->Token, VtValue(TfToken("UsdUVTexture")), SdfVariabilityUniform);
+    static const TfToken file_input("inputs:file");
+    p_writer.set_attribute(texture_path, file_input, SdfValueTypeNames->Asset, VtValue(SdfAssetPath(file_path)));
+    _texture_files.emplace_back(texture_path.AppendProperty(file_input), file_path);
+    p_writer.set_attribute(texture_path, TfToken("inputs:sourceColorSpace"), SdfValueTypeNames->Token, VtValue(p_color_space));
+    p_writer.connect_attribute(texture_path, TfToken("inputs:st"), SdfValueTypeNames->Float2, reader_path.AppendProperty(result_output));
+    _texture_count++;
+    return texture_path;
+}
+
+} // namespace godot
@@ -0,0 +1,72 @@
+#ifndef USD_MATERIAL_EXPORT_HELPER_H
+#define USD_MATERIAL_EXPORT_HELPER_H
+
+#include <godot_cpp/classes/base_material3d.hpp>
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
+
+// USD headers
+#include <pxr/usd/sdf/path.h>
+#include <pxr/base/tf/token.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+class UsdLayerWriter;
+
+// Exports Godot materials as Material prims under one scope and binds
+// them to gprims and GeomSubsets. Each Material resource is defined once,
+// however many surfaces use it.
+//
+// BaseMaterial3D (StandardMaterial3D, ORMMaterial3D) becomes a
+// UsdPreviewSurface network; other materials get an empty Material prim
+// so bindings and names survive.
+class UsdMaterialExportHelper {
+public:
+    explicit UsdMaterialExportHelper(const SdfPath &p_scope_path);
+
+    // Author UsdUVTexture shaders for textures saved as project files
+    void set_export_textures(bool p_enabled) { _export_textures = p_enabled; }
+
+    // Path of the Material prim for p_material, defining it on first use.
+    // Returns an empty path for a null material.
+    SdfPath get_or_define_material(const Ref<Material> &p_material, UsdLayerWriter &p_writer);
+
+    // Author material:binding on p_prim_path and apply MaterialBindingAPI
+    static void bind_material(UsdLayerWriter &p_writer, const SdfPath &p_prim_path, const SdfPath &p_material_path);
+
+    int64_t get_material_count() const { return (int64_t)_material_paths.size(); }
+    int64_t get_texture_count() const { return _texture_count; }
+
+    // Every inputs:file attribute authored so far with the absolute path
+    // it holds. The layer has no location yet, so the writer rewrites them
+    // relative to the output file; see UsdDocument::write_to_filesystem.
+    const std::vector<std::pair<SdfPath, std::string>> &get_texture_files() const { return _texture_files; }
+
+private:
+    void _author_preview_surface(const Ref<BaseMaterial3D> &p_material, UsdLayerWriter &p_writer, const SdfPath &p_material_path);
+
+    // UsdUVTexture for p_texture under the material, wired to the shared
+    // st reader; returns the texture shader path or an empty path
+    SdfPath _author_texture(const Ref<Texture2D> &p_texture, const char *p_name, const TfToken &p_color_space,
+            UsdLayerWriter &p_writer, const SdfPath &p_material_path);
+
+    SdfPath _scope_path;
+    bool _export_textures = true;
+    int64_t _texture_count = 0;
+    std::vector<std::pair<SdfPath, std::string>> _texture_files;
+    bool _scope_defined = false;
+    std::unordered_map<uint64_t, SdfPath> _material_paths; // by Material instance ID
+    std::set<std::string> _used_names;
+};
+
+} // namespace godot
+
+#endif // USD_MATERIAL_EXPORT_HELPER_H
@@ -0,0 +1,239 @@
+#include "usd_material_import_helper.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+
+// USD headers
+#include <pxr/usd/usdShade/input.h>
+#include <pxr/usd/usdShade/utils.h>
+#include <pxr/usd/sdf/assetPath.h>
+
+namespace godot {
+
+// UsdPreviewSurface colors are linear; StandardMaterial3D colors are sRGB
+static Color _ValueAsColor(const VtValue &p_value, const GfVec3f &p_default) {
+    const GfVec3f color = p_value.IsHolding<GfVec3f>() ? p_value.UncheckedGet<GfVec3f>() : p_default;
+    return Color(color[0], color[1], color[2]).linear_to_srgb();
+}
+
+static float _ValueAsFloat(const VtValue &p_value, float p_default) {
+    return p_value.IsHolding<float>() ? p_value.UncheckedGet<float>() : p_default;
+}
+
+static BaseMaterial3D::TextureChannel _ToTextureChannel(const TfToken &p_output) {
+    if (p_output == "g") {
+        return BaseMaterial3D::TEXTURE_CHANNEL_GREEN;
+    } else if (p_output == "b") {
+        return BaseMaterial3D::TEXTURE_CHANNEL_BLUE;
+    } else if (p_output == "a") {
+        return BaseMaterial3D::TEXTURE_CHANNEL_ALPHA;
+    }
+    return BaseMaterial3D::TEXTURE_CHANNEL_RED;
+}
+
+Ref<Material> UsdMaterialImportHelper::get_material(const UsdPrim &p_gprim) {
+    Ref<Material> material = _get_bound_material(p_gprim);
+    if (material.is_valid()) {
+        return material;
+    }
+    return _create_display_color_material(p_gprim);
+}
+
+Ref<Material> UsdMaterialImportHelper::get_subset_material(const UsdPrim &p_gprim, const UsdPrim &p_subset) {
+    // Binding resolution walks up from the subset, so an unbound subset
+    // picks up the gprim's binding here as well
+    Ref<Material> material = _get_bound_material(p_subset);
+    if (material.is_valid()) {
+        return material;
+    }
+    return _create_display_color_material(p_gprim);
+}
+
+Ref<Material> UsdMaterialImportHelper::_get_bound_material(const UsdPrim &p_prim) {
+    UsdShadeMaterial bound = UsdShadeMaterialBindingAPI(p_prim).ComputeBoundMaterial(&_bindings_cache, &_collection_cache);
+    if (!bound) {
+        return Ref<Material>();
+    }
+    auto found = _materials.find(bound.GetPath());
+    if (found == _materials.end()) {
+        // Materials without a UsdPreviewSurface are cached as null so
+        // they are only inspected once
+        Ref<Material> material = _create_preview_surface_material(bound);
+        if (material.is_valid()) {
+            _material_count++;
+        }
+        found = _materials.emplace(bound.GetPath(), material).first;
+    } else {
+        _cache_hits++;
+    }
+    return found->second;
+}
+
+Ref<StandardMaterial3D> UsdMaterialImportHelper::_create_preview_surface_material(const UsdShadeMaterial &p_material) {
+    UsdShadeShader surface = p_material.ComputeSurfaceSource();
+    TfToken shader_id;
+    if (!surface || !surface.GetShaderId(&shader_id) || shader_id != TfToken("UsdPreviewSurface")) {
+        return Ref<StandardMaterial3D>();
+    }
+
+    Ref<StandardMaterial3D> material;
+    material.instantiate();
+    material->set_name(String(p_material.GetPrim().GetName().GetText()));
+
+    // Unauthored inputs take the UsdPreviewSurface defaults
+    VtValue value;
+    Ref<Texture2D> texture;
+    TfToken channel;
+
+    Ref<Texture2D> albedo_texture;
+    if (_read_input(surface, "diffuseColor", &value, &albedo_texture, &channel) && albedo_texture.is_valid()) {
+        material->set_texture(BaseMaterial3D::TEXTURE_ALBEDO, albedo_texture);
+    } else {
+        material->set_albedo(_ValueAsColor(value, GfVec3f(0.18f)));
+    }
+
+    value = VtValue();
+    if (_read_input(surface, "roughness", &value, &texture, &channel) && texture.is_valid()) {
+        material->set_texture(BaseMaterial3D::TEXTURE_ROUGHNESS, texture);
+        material->set_roughness_texture_channel(_ToTextureChannel(channel));
+        material->set_roughness(1.0);
+    } else {
+        material->set_roughness(_ValueAsFloat(value, 0.5f));
+    }
+
+    value = VtValue();
+    texture.unref();
+    if (_read_input(surface, "metallic", &value, &texture, &channel) && texture.is_valid()) {
+        material->set_texture(BaseMaterial3D::TEXTURE_METALLIC, texture);
+        material->set_metallic_texture_channel(_ToTextureChannel(channel));
+        material->set_metallic(1.0);
+    } else {
+        material->set_metallic(_ValueAsFloat(value, 0.0f));
+    }
+
+    value = VtValue();
+    texture.unref();
+    if (_read_input(surface, "normal", &value, &texture, &channel) && texture.is_valid()) {
+        material->set_feature(BaseMaterial3D::FEATURE_NORMAL_MAPPING, true);
+        material->set_texture(BaseMaterial3D::TEXTURE_NORMAL, texture);
+    }
+
+    value = VtValue();
+    texture.unref();
+    if (_read_input(surface, "emissiveColor", &value, &texture, &channel)) {
+        if (texture.is_valid()) {
+            material->set_feature(BaseMaterial3D::FEATURE_EMISSION, true);
+            material->set_texture(BaseMaterial3D::TEXTURE_EMISSION, texture);
+            material->set_emission(Color(1, 1, 1));
+        } else {
+            const Color emission = _ValueAsColor(value, GfVec3f(0.0f));
+            if (emission != Color(0, 0, 0)) {
+                material->set_feature(BaseMaterial3D::FEATURE_EMISSION, true);
+                material->set_emission(emission);
+            }
+        }
+    }
+
+    // Godot only takes alpha from the albedo, so opacity textures work
+    // when they are the diffuse texture's alpha channel
+    value = VtValue();
+    texture.unref();
+    bool transparent = false;
+    if (_read_input(surface, "opacity", &value, &texture, &channel)) {
+        if (texture.is_valid()) {
+            transparent = true;
+            if (texture != albedo_texture) {
+                UtilityFunctions::print("USD Import: Opacity texture of ", material->get_name(),
+                        " is not the diffuse texture; using the diffuse alpha instead");
+            }
+        } else {
+            const float opacity = _ValueAsFloat(value, 1.0f);
+            if (opacity < 1.0f) {
+                Color albedo = material->get_albedo();
+                albedo.a = opacity;
+                material->set_albedo(albedo);
+                transparent = true;
+            }
+        }
+    }
+    if (transparent) {
+        value = VtValue();
+        texture.unref();
+        _read_input(surface, "opacityThreshold", &value, &texture, &channel);
+        const float threshold = _ValueAsFloat(value, 0.0f);
+        if (threshold > 0.0f) {
+            material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA_SCISSOR);
+            material->set_alpha_scissor_threshold(threshold);
+        } else {
+            material->set_transparency(BaseMaterial3D::TRANSPARENCY_ALPHA);
+        }
+    }
+
+    return material;
+}
+
+Ref<StandardMaterial3D> UsdMaterialImportHelper::_create_display_color_material(const UsdPrim &p_gprim) {
+    static const TfToken display_color("primvars:displayColor");
+    UsdAttribute display_color_attr = p_gprim.GetAttribute(display_color);
+    VtArray<GfVec3f> display_colors;
+    if (!display_color_attr || !display_color_attr.Get(&display_colors) || display_colors.empty()) {
+        return Ref<StandardMaterial3D>();
+    }
+
+    // Only the first color is used, so prims of the same color share one
+    // material
+    const GfVec3f color = display_colors[0];
+    const auto key = std::make_tuple(color[0], color[1], color[2]);
+    auto found = _display_color_materials.find(key);
+    if (found != _display_color_materials.end()) {
+        _cache_hits++;
+        return found->second;
+    }
+
+    Ref<StandardMaterial3D> material;
+    material.instantiate();
+    material->set_albedo(Color(color[0], color[1], color[2]));
+    _display_color_materials.emplace(key, material);
+    _material_count++;
+    return material;
+}
+
+bool UsdMaterialImportHelper::_read_input(const UsdShadeShader &p_surface, const char *p_name, VtValue *r_value, Ref<Texture2D> *r_texture, TfToken *r_channel) {
+    UsdShadeInput input = p_surface.GetInput(TfToken(p_name));
+    if (!input) {
+        return false;
+    }
+
+    // Follows connections through material interface inputs
+    UsdShadeAttributeVector sources = input.GetValueProducingAttributes();
+    if (sources.empty()) {
+        return false;
+    }
+    const UsdAttribute &source = sources[0];
+    if (UsdShadeUtils::GetType(source.GetName()) != UsdShadeAttributeType::Output) {
+        return source.Get(r_value);
+    }
+
+    UsdShadeShader texture_shader(source.GetPrim());
+    TfToken shader_id;
+    if (!texture_shader.GetShaderId(&shader_id) || shader_id != TfToken("UsdUVTexture")) {
+        return false;
+    }
+    *r_texture = _load_texture(texture_shader);
+    *r_channel = UsdShadeUtils::GetBaseNameAndType(source.GetName()).first;
+    return r_texture->is_valid();
+}
+
+Ref<Texture2D> UsdMaterialImportHelper::_load_texture(const UsdShadeShader &p_texture_shader) {
+    UsdShadeInput file_input = p_texture_shader.GetInput(TfToken("file"));
+    if (!file_input) {
+        return Ref<Texture2D>();
+    }
+    UsdShadeAttributeVector sources = file_input.GetValueProducingAttributes();
+    SdfAssetPath file;
+    if (sources.empty() || !sources[0].Get(&file)) {
+        return Ref<Texture2D>();
+    }
+
+    return get_texture_loader().request(file);
+}
+
+} // namespace godot
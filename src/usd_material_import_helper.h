@@ -0,0 +1,82 @@
+#ifndef USD_MATERIAL_IMPORT_HELPER_H
+#define USD_MATERIAL_IMPORT_HELPER_H
+
+#include <godot_cpp/classes/material.hpp>
+#include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/classes/texture2d.hpp>
+
+#include "usd_texture_loader.h"
+
+// USD headers
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usdShade/material.h>
+#include <pxr/usd/usdShade/materialBindingAPI.h>
+#include <pxr/usd/usdShade/shader.h>
+#include <pxr/base/gf/vec3f.h>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// Converts bound UsdShadeMaterials with a UsdPreviewSurface network to
+// StandardMaterial3D. Every USD material becomes exactly one Godot
+// material, shared by all the gprims bound to it; textures go through a
+// UsdTextureLoader, which loads each resolved file once.
+class UsdMaterialImportHelper {
+public:
+    // Material for p_gprim: its bound material if it has one, else a
+    // material carrying its primvars:displayColor. Null if neither is
+    // authored.
+    Ref<Material> get_material(const UsdPrim &p_gprim);
+
+    // Material for the faces of p_subset, a materialBind GeomSubset of
+    // p_gprim: the subset's bound material, else p_gprim's material.
+    Ref<Material> get_subset_material(const UsdPrim &p_gprim, const UsdPrim &p_subset);
+
+    // Loader for texture inputs. Not owned; without one, textures are
+    // decoded synchronously by an internal loader.
+    void set_texture_loader(UsdTextureLoader *p_loader) { _texture_loader = p_loader; }
+    UsdTextureLoader &get_texture_loader() { return _texture_loader ? *_texture_loader : _sync_loader; }
+    const UsdTextureLoader &get_texture_loader() const { return _texture_loader ? *_texture_loader : _sync_loader; }
+
+    int64_t get_material_count() const { return _material_count; }
+    int64_t get_cache_hits() const { return _cache_hits; }
+
+private:
+    // Converted material bound to p_prim, null if none is bound or it has
+    // no UsdPreviewSurface
+    Ref<Material> _get_bound_material(const UsdPrim &p_prim);
+    Ref<StandardMaterial3D> _create_preview_surface_material(const UsdShadeMaterial &p_material);
+    Ref<StandardMaterial3D> _create_display_color_material(const UsdPrim &p_gprim);
+
+    // Value or texture feeding a UsdPreviewSurface input. r_texture is set
+    // when the input is connected to a UsdUVTexture; r_channel is the
+    // texture output used ("rgb", "r", "a", ...).
+    bool _read_input(const UsdShadeShader &p_surface, const char *p_name, VtValue *r_value, Ref<Texture2D> *r_texture, TfToken *r_channel);
+    Ref<Texture2D> _load_texture(const UsdShadeShader &p_texture_shader);
+
+    // Bound materials by path
+    std::unordered_map<SdfPath, Ref<Material>, SdfPath::Hash> _materials;
+
+    // displayColor-only prims, by color
+    std::map<std::tuple<float, float, float>, Ref<Material>> _display_color_materials;
+
+    UsdTextureLoader *_texture_loader = nullptr;
+    UsdTextureLoader _sync_loader;
+
+    // Binding resolution caches, shared by every get_material call
+    UsdShadeMaterialBindingAPI::BindingsCache _bindings_cache;
+    UsdShadeMaterialBindingAPI::CollectionQueryCache _collection_cache;
+
+    int64_t _material_count = 0;
+    int64_t _cache_hits = 0;
+};
+
+} // namespace godot
+
+#endif // USD_MATERIAL_IMPORT_HELPER_H
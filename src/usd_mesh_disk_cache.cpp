@@ -0,0 +1,454 @@
+#include "usd_mesh_disk_cache.h"
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <pxr/usd/sdf/layer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace godot {
+
+static const char CACHE_MAGIC[8] = { 'G', 'D', 'U', 'S', 'D', 'M', 'C', '\0' };
+static const uint32_t CACHE_VERSION = 2;
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+static const uint64_t CACHE_ALIGNMENT = 16;
+
+// FNV-1a, stable across runs and builds unlike std::hash
+static uint64_t _HashBytes(uint64_t p_hash, const void *p_data, size_t p_size) {
+    const unsigned char *bytes = (const unsigned char *)p_data;
+    for (size_t i = 0; i < p_size; ++i) {
+        p_hash ^= bytes[i];
+        p_hash *= 1099511628211ull;
+    }
+    return p_hash;
+}
+
+static uint64_t _HashString(uint64_t p_hash, const std::string &p_string) {
+    const uint64_t size = p_string.size();
+    p_hash = _HashBytes(p_hash, &size, sizeof(size));
+    return _HashBytes(p_hash, p_string.data(), p_string.size());
+}
+
+static uint64_t _AlignUp(uint64_t p_value) {
+    return (p_value + CACHE_ALIGNMENT - 1) & ~(CACHE_ALIGNMENT - 1);
+}
+
+static std::string _ToStdString(const String &p_string) {
+    return std::string(p_string.utf8().get_data());
+}
+
+// Element size of each cached array, in EntryRecord::array_counts order
+static const uint64_t ELEMENT_SIZES[] = { sizeof(Vector3), sizeof(Vector3), sizeof(Vector2), sizeof(Color), sizeof(int32_t) };
+static const int ARRAY_SLOTS[] = { Mesh::ARRAY_VERTEX, Mesh::ARRAY_NORMAL, Mesh::ARRAY_TEX_UV, Mesh::ARRAY_COLOR, Mesh::ARRAY_INDEX };
+
+// Element count of one cached array in a surface's Array
+static uint64_t _ArrayCount(const Array &p_arrays, int p_slot) {
+    const Variant &value = p_arrays[ARRAY_SLOTS[p_slot]];
+    switch (value.get_type()) {
+        case Variant::PACKED_VECTOR3_ARRAY:
+            return PackedVector3Array(value).size();
+        case Variant::PACKED_VECTOR2_ARRAY:
+            return PackedVector2Array(value).size();
+        case Variant::PACKED_COLOR_ARRAY:
+            return PackedColorArray(value).size();
+        case Variant::PACKED_INT32_ARRAY:
+            return PackedInt32Array(value).size();
+        default:
+            return 0;
+    }
+}
+
+static void _WriteArray(std::FILE *p_file, const Array &p_arrays, int p_slot) {
+    const Variant &value = p_arrays[ARRAY_SLOTS[p_slot]];
+    switch (value.get_type()) {
+        case Variant::PACKED_VECTOR3_ARRAY: {
+            const PackedVector3Array array = value;
+            std::fwrite(array.ptr(), sizeof(Vector3), array.size(), p_file);
+        } break;
+        case Variant::PACKED_VECTOR2_ARRAY: {
+            const PackedVector2Array array = value;
+            std::fwrite(array.ptr(), sizeof(Vector2), array.size(), p_file);
+        } break;
+        case Variant::PACKED_COLOR_ARRAY: {
+            const PackedColorArray array = value;
+            std::fwrite(array.ptr(), sizeof(Color), array.size(), p_file);
+        } break;
+        case Variant::PACKED_INT32_ARRAY: {
+            const PackedInt32Array array = value;
+            std::fwrite(array.ptr(), sizeof(int32_t), array.size(), p_file);
+        } break;
+        default:
+            break;
+    }
+}
+
+// 64-bit seek; cache files for large stages pass 2 GiB
+static bool _Seek(std::FILE *p_file, uint64_t p_offset) {
+#ifdef _WIN32
+    return _fseeki64(p_file, (__int64)p_offset, SEEK_SET) == 0;
+#else
+    return fseeko(p_file, (off_t)p_offset, SEEK_SET) == 0;
+#endif
+}
+
+// Read p_count elements of one slot straight into a new packed array
+template <typename T>
+static bool _ReadArray(std::FILE *p_file, uint64_t p_count, Variant *r_value) {
+    T array;
+    array.resize(p_count);
+    if (p_count > 0 && std::fread(array.ptrw(), sizeof(array.ptr()[0]), p_count, p_file) != p_count) {
+        return false;
+    }
+    *r_value = array;
+    return true;
+}
+
+UsdMeshDiskCache::UsdMeshDiskCache() {
+}
+
+UsdMeshDiskCache::~UsdMeshDiskCache() {
+    _close();
+}
+
+String UsdMeshDiskCache::get_cache_dir() {
+    return "user://usd_mesh_cache/";
+}
+
+void UsdMeshDiskCache::_close() {
+    if (_file) {
+        std::fclose(_file);
+        _file = nullptr;
+    }
+    _index.clear();
+}
+
+bool UsdMeshDiskCache::open(const UsdStageRefPtr &p_stage, const UsdMeshImportOptions &p_options) {
+    _close();
+    _enabled = false;
+    _dirty = false;
+    _stored.clear();
+    _hit_count = 0;
+
+    SdfLayerHandle root_layer = p_stage->GetRootLayer();
+    if (!root_layer || root_layer->IsAnonymous()) {
+        return false;
+    }
+
+    // Key every layer the stage composes, sorted so the key does not depend
+    // on composition order
+    SdfLayerHandleVector layers = p_stage->GetUsedLayers();
+    std::sort(layers.begin(), layers.end(), [](const SdfLayerHandle &a, const SdfLayerHandle &b) {
+        return a->GetIdentifier() < b->GetIdentifier();
+    });
+
+    // Layers come from the shared registry, so they may hold edits made
+    // through UsdStageManager that no file has; their meshes can't be
+    // keyed by anything on disk
+    for (const SdfLayerHandle &layer : layers) {
+        if (!layer->IsAnonymous() && layer->IsDirty()) {
+            return false;
+        }
+    }
+
+    uint64_t key = 14695981039346656037ull;
+    key = _HashBytes(key, &CACHE_VERSION, sizeof(CACHE_VERSION));
+    key = _HashBytes(key, ELEMENT_SIZES, sizeof(ELEMENT_SIZES));
+    key = _HashBytes(key, &p_options.weld_vertices, sizeof(p_options.weld_vertices));
+    for (const SdfLayerHandle &layer : layers) {
+        key = _HashString(key, layer->GetIdentifier());
+        if (layer->IsAnonymous()) {
+            // Session and other in-memory layers are small; hash their text
+            std::string text;
+            layer->ExportToString(&text);
+            key = _HashString(key, text);
+            continue;
+        }
+
+        // A clean layer opened earlier may predate the file on disk. Bring
+        // it up to date (a no-op when unchanged) so the file's size and
+        // mtime describe the layer the meshes are read from.
+        layer->Reload();
+
+        // Not a plain file (e.g. a resolver-backed asset); no reliable key.
+        // A successful call clears the error code, so check after each.
+        std::error_code error;
+        const std::filesystem::path real_path(layer->GetRealPath());
+        const uint64_t size = std::filesystem::file_size(real_path, error);
+        if (error) {
+            return false;
+        }
+        const int64_t mtime = std::filesystem::last_write_time(real_path, error).time_since_epoch().count();
+        if (error) {
+            return false;
+        }
+        key = _HashBytes(key, &size, sizeof(size));
+        key = _HashBytes(key, &mtime, sizeof(mtime));
+    }
+
+    _stage_key = key;
+    _enabled = true;
+
+    const uint64_t name_hash = _HashString(14695981039346656037ull, root_layer->GetIdentifier());
+    _cache_path = get_cache_dir() + String::num_uint64(name_hash, 16) + ".gdmc";
+
+    const String abs_path = ProjectSettings::get_singleton()->globalize_path(_cache_path);
+    _file = std::fopen(abs_path.utf8().get_data(), "rb");
+    if (_file && !_read_index()) {
+        _close();
+    }
+    return true;
+}
+
+bool UsdMeshDiskCache::_read_index() {
+    Header header;
+    if (std::fread(&header, sizeof(header), 1, _file) != 1 ||
+            std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+            header.version != CACHE_VERSION || header.byte_order != CACHE_BYTE_ORDER ||
+            header.stage_key != _stage_key) {
+        return false;
+    }
+
+    std::vector<EntryRecord> records(header.entry_count);
+    if (header.entry_count > 0 && std::fread(records.data(), sizeof(EntryRecord), records.size(), _file) != records.size()) {
+        return false;
+    }
+
+    std::string strings(header.strings_size, '\0');
+    if (!_Seek(_file, header.strings_offset) ||
+            (header.strings_size > 0 && std::fread(&strings[0], 1, strings.size(), _file) != strings.size())) {
+        return false;
+    }
+
+    _index.reserve(records.size());
+    for (const EntryRecord &record : records) {
+        if (record.path_offset + record.path_length > strings.size()) {
+            return false;
+        }
+        _index.emplace(strings.substr(record.path_offset, record.path_length), record);
+    }
+    return true;
+}
+
+bool UsdMeshDiskCache::_read_entry(const std::string &p_path, const EntryRecord &p_record, UsdMeshSurfaceData *r_surface) {
+    const EntryRecord &record = p_record;
+    UsdMeshSurfaceData surface;
+    surface.arrays.resize(Mesh::ARRAY_MAX);
+
+    uint64_t offset = record.data_offset;
+    for (int slot = 0; slot < ARRAY_COUNT; ++slot) {
+        const uint64_t count = record.array_counts[slot];
+        if (!_Seek(_file, offset)) {
+            return false;
+        }
+
+        Variant value;
+        bool ok = false;
+        switch (slot) {
+            case ARRAY_VERTEX:
+            case ARRAY_NORMAL:
+                ok = _ReadArray<PackedVector3Array>(_file, count, &value);
+                break;
+            case ARRAY_TEX_UV:
+                ok = _ReadArray<PackedVector2Array>(_file, count, &value);
+                break;
+            case ARRAY_COLOR:
+                ok = _ReadArray<PackedColorArray>(_file, count, &value);
+                break;
+            case ARRAY_INDEX:
+                ok = _ReadArray<PackedInt32Array>(_file, count, &value);
+                break;
+        }
+        if (!ok) {
+            UtilityFunctions::printerr("USD Import: Truncated mesh cache entry for ", String(p_path.c_str()), " in ", _cache_path);
+            return false;
+        }
+        surface.arrays[ARRAY_SLOTS[slot]] = value;
+        offset = _AlignUp(offset + count * ELEMENT_SIZES[slot]);
+    }
+
+    if (record.surface_count > 0) {
+        Variant ends;
+        std::string names(record.names_size, '\0');
+        if (!_Seek(_file, offset) || !_ReadArray<PackedInt32Array>(_file, record.surface_count * 2, &ends) ||
+                !_Seek(_file, _AlignUp(offset + record.surface_count * 2 * sizeof(int32_t))) ||
+                (record.names_size > 0 && std::fread(&names[0], 1, names.size(), _file) != names.size())) {
+            UtilityFunctions::printerr("USD Import: Truncated mesh cache entry for ", String(p_path.c_str()), " in ", _cache_path);
+            return false;
+        }
+        surface.surface_ends = ends;
+        surface.surface_names = String::utf8(names.data(), names.size()).split("\n");
+        if ((uint64_t)surface.surface_names.size() != record.surface_count) {
+            return false;
+        }
+    }
+
+    surface.corner_count = record.corner_count;
+    surface.vertex_count = record.vertex_count;
+    surface.content_hash = record.content_hash;
+    surface.byte_size = record.byte_size;
+    surface.valid = true;
+
+    *r_surface = surface;
+    return true;
+}
+
+bool UsdMeshDiskCache::lookup(const SdfPath &p_prim_path, UsdMeshSurfaceData *r_surface) {
+    if (!_enabled) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_file) {
+        return false;
+    }
+    auto found = _index.find(p_prim_path.GetString());
+    if (found == _index.end() || !_read_entry(found->first, found->second, r_surface)) {
+        return false;
+    }
+    _hit_count++;
+    return true;
+}
+
+void UsdMeshDiskCache::store(const SdfPath &p_prim_path, const UsdMeshSurfaceData &p_surface) {
+    if (!_enabled || !p_surface.valid) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stored[p_prim_path.GetString()] = p_surface;
+    _dirty = true;
+}
+
+Error UsdMeshDiskCache::save() {
+    if (!_enabled || !_dirty) {
+        return OK;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Entries from the current file that were not replaced are carried over,
+    // read back here rather than held in memory for the whole import
+    std::vector<std::pair<std::string, UsdMeshSurfaceData>> entries;
+    entries.reserve(_index.size() + _stored.size());
+    for (const auto &indexed : _index) {
+        UsdMeshSurfaceData surface;
+        if (_stored.find(indexed.first) == _stored.end() && _read_entry(indexed.first, indexed.second, &surface)) {
+            entries.emplace_back(indexed.first, surface);
+        }
+    }
+    for (auto &stored : _stored) {
+        entries.emplace_back(stored.first, std::move(stored.second));
+    }
+    _stored.clear();
+
+    // The old file is replaced below; stop reading from it first
+    _close();
+
+    DirAccess::make_dir_recursive_absolute(get_cache_dir());
+    const String abs_path = ProjectSettings::get_singleton()->globalize_path(_cache_path);
+    const String temp_path = abs_path + ".tmp";
+
+    // Lay out the file: header, records, strings, then aligned array data
+    Header header = {};
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    header.stage_key = _stage_key;
+    header.entry_count = entries.size();
+    header.strings_offset = sizeof(Header) + entries.size() * sizeof(EntryRecord);
+
+    std::vector<EntryRecord> records(entries.size());
+    std::string strings;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        records[i] = {};
+        records[i].path_offset = strings.size();
+        records[i].path_length = entries[i].first.size();
+        strings += entries[i].first;
+    }
+    header.strings_size = strings.size();
+
+    // Surface names of split meshes, written after their arrays
+    std::vector<std::string> surface_names(entries.size());
+
+    uint64_t offset = _AlignUp(header.strings_offset + header.strings_size);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const UsdMeshSurfaceData &surface = entries[i].second;
+        EntryRecord &record = records[i];
+        record.corner_count = surface.corner_count;
+        record.vertex_count = surface.vertex_count;
+        record.content_hash = surface.content_hash;
+        record.byte_size = surface.byte_size;
+        record.data_offset = offset;
+        for (int slot = 0; slot < ARRAY_COUNT; ++slot) {
+            record.array_counts[slot] = _ArrayCount(surface.arrays, slot);
+            offset = _AlignUp(offset + record.array_counts[slot] * ELEMENT_SIZES[slot]);
+        }
+        record.surface_count = surface.surface_names.size();
+        if (record.surface_count > 0) {
+            surface_names[i] = _ToStdString(String("\n").join(surface.surface_names));
+            record.names_size = surface_names[i].size();
+            offset = _AlignUp(offset + record.surface_count * 2 * sizeof(int32_t));
+            offset = _AlignUp(offset + record.names_size);
+        }
+    }
+
+    std::FILE *file = std::fopen(temp_path.utf8().get_data(), "wb");
+    if (!file) {
+        UtilityFunctions::printerr("USD Import: Failed to write mesh cache ", temp_path);
+        return ERR_FILE_CANT_WRITE;
+    }
+
+    static const char padding[CACHE_ALIGNMENT] = {};
+    uint64_t written = 0;
+    auto write = [&](const void *p_data, uint64_t p_size) {
+        if (p_size > 0) {
+            std::fwrite(p_data, 1, p_size, file);
+        }
+        written += p_size;
+    };
+    auto pad = [&]() {
+        write(padding, _AlignUp(written) - written);
+    };
+
+    write(&header, sizeof(header));
+    write(records.data(), records.size() * sizeof(EntryRecord));
+    write(strings.data(), strings.size());
+    pad();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        for (int slot = 0; slot < ARRAY_COUNT; ++slot) {
+            _WriteArray(file, entries[i].second.arrays, slot);
+            written += records[i].array_counts[slot] * ELEMENT_SIZES[slot];
+            pad();
+        }
+        if (records[i].surface_count > 0) {
+            write(entries[i].second.surface_ends.ptr(), records[i].surface_count * 2 * sizeof(int32_t));
+            pad();
+            write(surface_names[i].data(), surface_names[i].size());
+            pad();
+        }
+    }
+
+    const bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    std::error_code error;
+    if (failed) {
+        std::filesystem::remove(_ToStdString(temp_path), error);
+        UtilityFunctions::printerr("USD Import: Failed to write mesh cache ", temp_path);
+        return ERR_FILE_CANT_WRITE;
+    }
+
+    // Replace atomically so a crash never leaves a half-written cache
+    std::filesystem::rename(_ToStdString(temp_path), _ToStdString(abs_path), error);
+    if (error) {
+        UtilityFunctions::printerr("USD Import: Failed to replace mesh cache ", abs_path, ": ", error.message().c_str());
+        return ERR_FILE_CANT_WRITE;
+    }
+
+    _dirty = false;
+    UtilityFunctions::print("USD Import: Wrote mesh cache ", _cache_path, " (", (int64_t)entries.size(), " meshes, ",
+            String::num(written / (1024.0 * 1024.0), 2), " MiB)");
+    return OK;
+}
+
+} // namespace godot
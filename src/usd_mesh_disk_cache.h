@@ -0,0 +1,120 @@
+#ifndef USD_MESH_DISK_CACHE_H
+#define USD_MESH_DISK_CACHE_H
+
+#include "usd_mesh_import_helper.h"
+#include <godot_cpp/classes/global_constants.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+// USD headers
+#include <pxr/usd/usd/stage.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// Converted mesh arrays persisted under user://usd_mesh_cache/, one file
+// per root layer, so re-importing an unchanged stage skips conversion.
+//
+// The file is valid only for one stage key: the identifier, size and
+// modification time of every layer the stage uses plus the import options
+// that change the arrays. Any edit to any layer invalidates the whole file,
+// so a warm import either hits for every mesh or rebuilds everything.
+//
+// Layout, native byte order, every block 16-byte aligned so the file can
+// be mapped and the arrays used in place:
+//   Header
+//   EntryRecord[entry_count]
+//   path strings
+//   array data: vertices, normals, uvs, colors, indices, then for meshes
+//   split by GeomSubsets the surface ends and '\n'-joined surface names
+class UsdMeshDiskCache {
+public:
+    UsdMeshDiskCache();
+    ~UsdMeshDiskCache();
+
+    // Compute the stage key and open the matching cache file if it exists.
+    // Clean layers whose file changed on disk are reloaded first. Returns
+    // false when the stage cannot be cached (an in-memory root layer, or a
+    // layer with unsaved edits); lookup and store are then no-ops.
+    bool open(const UsdStageRefPtr &p_stage, const UsdMeshImportOptions &p_options);
+    bool is_enabled() const { return _enabled; }
+
+    // Thread-safe. Fill r_surface with the arrays stored for p_prim_path.
+    bool lookup(const SdfPath &p_prim_path, UsdMeshSurfaceData *r_surface);
+
+    // Thread-safe. Remember arrays converted on a miss for save().
+    void store(const SdfPath &p_prim_path, const UsdMeshSurfaceData &p_surface);
+
+    // Rewrite the cache file if anything was stored since open()
+    Error save();
+
+    int64_t get_hit_count() const { return _hit_count; }
+    const String &get_cache_path() const { return _cache_path; }
+
+    // Directory holding every cache file
+    static String get_cache_dir();
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t stage_key;
+        uint64_t entry_count;
+        uint64_t strings_offset;
+        uint64_t strings_size;
+        uint64_t reserved[2];
+    };
+
+    enum {
+        ARRAY_VERTEX,
+        ARRAY_NORMAL,
+        ARRAY_TEX_UV,
+        ARRAY_COLOR,
+        ARRAY_INDEX,
+        ARRAY_COUNT,
+    };
+
+    struct EntryRecord {
+        uint64_t path_offset; // into the string block
+        uint64_t path_length;
+        int64_t corner_count;
+        int64_t vertex_count;
+        uint64_t content_hash;
+        int64_t byte_size;
+        uint64_t data_offset; // absolute file offset of the first array
+        uint64_t array_counts[ARRAY_COUNT]; // elements, not bytes
+        uint64_t surface_count; // zero unless split by GeomSubsets
+        uint64_t names_size; // bytes
+        uint64_t reserved;
+    };
+
+    bool _enabled = false;
+    bool _dirty = false;
+    uint64_t _stage_key = 0;
+    String _cache_path;
+
+    std::FILE *_file = nullptr;
+    std::unordered_map<std::string, EntryRecord> _index;
+
+    // Arrays converted on a miss, written by save()
+    std::unordered_map<std::string, UsdMeshSurfaceData> _stored;
+
+    std::mutex _mutex;
+    int64_t _hit_count = 0;
+
+    bool _read_index();
+    bool _read_entry(const std::string &p_path, const EntryRecord &p_record, UsdMeshSurfaceData *r_surface);
+    void _close();
+};
+
+} // namespace godot
+
+#endif // USD_MESH_DISK_CACHE_H
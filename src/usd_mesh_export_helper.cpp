@@ -1,6 +1,19 @@
 #include "usd_mesh_export_helper.h"
+#include "usd_array_utils.h"
+#include "usd_layer_writer.h"
+#include "usd_material_export_helper.h"
+#include "usd_parallel.h"
 #include <godot_cpp/variant/utility_functions.hpp>
 
+// USD headers
+#include <pxr/usd/sdf/schema.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3d.h>
+#include <pxr/base/tf/stringUtils.h>
+
+#include <string>
+
 namespace godot {
 
 UsdMeshExportHelper::UsdMeshExportHelper() {
@@ -11,61 +24,55 @@ UsdMeshExportHelper::~UsdMeshExportHelper() {
     // Destructor
 }
 
-pxr::UsdPrim UsdMeshExportHelper::export_mesh_to_prim(const Ref<Mesh> p_mesh, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_mesh_to_prim(const Ref<Mesh> p_mesh, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Check if the mesh is valid
     if (p_mesh.is_null()) {
         UtilityFunctions::printerr("USD Export: Invalid mesh");
-        return pxr::UsdPrim();
-    }
-
-    // Check if the stage is valid
-    if (!p_stage) {
-        UtilityFunctions::printerr("USD Export: Invalid stage");
-        return pxr::UsdPrim();
+        return false;
     }
 
     // Handle different mesh types
+    bool exported = false;
     if (p_mesh->get_class() == "BoxMesh") {
         Ref<BoxMesh> box_mesh = p_mesh;
-        pxr::UsdGeomCube cube = export_box(box_mesh, p_stage, p_path);
-        return cube.GetPrim();
+        exported = export_box(box_mesh, p_writer, p_path);
     } else if (p_mesh->get_class() == "SphereMesh") {
         Ref<SphereMesh> sphere_mesh = p_mesh;
-        pxr::UsdGeomSphere sphere = export_sphere(sphere_mesh, p_stage, p_path);
-        return sphere.GetPrim();
+        exported = export_sphere(sphere_mesh, p_writer, p_path);
     } else if (p_mesh->get_class() == "CylinderMesh") {
         Ref<CylinderMesh> cylinder_mesh = p_mesh;
         
         // Check if it's a cone (top radius = 0)
         if (cylinder_mesh->get_top_radius() < 0.0001) {
-            pxr::UsdGeomCone cone = export_cone(cylinder_mesh, p_stage, p_path);
-            return cone.GetPrim();
+            exported = export_cone(cylinder_mesh, p_writer, p_path);
         } else {
-            pxr::UsdGeomCylinder cylinder = export_cylinder(cylinder_mesh, p_stage, p_path);
-            return cylinder.GetPrim();
+            exported = export_cylinder(cylinder_mesh, p_writer, p_path);
         }
     } else if (p_mesh->get_class() == "CapsuleMesh") {
         Ref<CapsuleMesh> capsule_mesh = p_mesh;
-        pxr::UsdGeomCapsule capsule = export_capsule(capsule_mesh, p_stage, p_path);
-        return capsule.GetPrim();
+        exported = export_capsule(capsule_mesh, p_writer, p_path);
     } else {
-        // Generic mesh
-        pxr::UsdGeomMesh mesh = export_geom_mesh(p_mesh, p_stage, p_path);
-        return mesh.GetPrim();
+        // Generic mesh; geometry and bindings are authored by
+        // export_queued_meshes
+        return queue_geom_mesh(p_mesh, p_surface_materials, p_writer, p_path);
     }
 
-    // Fallback for unsupported mesh types
-    UtilityFunctions::printerr("USD Export: Unsupported mesh type: ", p_mesh->get_class());
-    return pxr::UsdPrim();
+    // Primitives have a single surface
+    if (exported && !p_surface_materials.empty()) {
+        UsdMaterialExportHelper::bind_material(p_writer, p_path, p_surface_materials[0]);
+    }
+    return exported;
 }
 
-pxr::UsdGeomCube UsdMeshExportHelper::export_box(const Ref<BoxMesh> p_box, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_box(const Ref<BoxMesh> p_box, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Create a new USD cube
-    pxr::UsdGeomCube cube = pxr::UsdGeomCube::Define(p_stage, p_path);
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Cube"))) {
+        return false;
+    }
     
     // Get the size from the Godot box mesh
     Vector3 size = p_box->get_size(); // do not compensate the size, usd and godot agree
-    cube.GetSizeAttr().Set((double) size.x);
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->size, pxr::SdfValueTypeNames->Double, pxr::VtValue((double)size.x));
     
     // If the box is not uniform, we need to apply non-uniform scaling
     if (size.x != size.y || size.x != size.z) {
@@ -74,10 +81,9 @@ pxr::UsdGeomCube UsdMeshExportHelper::export_box(const Ref<BoxMesh> p_box, pxr::
         double scale_z = size.z / size.x;
         
         // Add a scale op to handle the non-uniform scaling
-        pxr::UsdGeomXformOp scaleOp = cube.AddScaleOp();
-        scaleOp.Set(pxr::GfVec3d(1.0, scale_y, scale_z));
-        
-        //UtilityFunctions::print("USD Export: Applied non-uniform scale (1.0, ", scale_y, ", ", scale_z, ") to cube");
+        static const pxr::TfToken scale_op("xformOp:scale");
+        p_writer.set_attribute(p_path, scale_op, pxr::SdfValueTypeNames->Double3, pxr::VtValue(pxr::GfVec3d(1.0, scale_y, scale_z)));
+        p_writer.set_xform_op_order(p_path, pxr::VtArray<pxr::TfToken>{ scale_op });
     }
     
     // Check if the box mesh has a material with a color
@@ -88,255 +94,367 @@ pxr::UsdGeomCube UsdMeshExportHelper::export_box(const Ref<BoxMesh> p_box, pxr::
             Ref<godot::StandardMaterial3D> std_material = material;
             Color color = std_material->get_albedo();
             
-            // Create a displayColor attribute
-            pxr::UsdAttribute displayColorAttr = cube.CreateDisplayColorPrimvar(pxr::UsdGeomTokens->constant);
-            
-            // Create a VtArray with a single color value
+            // Create a constant displayColor primvar with a single color value
             pxr::VtArray<pxr::GfVec3f> displayColors;
             displayColors.push_back(pxr::GfVec3f(color.r, color.g, color.b));
-            
-            // Set the color value
-            displayColorAttr.Set(displayColors);
+            p_writer.set_primvar(p_path, pxr::UsdGeomTokens->primvarsDisplayColor, pxr::SdfValueTypeNames->Color3fArray,
+                    pxr::VtValue(displayColors), pxr::UsdGeomTokens->constant);
             
             // Set the color space metadata to linear
-            displayColorAttr.SetColorSpace(pxr::TfToken("linear"));
-            
-            //UtilityFunctions::print("USD Export: Applied material color (", color.r, ", ", color.g, ", ", color.b, ") to cube");
+            p_writer.set_attribute_metadata(p_path, pxr::UsdGeomTokens->primvarsDisplayColor, pxr::SdfFieldKeys->ColorSpace,
+                    pxr::VtValue(pxr::TfToken("linear")));
         }
     }
     
-    //UtilityFunctions::print("USD Export: Exported box with size ", size);
-    
-    return cube;
+    return true;
 }
 
-pxr::UsdGeomSphere UsdMeshExportHelper::export_sphere(const Ref<SphereMesh> p_sphere, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_sphere(const Ref<SphereMesh> p_sphere, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Create a new USD sphere
-    pxr::UsdGeomSphere sphere = pxr::UsdGeomSphere::Define(p_stage, p_path);
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Sphere"))) {
+        return false;
+    }
     
     // Get the radius from the Godot sphere mesh
     double radius = p_sphere->get_radius();
     
     // Set the radius
-    sphere.GetRadiusAttr().Set(radius);
-    
-    //UtilityFunctions::print("USD Export: Exported sphere with radius ", radius);
-    return sphere;
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->radius, pxr::SdfValueTypeNames->Double, pxr::VtValue(radius));
+    return true;
 }
 
-pxr::UsdGeomCylinder UsdMeshExportHelper::export_cylinder(const Ref<CylinderMesh> p_cylinder, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_cylinder(const Ref<CylinderMesh> p_cylinder, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Create a new USD cylinder
-    pxr::UsdGeomCylinder cylinder = pxr::UsdGeomCylinder::Define(p_stage, p_path);
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Cylinder"))) {
+        return false;
+    }
     
     // Get the radius and height from the Godot cylinder mesh
     double radius = p_cylinder->get_bottom_radius(); // Use bottom radius for now
     double height = p_cylinder->get_height();
     
     // Set the radius and height
-    cylinder.GetRadiusAttr().Set(radius);
-    cylinder.GetHeightAttr().Set(height);
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->radius, pxr::SdfValueTypeNames->Double, pxr::VtValue(radius));
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->height, pxr::SdfValueTypeNames->Double, pxr::VtValue(height));
     
     // Handle non-uniform scaling if top and bottom radii are different
     if (p_cylinder->get_top_radius() != p_cylinder->get_bottom_radius()) {
         UtilityFunctions::print("USD Export: Warning - USD cylinders don't support different top and bottom radii. Using bottom radius.");
     }
     
-    //UtilityFunctions::print("USD Export: Exported cylinder with radius ", radius, " and height ", height);
-    
-    return cylinder;
+    return true;
 }
 
-pxr::UsdGeomCone UsdMeshExportHelper::export_cone(const Ref<CylinderMesh> p_cone, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_cone(const Ref<CylinderMesh> p_cone, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Create a new USD cone
-    pxr::UsdGeomCone cone = pxr::UsdGeomCone::Define(p_stage, p_path);
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Cone"))) {
+        return false;
+    }
     
     // Get the radius and height from the Godot cone mesh (which is a cylinder with top radius = 0)
     double radius = p_cone->get_bottom_radius();
     double height = p_cone->get_height();
     
     // Set the radius and height
-    cone.GetRadiusAttr().Set(radius);
-    cone.GetHeightAttr().Set(height);
-    
-    //UtilityFunctions::print("USD Export: Exported cone with radius ", radius, " and height ", height);
-    return cone;
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->radius, pxr::SdfValueTypeNames->Double, pxr::VtValue(radius));
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->height, pxr::SdfValueTypeNames->Double, pxr::VtValue(height));
+    return true;
 }
 
-pxr::UsdGeomCapsule UsdMeshExportHelper::export_capsule(const Ref<CapsuleMesh> p_capsule, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
+bool UsdMeshExportHelper::export_capsule(const Ref<CapsuleMesh> p_capsule, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Create a new USD capsule
-    pxr::UsdGeomCapsule capsule = pxr::UsdGeomCapsule::Define(p_stage, p_path);
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Capsule"))) {
+        return false;
+    }
     
     // Get the radius and height from the Godot capsule mesh
     double radius = p_capsule->get_radius();
     double height = p_capsule->get_height();
     
     // Set the radius and height
-    capsule.GetRadiusAttr().Set(radius);
-    capsule.GetHeightAttr().Set(height);
-    
-    //UtilityFunctions::print("USD Export: Exported capsule with radius ", radius, " and height ", height);
-    return capsule;
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->radius, pxr::SdfValueTypeNames->Double, pxr::VtValue(radius));
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->height, pxr::SdfValueTypeNames->Double, pxr::VtValue(height));
+    return true;
 }
 
-pxr::UsdGeomMesh UsdMeshExportHelper::export_geom_mesh(const Ref<Mesh> p_mesh, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path) {
-    // Create a new USD mesh
-    pxr::UsdGeomMesh mesh = pxr::UsdGeomMesh::Define(p_stage, p_path);
-    
+bool UsdMeshExportHelper::queue_geom_mesh(const Ref<Mesh> p_mesh, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
     // Get the mesh data from Godot
     if (p_mesh.is_null()) {
         UtilityFunctions::printerr("USD Export: Invalid mesh");
-        return mesh;
+        return false;
     }
-    
-    // Get the surface count
-    int surface_count = p_mesh->get_surface_count();
-    if (surface_count == 0) {
-        UtilityFunctions::printerr("USD Export: Mesh has no surfaces");
-        return mesh;
+
+    // Meshes shared between nodes are fetched and converted once
+    auto found = _source_indices.find(p_mesh->get_instance_id());
+    if (found == _source_indices.end()) {
+        // Get the surface count
+        int surface_count = p_mesh->get_surface_count();
+        if (surface_count == 0) {
+            UtilityFunctions::printerr("USD Export: Mesh has no surfaces");
+            return false;
+        }
+
+        UsdMeshExportSource source;
+        source.name = String(p_mesh->get_name()).utf8().get_data();
+        source.surfaces.resize(surface_count);
+        for (int surface = 0; surface < surface_count; ++surface) {
+            // Lines and points have no faces to put in a UsdGeomMesh
+            if (p_mesh->surface_get_primitive_type(surface) != Mesh::PRIMITIVE_TRIANGLES) {
+                UtilityFunctions::print("USD Export: Skipping non-triangle surface ", surface, " of ", p_mesh->get_name());
+                continue;
+            }
+            Array arrays = p_mesh->surface_get_arrays(surface);
+            if (arrays.size() == 0) {
+                UtilityFunctions::printerr("USD Export: Failed to get surface arrays");
+                continue;
+            }
+
+            UsdMeshExportSurface &arrays_out = source.surfaces[surface];
+            arrays_out.vertices = arrays[Mesh::ARRAY_VERTEX];
+            arrays_out.indices = arrays[Mesh::ARRAY_INDEX];
+            arrays_out.normals = arrays[Mesh::ARRAY_NORMAL];
+            arrays_out.uvs = arrays[Mesh::ARRAY_TEX_UV];
+        }
+
+        bool has_vertices = false;
+        for (const UsdMeshExportSurface &surface : source.surfaces) {
+            has_vertices = has_vertices || surface.vertices.size() > 0;
+        }
+        if (!has_vertices) {
+            UtilityFunctions::printerr("USD Export: Mesh has no vertices");
+            return false;
+        }
+
+        found = _source_indices.emplace(p_mesh->get_instance_id(), _sources.size()).first;
+        _sources.push_back(source);
     }
-    
-    // For now, we'll just export the first surface
-    // In a full implementation, we would handle multiple surfaces
-    Array arrays = p_mesh->surface_get_arrays(0);
-    if (arrays.size() == 0) {
-        UtilityFunctions::printerr("USD Export: Failed to get surface arrays");
-        return mesh;
+
+    // Create a new USD mesh
+    if (!p_writer.define_prim(p_path, pxr::TfToken("Mesh"))) {
+        return false;
     }
-    
-    // Get the vertices
-    PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
-    if (vertices.size() == 0) {
-        UtilityFunctions::printerr("USD Export: Mesh has no vertices");
-        return mesh;
+
+    QueuedMesh queued;
+    queued.source = found->second;
+    queued.path = p_path;
+    queued.surface_materials = p_surface_materials;
+    _queued.push_back(queued);
+    return true;
+}
+
+void UsdMeshExportHelper::build_mesh_data(const UsdMeshExportSource &p_source, UsdMeshExportData *r_data) {
+    // Sizes of the merged arrays; surfaces without normals or UVs are
+    // zero-filled when another surface has them, so the primvars stay
+    // per-vertex
+    size_t point_count = 0;
+    size_t corner_count = 0;
+    bool has_normals = false;
+    bool has_uvs = false;
+    for (const UsdMeshExportSurface &surface : p_source.surfaces) {
+        const int64_t vertex_count = surface.vertices.size();
+        point_count += vertex_count;
+        corner_count += surface.indices.size() > 0 ? surface.indices.size() : vertex_count;
+        has_normals = has_normals || (vertex_count > 0 && surface.normals.size() == vertex_count);
+        has_uvs = has_uvs || (vertex_count > 0 && surface.uvs.size() == vertex_count);
     }
-    
-    // Get the indices
-    PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
-    bool has_indices = indices.size() > 0;
-    
-    // Get the normals
-    PackedVector3Array normals = arrays[Mesh::ARRAY_NORMAL];
-    bool has_normals = normals.size() > 0;
-    
-    // Get the UVs
-    PackedVector2Array uvs = arrays[Mesh::ARRAY_TEX_UV];
-    bool has_uvs = uvs.size() > 0;
-    
-    // Convert vertices to USD format
-    pxr::VtArray<pxr::GfVec3f> usd_points;
-    usd_points.reserve(vertices.size());
-    for (int i = 0; i < vertices.size(); i++) {
-        Vector3 v = vertices[i];
-        usd_points.push_back(pxr::GfVec3f(v.x, v.y, v.z));
+
+    r_data->points.resize(point_count);
+    r_data->face_vertex_indices.resize(corner_count);
+    if (has_normals) {
+        r_data->normals.assign(point_count, pxr::GfVec3f(0.0f));
     }
-    
-    // Set the points attribute
-    mesh.GetPointsAttr().Set(usd_points);
-    
-    // Convert indices to USD format
-    if (has_indices) {
-        // USD expects face vertex counts and face vertex indices
-        // Face vertex counts is the number of vertices per face (e.g., 3 for triangles)
-        // Face vertex indices is the list of vertex indices for each face
-        
-        // Assuming triangles for now
-        int face_count = indices.size() / 3;
-        
-        pxr::VtArray<int> face_vertex_counts;
-        face_vertex_counts.reserve(face_count);
-        
-        for (int i = 0; i < face_count; i++) {
-            face_vertex_counts.push_back(3); // 3 vertices per triangle
+    if (has_uvs) {
+        r_data->uvs.assign(point_count, pxr::GfVec2f(0.0f));
+    }
+    const bool use_subsets = p_source.surfaces.size() > 1;
+    if (use_subsets) {
+        r_data->subset_faces.resize(p_source.surfaces.size());
+    }
+
+    int *indices = r_data->face_vertex_indices.data();
+    size_t point_base = 0;
+    size_t corner_base = 0;
+    for (size_t surface_index = 0; surface_index < p_source.surfaces.size(); ++surface_index) {
+        const UsdMeshExportSurface &surface = p_source.surfaces[surface_index];
+        const int64_t vertex_count = surface.vertices.size();
+
+        // Convert vertices to USD format
+        UsdArrayUtils::to_vt_array(surface.vertices, &r_data->points, point_base);
+        if (has_normals && surface.normals.size() == vertex_count) {
+            UsdArrayUtils::to_vt_array(surface.normals, &r_data->normals, point_base);
         }
-        
-        pxr::VtArray<int> face_vertex_indices;
-        face_vertex_indices.reserve(indices.size());
-        
-        for (int i = 0; i < indices.size(); i++) {
-            face_vertex_indices.push_back(indices[i]);
+        if (has_uvs && surface.uvs.size() == vertex_count) {
+            UsdArrayUtils::to_vt_array(surface.uvs, &r_data->uvs, point_base);
         }
-        
-        // Set the face vertex counts and indices
-        mesh.GetFaceVertexCountsAttr().Set(face_vertex_counts);
-        mesh.GetFaceVertexIndicesAttr().Set(face_vertex_indices);
-    } else {
-        // If there are no indices, assume each set of 3 vertices forms a triangle
-        int face_count = vertices.size() / 3;
-        
-        pxr::VtArray<int> face_vertex_counts;
-        face_vertex_counts.reserve(face_count);
-        
-        for (int i = 0; i < face_count; i++) {
-            face_vertex_counts.push_back(3); // 3 vertices per triangle
+
+        // Indices are offset into the merged point list. If there are no
+        // indices, each set of 3 vertices forms a triangle.
+        const int64_t corners = surface.indices.size() > 0 ? surface.indices.size() : vertex_count;
+        const int32_t *src = surface.indices.ptr();
+        for (int64_t i = 0; i < corners; ++i) {
+            indices[corner_base + i] = (int)point_base + (src ? src[i] : (int)i);
         }
-        
-        pxr::VtArray<int> face_vertex_indices;
-        face_vertex_indices.reserve(vertices.size());
-        
-        for (int i = 0; i < vertices.size(); i++) {
-            face_vertex_indices.push_back(i);
+
+        if (use_subsets) {
+            pxr::VtArray<int> &faces = r_data->subset_faces[surface_index];
+            const int first_face = (int)(corner_base / 3);
+            faces.resize(corners / 3);
+            int *face_dst = faces.data();
+            for (int64_t face = 0; face < corners / 3; ++face) {
+                face_dst[face] = first_face + (int)face;
+            }
         }
-        
-        // Set the face vertex counts and indices
-        mesh.GetFaceVertexCountsAttr().Set(face_vertex_counts);
-        mesh.GetFaceVertexIndicesAttr().Set(face_vertex_indices);
+
+        point_base += vertex_count;
+        corner_base += corners;
     }
-    
-    // Convert normals to USD format
-    if (has_normals) {
-        pxr::VtArray<pxr::GfVec3f> usd_normals;
-        usd_normals.reserve(normals.size());
-        
-        for (int i = 0; i < normals.size(); i++) {
-            Vector3 n = normals[i];
-            usd_normals.push_back(pxr::GfVec3f(n.x, n.y, n.z));
+
+    // Triangles only
+    r_data->face_vertex_counts.assign(r_data->face_vertex_indices.size() / 3, 3);
+
+    // Godot's V runs down the texture, st's runs up; the importer flips back
+    if (has_uvs) {
+        UsdArrayUtils::flip_v(&r_data->uvs);
+    }
+}
+
+void UsdMeshExportHelper::export_queued_meshes(UsdLayerWriter &p_writer, int p_thread_count) {
+    if (_queued.empty()) {
+        return;
+    }
+
+    // Parallel phase: packed arrays to VtArrays, one unique mesh per task
+    std::vector<UsdMeshExportData> data(_sources.size());
+    UsdParallel::for_range(_sources.size(), UsdParallel::resolve_thread_count(p_thread_count), [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t i = p_begin; i < p_end; ++i) {
+            build_mesh_data(_sources[i], &data[i]);
         }
-        
-        // Set the normals attribute
-        mesh.GetNormalsAttr().Set(usd_normals);
-        
-        // Set the interpolation to "vertex" for per-vertex normals
-        // Note: Normals are already per-vertex in USD by default
-        mesh.SetNormalsInterpolation(pxr::UsdGeomTokens->vertex);
+    });
+
+    // Meshes used by several prims become prototypes when a scope is set
+    std::vector<int64_t> use_counts(_sources.size(), 0);
+    for (const QueuedMesh &queued : _queued) {
+        use_counts[queued.source]++;
     }
-    
-    // Convert UVs to USD format
-    if (has_uvs) {
-        pxr::VtArray<pxr::GfVec2f> usd_uvs;
-        usd_uvs.reserve(uvs.size());
-        
-        for (int i = 0; i < uvs.size(); i++) {
-            Vector2 uv = uvs[i];
-            usd_uvs.push_back(pxr::GfVec2f(uv.x, uv.y));
+    std::vector<pxr::SdfPath> prototype_paths(_sources.size());
+    if (!_prototype_scope.IsEmpty()) {
+        for (size_t i = 0; i < _sources.size(); ++i) {
+            if (use_counts[i] < 2) {
+                continue;
+            }
+            prototype_paths[i] = define_prototype(_sources[i].name, p_writer);
+            if (!prototype_paths[i].IsEmpty()) {
+                author_geom_mesh(data[i], p_writer, prototype_paths[i]);
+            }
         }
-        
-        // Create a primvar for the UVs
-        // Use the standard "st" name for texture coordinates
-        pxr::UsdAttribute st_attr = mesh.GetPrim().CreateAttribute(
-            pxr::TfToken("primvars:st"), 
-            pxr::SdfValueTypeNames->Float2Array
-        );
-        
-        // Set the UVs
-        st_attr.Set(usd_uvs);
-        
-        // Set the interpolation to "vertex" for per-vertex UVs
-        pxr::UsdAttribute st_interp_attr = mesh.GetPrim().CreateAttribute(
-            pxr::TfToken("primvars:st:interpolation"),
-            pxr::SdfValueTypeNames->Token
-        );
-        st_interp_attr.Set(pxr::UsdGeomTokens->vertex);
     }
-    
-    //UtilityFunctions::print("USD Export: Exported mesh with ", vertices.size(), " vertices and ", (has_indices ? indices.size() / 3 : vertices.size() / 3), " triangles");
-    return mesh;
+
+    // Serial phase: author specs. Prims sharing a mesh share the VtArray
+    // buffers as well.
+    for (const QueuedMesh &queued : _queued) {
+        const pxr::SdfPath &prototype_path = prototype_paths[queued.source];
+        if (prototype_path.IsEmpty()) {
+            author_geom_mesh(data[queued.source], p_writer, queued.path);
+        } else {
+            p_writer.add_internal_reference(queued.path, prototype_path);
+        }
+        bind_surface_materials(data[queued.source], queued.surface_materials, p_writer, queued.path);
+        _surface_count += (int64_t)_sources[queued.source].surfaces.size();
+    }
+
+    _mesh_count += (int64_t)_queued.size();
+    _unique_mesh_count += (int64_t)_sources.size();
+    _queued.clear();
+    _sources.clear();
+    _source_indices.clear();
 }
 
-void UsdMeshExportHelper::apply_non_uniform_scale(pxr::UsdGeomGprim& p_gprim, const pxr::GfVec3f& p_scale) {
-    // This is a stub implementation for now
-    // In a full implementation, we would apply non-uniform scaling to the mesh
-    
-    UtilityFunctions::print("USD Export: Non-uniform scale application not yet implemented");
+pxr::SdfPath UsdMeshExportHelper::define_prototype(const std::string &p_name, UsdLayerWriter &p_writer) {
+    if (!_prototype_scope_defined) {
+        _prototype_scope_defined = p_writer.define_prim(_prototype_scope, pxr::TfToken(), pxr::SdfSpecifierClass);
+        if (!_prototype_scope_defined) {
+            UtilityFunctions::printerr("USD Export: Failed to define the mesh prototype scope");
+            return pxr::SdfPath();
+        }
+    }
+
+    // Prim name from the mesh resource name, made unique within the scope
+    const std::string base_name = p_name.empty() ? std::string("Mesh") : pxr::TfMakeValidIdentifier(p_name);
+    std::string name = base_name;
+    for (int suffix = 1; _prototype_names.count(name) > 0; ++suffix) {
+        name = base_name + "_" + std::to_string(suffix);
+    }
+
+    const pxr::SdfPath prototype_path = _prototype_scope.AppendChild(pxr::TfToken(name));
+    if (!p_writer.define_prim(prototype_path, pxr::TfToken("Mesh"))) {
+        return pxr::SdfPath();
+    }
+    _prototype_names.insert(name);
+    _prototype_count++;
+    return prototype_path;
+}
+
+void UsdMeshExportHelper::author_geom_mesh(const UsdMeshExportData &p_data, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
+    // Set the points, face vertex counts and indices
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->points, pxr::SdfValueTypeNames->Point3fArray, pxr::VtValue(p_data.points));
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->faceVertexCounts, pxr::SdfValueTypeNames->IntArray, pxr::VtValue(p_data.face_vertex_counts));
+    p_writer.set_attribute(p_path, pxr::UsdGeomTokens->faceVertexIndices, pxr::SdfValueTypeNames->IntArray, pxr::VtValue(p_data.face_vertex_indices));
+
+    if (!p_data.normals.empty()) {
+        // Normals are per-vertex, like the points
+        p_writer.set_primvar(p_path, pxr::UsdGeomTokens->normals, pxr::SdfValueTypeNames->Normal3fArray,
+                pxr::VtValue(p_data.normals), pxr::UsdGeomTokens->vertex);
+    }
+
+    if (!p_data.uvs.empty()) {
+        // Use the standard "st" primvar name for texture coordinates,
+        // per-vertex like the points
+        p_writer.set_primvar(p_path, pxr::TfToken("primvars:st"), pxr::SdfValueTypeNames->TexCoord2fArray,
+                pxr::VtValue(p_data.uvs), pxr::UsdGeomTokens->vertex);
+    }
+
+    if (p_data.subset_faces.empty()) {
+        return;
+    }
+
+    // One GeomSubset per surface; together they cover every face once
+    static const pxr::TfToken family_type("subsetFamily:materialBind:familyType");
+    p_writer.set_attribute(p_path, family_type, pxr::SdfValueTypeNames->Token, pxr::VtValue(pxr::UsdGeomTokens->partition), pxr::SdfVariabilityUniform);
+    for (size_t surface = 0; surface < p_data.subset_faces.size(); ++surface) {
+        // Skipped (non-triangle) surfaces have no faces
+        if (p_data.subset_faces[surface].empty()) {
+            continue;
+        }
+        const pxr::SdfPath subset_path = p_path.AppendChild(pxr::TfToken("Surface_" + std::to_string(surface)));
+        p_writer.define_prim(subset_path, pxr::TfToken("GeomSubset"));
+        p_writer.set_attribute(subset_path, pxr::UsdGeomTokens->elementType, pxr::SdfValueTypeNames->Token,
+                pxr::VtValue(pxr::UsdGeomTokens->face), pxr::SdfVariabilityUniform);
+        p_writer.set_attribute(subset_path, pxr::UsdGeomTokens->familyName, pxr::SdfValueTypeNames->Token,
+                pxr::VtValue(pxr::TfToken("materialBind")), pxr::SdfVariabilityUniform);
+        p_writer.set_attribute(subset_path, pxr::UsdGeomTokens->indices, pxr::SdfValueTypeNames->IntArray, pxr::VtValue(p_data.subset_faces[surface]));
+    }
+}
+
+void UsdMeshExportHelper::bind_surface_materials(const UsdMeshExportData &p_data, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path) {
+    if (p_data.subset_faces.empty()) {
+        if (!p_surface_materials.empty()) {
+            UsdMaterialExportHelper::bind_material(p_writer, p_path, p_surface_materials[0]);
+        }
+        return;
+    }
+
+    // Bindings live on the using prim's side, so prims referencing one
+    // prototype can bind different materials. Subsets that came in
+    // through a reference get an over.
+    for (size_t surface = 0; surface < p_data.subset_faces.size() && surface < p_surface_materials.size(); ++surface) {
+        if (p_data.subset_faces[surface].empty() || p_surface_materials[surface].IsEmpty()) {
+            continue;
+        }
+        const pxr::SdfPath subset_path = p_path.AppendChild(pxr::TfToken("Surface_" + std::to_string(surface)));
+        if (p_writer.override_prim(subset_path)) {
+            UsdMaterialExportHelper::bind_material(p_writer, subset_path, p_surface_materials[surface]);
+        }
+    }
 }
 
 } // namespace godot
@@ -13,40 +13,115 @@
 #include <godot_cpp/variant/utility_functions.hpp>
 
 // USD headers
-#include <pxr/usd/usd/stage.h>
-#include <pxr/usd/usdGeom/gprim.h>
-#include <pxr/usd/usdGeom/cube.h>
-#include <pxr/usd/usdGeom/sphere.h>
-#include <pxr/usd/usdGeom/cone.h>
-#include <pxr/usd/usdGeom/cylinder.h>
-#include <pxr/usd/usdGeom/capsule.h>
-#include <pxr/usd/usdGeom/mesh.h>
-#include <pxr/base/gf/vec3f.h>
 #include <pxr/usd/sdf/path.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/vt/array.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
 namespace godot {
 
+class UsdLayerWriter;
+
+// Arrays of one triangle surface, fetched on the main thread
+struct UsdMeshExportSurface {
+    PackedVector3Array vertices;
+    PackedInt32Array indices;
+    PackedVector3Array normals;
+    PackedVector2Array uvs;
+};
+
+// Every triangle surface of a Godot mesh, in surface order
+struct UsdMeshExportSource {
+    std::string name; // resource name, used for prototype prims
+    std::vector<UsdMeshExportSurface> surfaces;
+};
+
+// UsdGeomMesh attribute values converted from a UsdMeshExportSource. Built
+// without touching Godot objects, so it can be filled on worker threads.
+// Surfaces are merged into one point list; with more than one surface,
+// subset_faces holds each surface's face indices for its GeomSubset.
+struct UsdMeshExportData {
+    pxr::VtArray<pxr::GfVec3f> points;
+    pxr::VtArray<int> face_vertex_counts;
+    pxr::VtArray<int> face_vertex_indices;
+    pxr::VtArray<pxr::GfVec3f> normals;
+    pxr::VtArray<pxr::GfVec2f> uvs;
+    std::vector<pxr::VtArray<int>> subset_faces;
+};
+
 class UsdMeshExportHelper {
 public:
     UsdMeshExportHelper();
     ~UsdMeshExportHelper();
 
-    // Export a Godot mesh to a USD prim
-    pxr::UsdPrim export_mesh_to_prim(const Ref<Mesh> p_mesh, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
+    // Export a Godot mesh as a prim at p_path, authored directly into the
+    // writer's layer. Primitive meshes are written immediately; other
+    // meshes get their prim now and their geometry from
+    // export_queued_meshes(). p_surface_materials holds the Material prim
+    // bound to each surface (empty paths are left unbound). Returns false
+    // if nothing was written.
+    bool export_mesh_to_prim(const Ref<Mesh> p_mesh, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+
+    // Scope for meshes used by more than one prim. Each such mesh is
+    // authored once as a child of the scope, and every prim using it gets
+    // an internal reference plus its own material bindings. The scope is a
+    // class, so the prototypes themselves are not rendered. An empty path
+    // (the default) writes every prim's geometry inline.
+    void set_prototype_scope(const pxr::SdfPath &p_scope_path) { _prototype_scope = p_scope_path; }
+
+    // Convert every queued mesh on worker threads (thread count zero means
+    // one per core), then author the attributes on the calling thread.
+    // Meshes shared by several prims are converted once.
+    void export_queued_meshes(UsdLayerWriter &p_writer, int p_thread_count);
+
+    int64_t get_mesh_count() const { return _mesh_count; }
+    int64_t get_unique_mesh_count() const { return _unique_mesh_count; }
+    int64_t get_prototype_count() const { return _prototype_count; }
+    int64_t get_surface_count() const { return _surface_count; }
+
+    // Convert surface arrays to attribute values; safe on any thread
+    static void build_mesh_data(const UsdMeshExportSource &p_source, UsdMeshExportData *r_data);
 
 private:
     // Helper methods for specific primitive types
-    pxr::UsdGeomCube export_box(const Ref<BoxMesh> p_box, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-    pxr::UsdGeomSphere export_sphere(const Ref<SphereMesh> p_sphere, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-    pxr::UsdGeomCylinder export_cylinder(const Ref<CylinderMesh> p_cylinder, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-    pxr::UsdGeomCone export_cone(const Ref<CylinderMesh> p_cone, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-    pxr::UsdGeomCapsule export_capsule(const Ref<CapsuleMesh> p_capsule, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-    pxr::UsdGeomMesh export_geom_mesh(const Ref<Mesh> p_mesh, pxr::UsdStageRefPtr p_stage, const pxr::SdfPath& p_path);
-
-    // Helper method to handle non-uniform scaling
-    void apply_non_uniform_scale(pxr::UsdGeomGprim& p_gprim, const pxr::GfVec3f& p_scale);
+    bool export_box(const Ref<BoxMesh> p_box, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    bool export_sphere(const Ref<SphereMesh> p_sphere, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    bool export_cylinder(const Ref<CylinderMesh> p_cylinder, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    bool export_cone(const Ref<CylinderMesh> p_cone, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    bool export_capsule(const Ref<CapsuleMesh> p_capsule, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    bool queue_geom_mesh(const Ref<Mesh> p_mesh, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+
+    void author_geom_mesh(const UsdMeshExportData &p_data, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    void bind_surface_materials(const UsdMeshExportData &p_data, const pxr::SdfPathVector &p_surface_materials, UsdLayerWriter &p_writer, const pxr::SdfPath& p_path);
+    pxr::SdfPath define_prototype(const std::string &p_name, UsdLayerWriter &p_writer);
+
+    // Surface arrays are read from the RenderingServer, so they are fetched
+    // on the main thread when a mesh is queued; one source per Mesh
+    std::vector<UsdMeshExportSource> _sources;
+    std::unordered_map<uint64_t, size_t> _source_indices;
+
+    struct QueuedMesh {
+        size_t source = 0;
+        pxr::SdfPath path;
+        pxr::SdfPathVector surface_materials;
+    };
+    std::vector<QueuedMesh> _queued;
+
+    int64_t _mesh_count = 0;
+    int64_t _unique_mesh_count = 0;
+    int64_t _surface_count = 0;
+
+    pxr::SdfPath _prototype_scope;
+    bool _prototype_scope_defined = false;
+    std::set<std::string> _prototype_names;
+    int64_t _prototype_count = 0;
 };
 
 } // namespace godot
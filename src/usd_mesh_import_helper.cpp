@@ -1,7 +1,21 @@
 #include "usd_mesh_import_helper.h"
+#include "usd_array_utils.h"
+#include "usd_parallel.h"
+#include "usd_mesh_normals.h"
+#include "usd_mesh_disk_cache.h"
 #include <godot_cpp/variant/utility_functions.hpp>
-#include <godot_cpp/classes/standard_material3d.hpp>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
+#include <pxr/usd/usdGeom/subset.h>
+#include <pxr/usd/usdShade/materialBindingAPI.h>
+#include <pxr/base/gf/vec2f.h>
+#include <pxr/base/gf/vec4f.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 namespace godot {
 
@@ -72,42 +86,6 @@ Ref<BoxMesh> UsdMeshImportHelper::import_cube(const UsdPrim &p_prim) {
     return box_mesh;
 }
 
-Ref<StandardMaterial3D> UsdMeshImportHelper::create_material(const UsdPrim &p_prim) {
-    Ref<StandardMaterial3D> stdMaterial;
-    // Check for displayColor attribute
-    UsdPrim usdPrim(p_prim);
-    if (usdPrim.HasAttribute(TfToken("primvars:displayColor"))) {
-        // Get the display color
-        UsdAttribute displayColorAttr = usdPrim.GetAttribute(TfToken("primvars:displayColor"));
-        VtArray<GfVec3f> displayColors;
-        if (displayColorAttr.Get(&displayColors) && !displayColors.empty()) {
-            // Check for colorSpace metadata
-            std::string colorSpace = "srgb";
-            // In the example, colorSpace is a metadata on the displayColor attribute
-            TfToken colorSpaceToken("colorSpace");
-            if (displayColorAttr.HasMetadata(colorSpaceToken)) {
-                std::string colorSpaceValue;
-                displayColorAttr.GetMetadata(colorSpaceToken, &colorSpaceValue);
-                colorSpace = colorSpaceValue;
-            }
-            // Create a simple material
-            Ref<Material> material;
-            material.instantiate();
-            
-            // Set the albedo color from the displayColor
-            GfVec3f color = displayColors[0];
-
-            // Create a StandardMaterial3D
-            stdMaterial.instantiate();
-            
-            // Set the albedo color from the displayColor
-            Color godotColor(color[0], color[1], color[2]);
-            stdMaterial->set_albedo(godotColor);
-        }
-    }
-    return stdMaterial;
-}
-
 Ref<SphereMesh> UsdMeshImportHelper::import_sphere(const pxr::UsdGeomSphere& p_sphere) {
     // Create a new SphereMesh
     Ref<SphereMesh> sphere_mesh;
@@ -184,194 +162,899 @@ Ref<CapsuleMesh> UsdMeshImportHelper::import_capsule(const pxr::UsdGeomCapsule&
     return capsule_mesh;
 }
 
-// Helper to get the value of a primvar at a specific index
-static bool _GetPrimvarVec3fAtIndex(const UsdGeomPrimvar& primvar, int index, GfVec3f* out) {
-    VtArray<GfVec3f> array;
-    if (!primvar.Get(&array) || index >= array.size()) return false;
-    *out = array[index];
-    return true;
-}
+// Flattened view of a primvar. The value array is fetched (and de-indexed)
+// exactly once per mesh so the per-corner loop only touches raw memory.
+template <typename T>
+struct _PrimvarSpan {
+    VtArray<T> values;
+    TfToken interpolation = UsdGeomTokens->vertex;
+    const T *data = nullptr;
+    size_t size = 0;
 
-static bool _GetPrimvarVec2fAtIndex(const UsdGeomPrimvar& primvar, int index, GfVec2f* out) {
-    VtArray<GfVec2f> array;
-    if (!primvar.Get(&array) || index >= array.size()) return false;
-    *out = array[index];
-    return true;
-}
+    bool fetch(const UsdGeomPrimvar &p_primvar) {
+        if (!p_primvar.IsDefined() || !p_primvar.ComputeFlattened(&values) || values.empty()) {
+            return false;
+        }
+        interpolation = p_primvar.GetInterpolation();
+        data = values.cdata();
+        size = values.size();
+        return true;
+    }
 
-static bool _GetPrimvarColorAtIndex(const UsdGeomPrimvar& primvar, int index, GfVec4f* out) {
-    VtArray<GfVec4f> array4;
-    if (primvar.Get(&array4) && index < array4.size()) {
-        *out = array4[index];
+    // Plain (non-primvar) attributes such as UsdGeomMesh's "normals"
+    bool fetch(const UsdAttribute &p_attr, const TfToken &p_interpolation) {
+        if (!p_attr || !p_attr.Get(&values) || values.empty()) {
+            return false;
+        }
+        interpolation = p_interpolation;
+        data = values.cdata();
+        size = values.size();
         return true;
     }
-    VtArray<GfVec3f> array3;
-    if (primvar.Get(&array3) && index < array3.size()) {
-        GfVec3f v = array3[index];
-        *out = GfVec4f(v[0], v[1], v[2], 1.0f);
+
+    // Resolve the element index for one triangle corner, or -1 if the
+    // primvar has no value there. p_face_vertex is the corner's position in
+    // faceVertexIndices, which is what faceVarying data is indexed by.
+    int64_t index_for(size_t p_face, int p_point, size_t p_face_vertex) const {
+        if (!data) {
+            return -1;
+        }
+        int64_t index = -1;
+        if (interpolation == UsdGeomTokens->constant) {
+            index = 0;
+        } else if (interpolation == UsdGeomTokens->uniform) {
+            index = (int64_t)p_face;
+        } else if (interpolation == UsdGeomTokens->vertex || interpolation == UsdGeomTokens->varying) {
+            index = p_point;
+        } else if (interpolation == UsdGeomTokens->faceVarying) {
+            index = (int64_t)p_face_vertex;
+        }
+        return (index >= 0 && (size_t)index < size) ? index : -1;
+    }
+};
+
+// displayColor is usually color3f[], but accept color4f[] as well. Either
+// way the result is widened to RGBA once, up front.
+static bool _FetchColorSpan(const UsdGeomPrimvar &p_primvar, _PrimvarSpan<GfVec4f> *r_span) {
+    if (r_span->fetch(p_primvar)) {
         return true;
     }
-    return false;
+    _PrimvarSpan<GfVec3f> rgb;
+    if (!rgb.fetch(p_primvar)) {
+        return false;
+    }
+    r_span->values.resize(rgb.size);
+    GfVec4f *dst = r_span->values.data();
+    for (size_t i = 0; i < rgb.size; ++i) {
+        dst[i] = GfVec4f(rgb.data[i][0], rgb.data[i][1], rgb.data[i][2], 1.0f);
+    }
+    r_span->interpolation = rgb.interpolation;
+    r_span->data = r_span->values.cdata();
+    r_span->size = rgb.size;
+    return true;
 }
 
-// Helper to resolve USD interpolation mode
-static pxr::TfToken _GetInterpolation(const pxr::UsdAttribute &attr) {
-    pxr::TfToken interp;
-    if (!attr.GetMetadata(pxr::UsdGeomTokens->interpolation, &interp))
-        return pxr::UsdGeomTokens->vertex; // fallback
-    return interp;
+// Check the topology once so the corner loop can index without bounds checks.
+static bool _ValidateTopology(const VtArray<int> &p_counts, const VtArray<int> &p_indices, size_t p_point_count) {
+    size_t expected = 0;
+    for (int count : p_counts) {
+        if (count < 0) {
+            return false;
+        }
+        expected += (size_t)count;
+    }
+    if (expected > p_indices.size()) {
+        return false;
+    }
+    for (int index : p_indices) {
+        if (index < 0 || (size_t)index >= p_point_count) {
+            return false;
+        }
+    }
+    return true;
 }
 
 
-Ref<Mesh> UsdMeshImportHelper::import_geom_mesh(const UsdGeomMesh& mesh) {
-    VtArray<GfVec3f> points;
-    if (!mesh.GetPointsAttr().Get(&points))
-        return Ref<Mesh>();
-
-    VtArray<int> faceVertexCounts;
-    VtArray<int> faceVertexIndices;
-    if (!mesh.GetFaceVertexCountsAttr().Get(&faceVertexCounts) ||
-        !mesh.GetFaceVertexIndicesAttr().Get(&faceVertexIndices))
-        return Ref<ArrayMesh>();
+// Faces that become one Godot surface
+struct _SurfaceFaces {
+    std::string name; // GeomSubset name, empty for faces no subset covers
+    std::vector<int> faces;
+};
 
-    const UsdGeomPrimvarsAPI primvars(mesh);
-    UsdGeomPrimvar normalPrimvar = primvars.GetPrimvar(TfToken("normals"));
-    UsdGeomPrimvar uvPrimvar = primvars.GetPrimvar(TfToken("st"));
-    UsdGeomPrimvar colorPrimvar = primvars.GetPrimvar(TfToken("displayColor"));
+// Everything read from a UsdGeomMesh, fetched once up front
+struct _MeshSource {
+    VtArray<GfVec3f> points;
+    VtArray<int> face_vertex_counts;
+    VtArray<int> face_vertex_indices;
+    _PrimvarSpan<GfVec3f> normals;
+    _PrimvarSpan<GfVec2f> uvs;
+    _PrimvarSpan<GfVec4f> colors;
 
-    // Get interpolation tokens
-    TfToken normalInterp = normalPrimvar.IsDefined() ? normalPrimvar.GetInterpolation() : UsdGeomTokens->vertex;
-    TfToken uvInterp = uvPrimvar.IsDefined() ? uvPrimvar.GetInterpolation() : UsdGeomTokens->vertex;
-    TfToken colorInterp = colorPrimvar.IsDefined() ? colorPrimvar.GetInterpolation() : UsdGeomTokens->vertex;
+    // One entry per surface when materialBind subsets split the mesh
+    std::vector<_SurfaceFaces> surfaces;
+};
 
+// Godot surface arrays under construction
+struct _MeshArrays {
     PackedVector3Array vertices;
     PackedVector3Array normals;
     PackedVector2Array uvs;
     PackedColorArray colors;
     PackedInt32Array indices;
+    int64_t corner_count = 0;
+};
+
+// Split the faces by materialBind GeomSubset, in GetMaterialBindSubsets
+// order, followed by the faces no subset covers. A face claimed by two
+// subsets stays with the first. Left empty when the mesh would end up as
+// a single unnamed surface anyway.
+static void _ReadSurfaceFaces(const UsdGeomMesh &p_mesh, size_t p_face_count, std::vector<_SurfaceFaces> *r_surfaces) {
+    const std::vector<UsdGeomSubset> subsets = UsdShadeMaterialBindingAPI(p_mesh.GetPrim()).GetMaterialBindSubsets();
+    if (subsets.empty()) {
+        return;
+    }
+
+    std::vector<bool> claimed(p_face_count, false);
+    for (const UsdGeomSubset &subset : subsets) {
+        TfToken element_type;
+        VtArray<int> indices;
+        if (!subset.GetElementTypeAttr().Get(&element_type) || element_type != UsdGeomTokens->face ||
+                !subset.GetIndicesAttr().Get(&indices)) {
+            continue;
+        }
+        _SurfaceFaces surface;
+        surface.name = subset.GetPrim().GetName().GetString();
+        for (int face : indices) {
+            if (face >= 0 && (size_t)face < p_face_count && !claimed[face]) {
+                claimed[face] = true;
+                surface.faces.push_back(face);
+            }
+        }
+        if (!surface.faces.empty()) {
+            r_surfaces->push_back(std::move(surface));
+        }
+    }
+
+    _SurfaceFaces rest;
+    for (size_t face = 0; face < p_face_count; ++face) {
+        if (!claimed[face]) {
+            rest.faces.push_back((int)face);
+        }
+    }
+    if (!rest.faces.empty()) {
+        if (r_surfaces->empty()) {
+            return;
+        }
+        r_surfaces->push_back(std::move(rest));
+    }
+}
 
-    int vertexOffset = 0;
-    int triangleIndex = 0;
+static bool _ReadMeshSource(const UsdGeomMesh &p_mesh, _MeshSource *r_source) {
+    if (!p_mesh.GetPointsAttr().Get(&r_source->points))
+        return false;
 
-    for (size_t face = 0; face < faceVertexCounts.size(); ++face) {
-        int vertexCount = faceVertexCounts[face];
-        if (vertexCount < 3) continue; // Skip degenerate faces
+    if (!p_mesh.GetFaceVertexCountsAttr().Get(&r_source->face_vertex_counts) ||
+        !p_mesh.GetFaceVertexIndicesAttr().Get(&r_source->face_vertex_indices))
+        return false;
 
-        for (int i = 0; i < vertexCount - 2; ++i) {
-            int idx0 = faceVertexIndices[vertexOffset];
-            int idx1 = faceVertexIndices[vertexOffset + i + 1];
-            int idx2 = faceVertexIndices[vertexOffset + i + 2];
+    if (!_ValidateTopology(r_source->face_vertex_counts, r_source->face_vertex_indices, r_source->points.size())) {
+        UtilityFunctions::printerr("USD Import: Invalid mesh topology on ", String(p_mesh.GetPath().GetText()));
+        return false;
+    }
+
+    // Fetch every primvar once; indexed primvars are flattened here.
+    const UsdGeomPrimvarsAPI primvars(p_mesh);
+    if (!r_source->normals.fetch(primvars.GetPrimvar(TfToken("normals")))) {
+        // primvars:normals wins when present, otherwise use the schema attribute
+        r_source->normals.fetch(p_mesh.GetNormalsAttr(), p_mesh.GetNormalsInterpolation());
+    }
+    r_source->uvs.fetch(primvars.GetPrimvar(TfToken("st")));
+    _FetchColorSpan(primvars.GetPrimvar(TfToken("displayColor")), &r_source->colors);
+    _ReadSurfaceFaces(p_mesh, r_source->face_vertex_counts.size(), &r_source->surfaces);
+    return true;
+}
+
+// Number of fan triangles the mesh produces; degenerate faces contribute none.
+static int64_t _CountTriangles(const _MeshSource &p_source) {
+    int64_t triangle_count = 0;
+    for (int count : p_source.face_vertex_counts) {
+        if (count >= 3) {
+            triangle_count += count - 2;
+        }
+    }
+    return triangle_count;
+}
+
+// Contiguous face ranges with their starting offsets into faceVertexIndices
+// and into the triangle output. Chunk c covers faces
+// [face_begin[c], face_begin[c + 1]); the offsets are an exclusive prefix
+// sum of the per-chunk face vertex and triangle counts, so every chunk knows
+// where to write without looking at the others.
+struct _FaceChunks {
+    std::vector<size_t> face_begin;
+    std::vector<size_t> face_vertex_begin;
+    std::vector<int64_t> triangle_begin;
+
+    size_t size() const { return face_begin.size() - 1; }
+    int64_t triangle_count() const { return triangle_begin.back(); }
+};
+
+static void _PlanFaceChunks(const _MeshSource &p_source, int p_thread_count, _FaceChunks *r_chunks) {
+    const size_t face_count = p_source.face_vertex_counts.size();
+    const int *counts = p_source.face_vertex_counts.cdata();
+
+    // A single chunk when serial, otherwise enough for load balancing
+    const size_t chunk_count = std::max<size_t>(1, std::min<size_t>(face_count, p_thread_count > 1 ? (size_t)p_thread_count * 8 : 1));
+
+    r_chunks->face_begin.resize(chunk_count + 1);
+    r_chunks->face_vertex_begin.assign(chunk_count + 1, 0);
+    r_chunks->triangle_begin.assign(chunk_count + 1, 0);
+    for (size_t c = 0; c <= chunk_count; ++c) {
+        r_chunks->face_begin[c] = face_count * c / chunk_count;
+    }
+
+    // Per-chunk totals, stored one slot ahead for the scan below
+    UsdParallel::for_range(chunk_count, p_thread_count, [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t c = p_begin; c < p_end; ++c) {
+            size_t face_vertices = 0;
+            int64_t triangles = 0;
+            for (size_t face = r_chunks->face_begin[c]; face < r_chunks->face_begin[c + 1]; ++face) {
+                face_vertices += counts[face];
+                if (counts[face] >= 3) {
+                    triangles += counts[face] - 2;
+                }
+            }
+            r_chunks->face_vertex_begin[c + 1] = face_vertices;
+            r_chunks->triangle_begin[c + 1] = triangles;
+        }
+    });
+
+    for (size_t c = 0; c < chunk_count; ++c) {
+        r_chunks->face_vertex_begin[c + 1] += r_chunks->face_vertex_begin[c];
+        r_chunks->triangle_begin[c + 1] += r_chunks->triangle_begin[c];
+    }
+}
+
+// Raw output pointers for the per-corner path; uvs/colors are null when the
+// primvar is absent.
+struct _CornerOutputs {
+    Vector3 *vertices;
+    Vector3 *normals;
+    int32_t *indices;
+    Vector2 *uvs;
+    Color *colors;
+};
+
+// Fan-triangulate one chunk of faces into the per-corner outputs. Clears
+// r_uvs_complete/r_colors_complete if a primvar had no value for some
+// corner. The same code runs for the serial and parallel paths, so the
+// output does not depend on the thread count.
+static void _EmitCornerChunk(const _MeshSource &p_source, const _FaceChunks &p_chunks, size_t p_chunk,
+        const _CornerOutputs &p_out, bool *r_uvs_complete, bool *r_colors_complete) {
+    const GfVec3f *point_data = p_source.points.cdata();
+    const int *counts = p_source.face_vertex_counts.cdata();
+    const int *face_indices = p_source.face_vertex_indices.cdata();
+
+    size_t vertexOffset = p_chunks.face_vertex_begin[p_chunk];
+    int64_t out = p_chunks.triangle_begin[p_chunk] * 3;
 
-            int triIndices[3] = { idx2, idx1, idx0 };
+    for (size_t face = p_chunks.face_begin[p_chunk]; face < p_chunks.face_begin[p_chunk + 1]; ++face) {
+        const int vertexCount = counts[face];
+        if (vertexCount < 3) {
+            // Skip degenerate faces, but keep faceVarying data in step
+            vertexOffset += vertexCount;
+            continue;
+        }
+
+        for (int i = 0; i < vertexCount - 2; ++i) {
+            // Fan triangulation, emitted with reversed winding for Godot
+            const size_t triFaceVertex[3] = {
+                vertexOffset + i + 2,
+                vertexOffset + i + 1,
+                vertexOffset
+            };
 
-            for (int corner = 0; corner < 3; ++corner) {
-                int usdIndex = triIndices[corner];
-                vertices.append(Vector3(points[usdIndex][0], points[usdIndex][1], points[usdIndex][2]));
-                indices.append(vertices.size() - 1);
+            for (int corner = 0; corner < 3; ++corner, ++out) {
+                const size_t faceVertex = triFaceVertex[corner];
+                const int usdIndex = face_indices[faceVertex];
+                const GfVec3f &p = point_data[usdIndex];
+                p_out.vertices[out] = Vector3(p[0], p[1], p[2]);
+                p_out.indices[out] = (int32_t)out;
 
                 // Normals
-                GfVec3f n;
-                int normalIndex =
-                    normalInterp == UsdGeomTokens->constant ? 0 :
-                    normalInterp == UsdGeomTokens->uniform ? face :
-                    normalInterp == UsdGeomTokens->vertex ? usdIndex :
-                    normalInterp == UsdGeomTokens->faceVarying ? triangleIndex * 3 + corner : -1;
-                if (normalIndex >= 0 && _GetPrimvarVec3fAtIndex(normalPrimvar, normalIndex, &n))
-                    normals.append(Vector3(n[0], n[1], n[2]));
-                else
-                    normals.append(Vector3());
+                int64_t normalIndex = p_source.normals.index_for(face, usdIndex, faceVertex);
+                if (normalIndex >= 0) {
+                    const GfVec3f &n = p_source.normals.data[normalIndex];
+                    p_out.normals[out] = Vector3(n[0], n[1], n[2]);
+                } else {
+                    p_out.normals[out] = Vector3();
+                }
 
                 // UVs
-                GfVec2f uv;
-                int uvIndex =
-                    uvInterp == UsdGeomTokens->constant ? 0 :
-                    uvInterp == UsdGeomTokens->uniform ? face :
-                    uvInterp == UsdGeomTokens->vertex ? usdIndex :
-                    uvInterp == UsdGeomTokens->faceVarying ? triangleIndex * 3 + corner : -1;
-                if (uvIndex >= 0 && _GetPrimvarVec2fAtIndex(uvPrimvar, uvIndex, &uv))
-                    uvs.append(Vector2(uv[0], 1.0f - uv[1]));
+                if (p_out.uvs) {
+                    int64_t uvIndex = p_source.uvs.index_for(face, usdIndex, faceVertex);
+                    if (uvIndex >= 0) {
+                        const GfVec2f &uv = p_source.uvs.data[uvIndex];
+                        p_out.uvs[out] = Vector2(uv[0], 1.0f - uv[1]);
+                    } else {
+                        *r_uvs_complete = false;
+                    }
+                }
 
                 // Vertex color
-                GfVec4f c;
-                int colorIndex =
-                    colorInterp == UsdGeomTokens->constant ? 0 :
-                    colorInterp == UsdGeomTokens->uniform ? face :
-                    colorInterp == UsdGeomTokens->vertex ? usdIndex :
-                    colorInterp == UsdGeomTokens->faceVarying ? triangleIndex * 3 + corner : -1;
-                if (colorIndex >= 0 && _GetPrimvarColorAtIndex(colorPrimvar, colorIndex, &c))
-                    colors.append(Color(c[0], c[1], c[2], c[3]));
+                if (p_out.colors) {
+                    int64_t colorIndex = p_source.colors.index_for(face, usdIndex, faceVertex);
+                    if (colorIndex >= 0) {
+                        const GfVec4f &c = p_source.colors.data[colorIndex];
+                        p_out.colors[out] = Color(c[0], c[1], c[2], c[3]);
+                    } else {
+                        *r_colors_complete = false;
+                    }
+                }
             }
-            ++triangleIndex;
         }
         vertexOffset += vertexCount;
     }
+}
 
-    // Synthesize weighted normals if original normals were missing
-    bool had_normals = false;
-    for (int i = 0; i < normals.size(); ++i) {
-        if (normals[i].length_squared() > 1e-5f) {
-            had_normals = true;
-            break;
+// One Godot vertex per triangle corner. Always correct, but triples the
+// vertex count of a typical closed mesh.
+static void _BuildCornerArrays(const _MeshSource &p_source, int p_thread_count, _MeshArrays *r_arrays) {
+    _FaceChunks chunks;
+    _PlanFaceChunks(p_source, p_thread_count, &chunks);
+    const int64_t corner_count = chunks.triangle_count() * 3;
+
+    // Size every output once; the chunks write through raw pointers
+    r_arrays->vertices.resize(corner_count);
+    r_arrays->normals.resize(corner_count);
+    r_arrays->indices.resize(corner_count);
+    r_arrays->uvs.resize(p_source.uvs.data ? corner_count : 0);
+    r_arrays->colors.resize(p_source.colors.data ? corner_count : 0);
+
+    _CornerOutputs out;
+    out.vertices = r_arrays->vertices.ptrw();
+    out.normals = r_arrays->normals.ptrw();
+    out.indices = r_arrays->indices.ptrw();
+    out.uvs = p_source.uvs.data ? r_arrays->uvs.ptrw() : nullptr;
+    out.colors = p_source.colors.data ? r_arrays->colors.ptrw() : nullptr;
+
+    std::atomic<bool> uvs_complete(true);
+    std::atomic<bool> colors_complete(true);
+    UsdParallel::for_range(chunks.size(), p_thread_count, [&](int64_t p_begin, int64_t p_end) {
+        bool chunk_uvs_complete = true;
+        bool chunk_colors_complete = true;
+        for (int64_t c = p_begin; c < p_end; ++c) {
+            _EmitCornerChunk(p_source, chunks, c, out, &chunk_uvs_complete, &chunk_colors_complete);
+        }
+        if (!chunk_uvs_complete) {
+            uvs_complete.store(false, std::memory_order_relaxed);
+        }
+        if (!chunk_colors_complete) {
+            colors_complete.store(false, std::memory_order_relaxed);
+        }
+    });
+
+    // A primvar that doesn't cover every corner is dropped and padded with
+    // defaults by the caller, rather than mixing real and default values
+    if (!uvs_complete.load()) {
+        r_arrays->uvs.clear();
+    }
+    if (!colors_complete.load()) {
+        r_arrays->colors.clear();
+    }
+    r_arrays->corner_count = corner_count;
+}
+
+// True when the primvar has one value per point (or one for the whole
+// mesh), so it can live on the USD point array without splitting vertices.
+template <typename T>
+static bool _IsPerPoint(const _PrimvarSpan<T> &p_span) {
+    return !p_span.data ||
+            p_span.interpolation == UsdGeomTokens->constant ||
+            p_span.interpolation == UsdGeomTokens->vertex ||
+            p_span.interpolation == UsdGeomTokens->varying;
+}
+
+// True when the primvar values can be copied over as the vertex attribute
+// array without any remapping.
+template <typename T>
+static bool _IsExactlyPerPoint(const _PrimvarSpan<T> &p_span, size_t p_point_count) {
+    return p_span.data && p_span.size == p_point_count &&
+            (p_span.interpolation == UsdGeomTokens->vertex || p_span.interpolation == UsdGeomTokens->varying);
+}
+
+// Emit fan-triangulated faceVertexIndices with reversed winding.
+static void _TriangulatePointIndices(const _MeshSource &p_source, int p_thread_count, PackedInt32Array *r_indices) {
+    const int *counts = p_source.face_vertex_counts.cdata();
+    const int *face_indices = p_source.face_vertex_indices.cdata();
+
+    _FaceChunks chunks;
+    _PlanFaceChunks(p_source, p_thread_count, &chunks);
+    r_indices->resize(chunks.triangle_count() * 3);
+    int32_t *indices = r_indices->ptrw();
+
+    UsdParallel::for_range(chunks.size(), p_thread_count, [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t c = p_begin; c < p_end; ++c) {
+            int32_t *dst = indices + chunks.triangle_begin[c] * 3;
+            size_t vertexOffset = chunks.face_vertex_begin[c];
+            for (size_t face = chunks.face_begin[c]; face < chunks.face_begin[c + 1]; ++face) {
+                const int vertexCount = counts[face];
+                for (int i = 0; i < vertexCount - 2; ++i) {
+                    *dst++ = face_indices[vertexOffset + i + 2];
+                    *dst++ = face_indices[vertexOffset + i + 1];
+                    *dst++ = face_indices[vertexOffset];
+                }
+                vertexOffset += vertexCount;
+            }
+        }
+    });
+}
+
+// Welded fast path: every primvar is per point, so the USD point array is
+// the Godot vertex array and faceVertexIndices become ARRAY_INDEX.
+static void _BuildSharedPointArrays(const _MeshSource &p_source, int p_thread_count, _MeshArrays *r_arrays) {
+    const size_t point_count = p_source.points.size();
+
+    UsdArrayUtils::to_packed_array(p_source.points, &r_arrays->vertices);
+
+    if (_IsExactlyPerPoint(p_source.normals, point_count)) {
+        UsdArrayUtils::to_packed_array(p_source.normals.values, &r_arrays->normals);
+    } else if (p_source.normals.data) {
+        r_arrays->normals.resize(point_count);
+        Vector3 *normals = r_arrays->normals.ptrw();
+        for (size_t i = 0; i < point_count; ++i) {
+            int64_t index = p_source.normals.index_for(0, (int)i, 0);
+            normals[i] = index >= 0 ? Vector3(p_source.normals.data[index][0], p_source.normals.data[index][1], p_source.normals.data[index][2]) : Vector3();
+        }
+    }
+
+    if (_IsExactlyPerPoint(p_source.uvs, point_count)) {
+        UsdArrayUtils::to_packed_array(p_source.uvs.values, &r_arrays->uvs);
+        UsdArrayUtils::flip_v(&r_arrays->uvs);
+    } else if (p_source.uvs.data) {
+        r_arrays->uvs.resize(point_count);
+        Vector2 *uvs = r_arrays->uvs.ptrw();
+        for (size_t i = 0; i < point_count; ++i) {
+            int64_t index = p_source.uvs.index_for(0, (int)i, 0);
+            uvs[i] = index >= 0 ? Vector2(p_source.uvs.data[index][0], 1.0f - p_source.uvs.data[index][1]) : Vector2();
+        }
+    }
+
+    if (_IsExactlyPerPoint(p_source.colors, point_count)) {
+        UsdArrayUtils::to_packed_array(p_source.colors.values, &r_arrays->colors);
+    } else if (p_source.colors.data) {
+        r_arrays->colors.resize(point_count);
+        Color *colors = r_arrays->colors.ptrw();
+        for (size_t i = 0; i < point_count; ++i) {
+            int64_t index = p_source.colors.index_for(0, (int)i, 0);
+            const GfVec4f c = index >= 0 ? p_source.colors.data[index] : GfVec4f(1.0f);
+            colors[i] = Color(c[0], c[1], c[2], c[3]);
+        }
+    }
+
+    _TriangulatePointIndices(p_source, p_thread_count, &r_arrays->indices);
+    r_arrays->corner_count = r_arrays->indices.size();
+}
+
+// Key for deduplicating corners: the USD point plus every attribute value
+// that would be written to the Godot vertex.
+struct _WeldKey {
+    int point;
+    float attributes[9]; // normal xyz, uv xy, color rgba
+
+    bool operator==(const _WeldKey &p_other) const {
+        return point == p_other.point && memcmp(attributes, p_other.attributes, sizeof(attributes)) == 0;
+    }
+};
+
+struct _WeldKeyHash {
+    size_t operator()(const _WeldKey &p_key) const {
+        // FNV-1a over the raw key bytes
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&p_key);
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < sizeof(_WeldKey); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+        return (size_t)hash;
+    }
+};
+
+// Welded path for faceVarying/uniform data: corners with identical
+// (point, normal, uv, color) tuples share one Godot vertex.
+static void _BuildHashedArrays(const _MeshSource &p_source, _MeshArrays *r_arrays) {
+    const GfVec3f *point_data = p_source.points.cdata();
+    const int *counts = p_source.face_vertex_counts.cdata();
+    const int *face_indices = p_source.face_vertex_indices.cdata();
+    const size_t face_count = p_source.face_vertex_counts.size();
+    const int64_t corner_count = _CountTriangles(p_source) * 3;
+
+    // The welded vertex count is at most the corner count; size for the
+    // worst case and trim once at the end
+    r_arrays->vertices.resize(corner_count);
+    r_arrays->normals.resize(corner_count);
+    r_arrays->uvs.resize(corner_count);
+    r_arrays->colors.resize(corner_count);
+    r_arrays->indices.resize(corner_count);
+
+    Vector3 *vertices = r_arrays->vertices.ptrw();
+    Vector3 *normals = r_arrays->normals.ptrw();
+    Vector2 *uvs = r_arrays->uvs.ptrw();
+    Color *colors = r_arrays->colors.ptrw();
+    int32_t *indices = r_arrays->indices.ptrw();
+
+    std::unordered_map<_WeldKey, int32_t, _WeldKeyHash> vertex_lookup;
+    vertex_lookup.reserve(p_source.points.size() * 2);
+
+    int32_t vertex_count = 0;
+    int64_t out = 0;
+    size_t vertexOffset = 0;
+    for (size_t face = 0; face < face_count; ++face) {
+        const int vertexCount = counts[face];
+        for (int i = 0; i < vertexCount - 2; ++i) {
+            const size_t triFaceVertex[3] = {
+                vertexOffset + i + 2,
+                vertexOffset + i + 1,
+                vertexOffset
+            };
+
+            for (int corner = 0; corner < 3; ++corner, ++out) {
+                const size_t faceVertex = triFaceVertex[corner];
+                const int usdIndex = face_indices[faceVertex];
+
+                _WeldKey key;
+                key.point = usdIndex;
+                GfVec3f n(0.0f);
+                GfVec2f uv(0.0f);
+                GfVec4f c(1.0f);
+                int64_t index = p_source.normals.index_for(face, usdIndex, faceVertex);
+                if (index >= 0) n = p_source.normals.data[index];
+                index = p_source.uvs.index_for(face, usdIndex, faceVertex);
+                if (index >= 0) {
+                    // Flip only UVs actually read, so missing ones match the
+                    // (0, 0) the other paths pad with
+                    uv = p_source.uvs.data[index];
+                    uv[1] = 1.0f - uv[1];
+                }
+                index = p_source.colors.index_for(face, usdIndex, faceVertex);
+                if (index >= 0) c = p_source.colors.data[index];
+                key.attributes[0] = n[0]; key.attributes[1] = n[1]; key.attributes[2] = n[2];
+                key.attributes[3] = uv[0]; key.attributes[4] = uv[1];
+                key.attributes[5] = c[0]; key.attributes[6] = c[1]; key.attributes[7] = c[2]; key.attributes[8] = c[3];
+
+                auto inserted = vertex_lookup.emplace(key, vertex_count);
+                if (inserted.second) {
+                    const GfVec3f &p = point_data[usdIndex];
+                    vertices[vertex_count] = Vector3(p[0], p[1], p[2]);
+                    normals[vertex_count] = Vector3(n[0], n[1], n[2]);
+                    uvs[vertex_count] = Vector2(uv[0], uv[1]);
+                    colors[vertex_count] = Color(c[0], c[1], c[2], c[3]);
+                    ++vertex_count;
+                }
+                indices[out] = inserted.first->second;
+            }
         }
+        vertexOffset += vertexCount;
+    }
+
+    r_arrays->vertices.resize(vertex_count);
+    r_arrays->normals.resize(vertex_count);
+    r_arrays->uvs.resize(vertex_count);
+    r_arrays->colors.resize(vertex_count);
+    r_arrays->corner_count = corner_count;
+}
+
+// Area-weighted vertex normals from the triangle list, computed by the SoA
+// kernel in UsdMeshNormals.
+static void _SynthesizeNormals(_MeshArrays *r_arrays) {
+    const int64_t vertex_count = r_arrays->vertices.size();
+    const Vector3 *vertices = r_arrays->vertices.ptr();
+
+    std::vector<float> soa(vertex_count * 6);
+    float *x = soa.data();
+    float *y = x + vertex_count;
+    float *z = y + vertex_count;
+    float *nx = z + vertex_count;
+    float *ny = nx + vertex_count;
+    float *nz = ny + vertex_count;
+    for (int64_t i = 0; i < vertex_count; ++i) {
+        x[i] = vertices[i].x;
+        y[i] = vertices[i].y;
+        z[i] = vertices[i].z;
     }
 
-    if (!had_normals) {
-        normals.resize(vertices.size());
-        for (int i = 0; i < normals.size(); ++i)
-            normals[i] = Vector3(0, 0, 0);
+    UsdMeshNormals::compute_area_weighted(x, y, z, vertex_count,
+            r_arrays->indices.ptr(), r_arrays->indices.size(), nx, ny, nz);
 
-        for (int i = 0; i < indices.size(); i += 3) {
-            int i0 = indices[i];
-            int i1 = indices[i + 1];
-            int i2 = indices[i + 2];
+    r_arrays->normals.resize(vertex_count);
+    Vector3 *normals = r_arrays->normals.ptrw();
+    for (int64_t i = 0; i < vertex_count; ++i) {
+        normals[i] = Vector3(nx[i], ny[i], nz[i]);
+    }
+}
+
+// Regroup the triangles by surface. Every surface gets its own copy of the
+// vertices it uses, renumbered from zero, and the surfaces are appended one
+// after another. Relies on every build path emitting each face's fan
+// triangles in face order.
+static void _SplitSurfaces(const _MeshSource &p_source, _MeshArrays *r_arrays, PackedInt32Array *r_surface_ends) {
+    const size_t face_count = p_source.face_vertex_counts.size();
+    const int *counts = p_source.face_vertex_counts.cdata();
+    std::vector<int64_t> face_triangle_begin(face_count + 1, 0);
+    for (size_t face = 0; face < face_count; ++face) {
+        face_triangle_begin[face + 1] = face_triangle_begin[face] + std::max(counts[face] - 2, 0);
+    }
+
+    const int64_t vertex_count = r_arrays->vertices.size();
+    const Vector3 *vertices = r_arrays->vertices.ptr();
+    const Vector3 *normals = r_arrays->normals.ptr();
+    const Vector2 *uvs = r_arrays->uvs.ptr();
+    const Color *colors = r_arrays->colors.ptr();
+    const int32_t *indices = r_arrays->indices.ptr();
 
-            Vector3 v0 = vertices[i0];
-            Vector3 v1 = vertices[i1];
-            Vector3 v2 = vertices[i2];
+    // A surface has at most one vertex per corner; size for that and trim
+    const int64_t index_count = r_arrays->indices.size();
+    _MeshArrays split;
+    split.vertices.resize(index_count);
+    split.normals.resize(index_count);
+    split.uvs.resize(index_count);
+    split.colors.resize(index_count);
+    split.indices.resize(index_count);
+    split.corner_count = r_arrays->corner_count;
+    Vector3 *split_vertices = split.vertices.ptrw();
+    Vector3 *split_normals = split.normals.ptrw();
+    Vector2 *split_uvs = split.uvs.ptrw();
+    Color *split_colors = split.colors.ptrw();
+    int32_t *split_indices = split.indices.ptrw();
 
-            Vector3 e1 = v1 - v0;
-            Vector3 e2 = v2 - v0;
-            Vector3 face_normal = e1.cross(e2);
-            float area = face_normal.length() * 0.5f;
-            face_normal = face_normal.normalized();
+    // remap[v] is v's number in the current surface when seen[v] matches
+    std::vector<int32_t> remap(vertex_count);
+    std::vector<int32_t> seen(vertex_count, -1);
+    r_surface_ends->resize(p_source.surfaces.size() * 2);
+    int32_t *ends = r_surface_ends->ptrw();
 
-            normals[i0] += face_normal * area;
-            normals[i1] += face_normal * area;
-            normals[i2] += face_normal * area;
+    int64_t vertex_end = 0;
+    int64_t index_end = 0;
+    for (size_t s = 0; s < p_source.surfaces.size(); ++s) {
+        const int64_t vertex_begin = vertex_end;
+        for (int face : p_source.surfaces[s].faces) {
+            for (int64_t corner = face_triangle_begin[face] * 3; corner < face_triangle_begin[face + 1] * 3; ++corner) {
+                const int32_t vertex = indices[corner];
+                if (seen[vertex] != (int32_t)s) {
+                    seen[vertex] = (int32_t)s;
+                    remap[vertex] = (int32_t)(vertex_end - vertex_begin);
+                    split_vertices[vertex_end] = vertices[vertex];
+                    split_normals[vertex_end] = normals[vertex];
+                    split_uvs[vertex_end] = uvs[vertex];
+                    split_colors[vertex_end] = colors[vertex];
+                    ++vertex_end;
+                }
+                split_indices[index_end++] = remap[vertex];
+            }
         }
+        ends[s * 2] = (int32_t)vertex_end;
+        ends[s * 2 + 1] = (int32_t)index_end;
+    }
+
+    split.vertices.resize(vertex_end);
+    split.normals.resize(vertex_end);
+    split.uvs.resize(vertex_end);
+    split.colors.resize(vertex_end);
+    *r_arrays = split;
+}
+
+static inline void _HashCombine(uint64_t *r_seed, uint64_t p_value) {
+    *r_seed ^= p_value + 0x9e3779b97f4a7c15ULL + (*r_seed << 6) + (*r_seed >> 2);
+}
+
+template <typename T>
+static void _HashArray(uint64_t *r_seed, const T *p_data, size_t p_count) {
+    _HashCombine(r_seed, p_count);
+    if (p_count > 0) {
+        _HashCombine(r_seed, std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char *>(p_data), p_count * sizeof(T))));
+    }
+}
+
+template <typename T>
+static void _HashPrimvar(uint64_t *r_seed, const _PrimvarSpan<T> &p_span) {
+    _HashCombine(r_seed, TfToken::HashFunctor()(p_span.interpolation));
+    _HashArray(r_seed, p_span.data, p_span.size);
+}
+
+// Content hash over every input the conversion reads, so two prims with the
+// same hash produce identical arrays.
+static uint64_t _HashMeshSource(const _MeshSource &p_source, const UsdMeshImportOptions &p_options) {
+    uint64_t hash = p_options.weld_vertices ? 1 : 0;
+    _HashArray(&hash, p_source.points.cdata(), p_source.points.size());
+    _HashArray(&hash, p_source.face_vertex_counts.cdata(), p_source.face_vertex_counts.size());
+    _HashArray(&hash, p_source.face_vertex_indices.cdata(), p_source.face_vertex_indices.size());
+    _HashPrimvar(&hash, p_source.normals);
+    _HashPrimvar(&hash, p_source.uvs);
+    _HashPrimvar(&hash, p_source.colors);
+    for (const _SurfaceFaces &surface : p_source.surfaces) {
+        _HashArray(&hash, surface.name.data(), surface.name.size());
+        _HashArray(&hash, surface.faces.data(), surface.faces.size());
+    }
+    return hash;
+}
+
+Ref<Mesh> UsdMeshImportHelper::import_geom_mesh(const UsdGeomMesh& mesh) {
+    // Prototype paths are generated per stage open, so only prims with
+    // stable paths go through the disk cache
+    UsdMeshDiskCache *disk_cache = mesh.GetPrim().IsInPrototype() ? nullptr : _disk_cache;
+
+    UsdMeshSurfaceData surface;
+    if (disk_cache && disk_cache->lookup(mesh.GetPath(), &surface)) {
+        _stats.disk_cache_hits++;
+        return create_geom_mesh(surface);
+    }
+
+    if (!build_geom_mesh_surface(mesh, &surface))
+        return Ref<Mesh>();
+    if (disk_cache) {
+        disk_cache->store(mesh.GetPath(), surface);
+    }
+    return create_geom_mesh(surface);
+}
+
+bool UsdMeshImportHelper::build_geom_mesh_surface(const UsdGeomMesh &p_mesh, UsdMeshSurfaceData *r_surface) const {
+    _MeshSource source;
+    if (!_ReadMeshSource(p_mesh, &source))
+        return false;
+
+    // Large meshes are triangulated on worker threads; the result is
+    // identical to the serial path
+    int thread_count = 1;
+    if (_options.parallel_face_threshold > 0 && (int64_t)source.face_vertex_counts.size() >= _options.parallel_face_threshold) {
+        thread_count = UsdParallel::resolve_thread_count(_options.thread_count);
+    }
 
-        for (int i = 0; i < normals.size(); ++i)
-            normals[i] = normals[i].normalized();
+    _MeshArrays arrays;
+    if (!_options.weld_vertices) {
+        _BuildCornerArrays(source, thread_count, &arrays);
+    } else if (_IsPerPoint(source.normals) && _IsPerPoint(source.uvs) && _IsPerPoint(source.colors)) {
+        _BuildSharedPointArrays(source, thread_count, &arrays);
+    } else {
+        // Vertex numbering depends on visit order, so this stays serial
+        _BuildHashedArrays(source, &arrays);
+    }
+
+    // Synthesize weighted normals if original normals were missing
+    if (source.normals.size == 0) {
+        _SynthesizeNormals(&arrays);
     }
 
     // Ensure consistent attribute sizes
-    int vertex_count = vertices.size();
+    if (arrays.uvs.size() != arrays.vertices.size()) {
+        arrays.uvs.resize(arrays.vertices.size());
+        arrays.uvs.fill(Vector2());
+    }
 
-    if (uvs.size() != vertex_count) {
-        uvs.resize(vertex_count);
-        for (int i = 0; i < vertex_count; ++i)
-            uvs[i] = Vector2();
+    if (arrays.colors.size() != arrays.vertices.size()) {
+        arrays.colors.resize(arrays.vertices.size());
+        arrays.colors.fill(Color(1, 1, 1, 1));
     }
 
-    if (colors.size() != vertex_count) {
-        colors.resize(vertex_count);
-        for (int i = 0; i < vertex_count; ++i)
-            colors[i] = Color(1, 1, 1, 1);
+    if (!source.surfaces.empty()) {
+        _SplitSurfaces(source, &arrays, &r_surface->surface_ends);
+        r_surface->surface_names.resize(source.surfaces.size());
+        for (size_t s = 0; s < source.surfaces.size(); ++s) {
+            r_surface->surface_names.set(s, String::utf8(source.surfaces[s].name.c_str()));
+        }
     }
 
-    Array arrays;
-    arrays.resize(Mesh::ARRAY_MAX);
-    arrays[Mesh::ARRAY_VERTEX] = vertices;
-    arrays[Mesh::ARRAY_NORMAL] = normals;
-    arrays[Mesh::ARRAY_TEX_UV] = uvs;
-    arrays[Mesh::ARRAY_COLOR] = colors;
-    arrays[Mesh::ARRAY_INDEX] = indices;
+    const int64_t vertex_count = arrays.vertices.size();
+    r_surface->arrays.resize(Mesh::ARRAY_MAX);
+    r_surface->arrays[Mesh::ARRAY_VERTEX] = arrays.vertices;
+    r_surface->arrays[Mesh::ARRAY_NORMAL] = arrays.normals;
+    r_surface->arrays[Mesh::ARRAY_TEX_UV] = arrays.uvs;
+    r_surface->arrays[Mesh::ARRAY_COLOR] = arrays.colors;
+    r_surface->arrays[Mesh::ARRAY_INDEX] = arrays.indices;
+    r_surface->corner_count = arrays.corner_count;
+    r_surface->vertex_count = vertex_count;
+    r_surface->content_hash = _HashMeshSource(source, _options);
+    r_surface->byte_size = vertex_count * (sizeof(Vector3) * 2 + sizeof(Vector2) + sizeof(Color)) +
+            arrays.indices.size() * sizeof(int32_t);
+    r_surface->valid = true;
+    return true;
+}
+
+Ref<Mesh> UsdMeshImportHelper::create_geom_mesh(const UsdMeshSurfaceData &p_surface) {
+    if (!p_surface.valid)
+        return Ref<Mesh>();
+
+    _stats.mesh_count++;
+    _stats.corner_count += p_surface.corner_count;
+    _stats.vertex_count += p_surface.vertex_count;
+
+    if (_options.deduplicate_meshes) {
+        auto cached = _mesh_cache.find(p_surface.content_hash);
+        // The size check guards against a hash collision handing back a
+        // mesh with different topology
+        if (cached != _mesh_cache.end() &&
+                cached->second.vertex_count == p_surface.vertex_count &&
+                cached->second.corner_count == p_surface.corner_count) {
+            _stats.cache_hits++;
+            _stats.cache_bytes_saved += p_surface.byte_size;
+            return cached->second.mesh;
+        }
+    }
 
     Ref<ArrayMesh> array_mesh = memnew(ArrayMesh);
-    array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+    if (p_surface.surface_ends.is_empty()) {
+        array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, p_surface.arrays);
+    } else {
+        // Cut the back-to-back surfaces apart; the surface name tells
+        // get_surface_material which GeomSubset it came from
+        const PackedVector3Array vertices = p_surface.arrays[Mesh::ARRAY_VERTEX];
+        const PackedVector3Array normals = p_surface.arrays[Mesh::ARRAY_NORMAL];
+        const PackedVector2Array uvs = p_surface.arrays[Mesh::ARRAY_TEX_UV];
+        const PackedColorArray colors = p_surface.arrays[Mesh::ARRAY_COLOR];
+        const PackedInt32Array indices = p_surface.arrays[Mesh::ARRAY_INDEX];
+        int64_t vertex_begin = 0;
+        int64_t index_begin = 0;
+        for (int64_t s = 0; s < p_surface.surface_names.size(); ++s) {
+            const int64_t vertex_end = p_surface.surface_ends[s * 2];
+            const int64_t index_end = p_surface.surface_ends[s * 2 + 1];
+            Array arrays;
+            arrays.resize(Mesh::ARRAY_MAX);
+            arrays[Mesh::ARRAY_VERTEX] = vertices.slice(vertex_begin, vertex_end);
+            arrays[Mesh::ARRAY_NORMAL] = normals.slice(vertex_begin, vertex_end);
+            arrays[Mesh::ARRAY_TEX_UV] = uvs.slice(vertex_begin, vertex_end);
+            arrays[Mesh::ARRAY_COLOR] = colors.slice(vertex_begin, vertex_end);
+            arrays[Mesh::ARRAY_INDEX] = indices.slice(index_begin, index_end);
+            array_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+            array_mesh->surface_set_name(s, p_surface.surface_names[s]);
+            vertex_begin = vertex_end;
+            index_begin = index_end;
+        }
+    }
+
+    if (_options.deduplicate_meshes) {
+        CachedMesh &entry = _mesh_cache[p_surface.content_hash];
+        entry.mesh = array_mesh;
+        entry.vertex_count = p_surface.vertex_count;
+        entry.corner_count = p_surface.corner_count;
+    }
     return array_mesh;
 }
 
+Ref<Material> UsdMeshImportHelper::get_surface_material(const UsdPrim &p_prim, const Ref<Mesh> &p_mesh, int p_surface) {
+    const ArrayMesh *array_mesh = Object::cast_to<ArrayMesh>(p_mesh.ptr());
+    if (array_mesh) {
+        const String subset_name = array_mesh->surface_get_name(p_surface);
+        if (!subset_name.is_empty()) {
+            const UsdPrim subset = p_prim.GetChild(TfToken(subset_name.utf8().get_data()));
+            if (subset.IsA<UsdGeomSubset>()) {
+                return _material_helper.get_subset_material(p_prim, subset);
+            }
+        }
+    }
+    return get_material(p_prim);
+}
+
+void UsdMeshImportHelper::print_stats() const {
+    if (_material_helper.get_material_count() > 0) {
+        UtilityFunctions::print("USD Import: ", _material_helper.get_material_count(), " materials (",
+                _material_helper.get_cache_hits(), " bindings shared an existing material)");
+    }
+    _material_helper.get_texture_loader().print_summary();
+
+    if (_stats.mesh_count == 0)
+        return;
+
+    UtilityFunctions::print("USD Import: ", _stats.mesh_count, " meshes, ", _stats.corner_count, " triangle corners -> ",
+            _stats.vertex_count, " vertices", _options.weld_vertices ? " (welded)" : "");
+
+    if (_options.deduplicate_meshes) {
+        const double hit_rate = 100.0 * (double)_stats.cache_hits / (double)_stats.mesh_count;
+        UtilityFunctions::print("USD Import: Mesh cache: ", _stats.cache_hits, "/", _stats.mesh_count, " hits (",
+                String::num(hit_rate, 1), "%), ", String::num(_stats.cache_bytes_saved / (1024.0 * 1024.0), 2), " MiB of surface data shared");
+    }
+
+    if (_disk_cache) {
+        UtilityFunctions::print("USD Import: Disk cache: ", _stats.disk_cache_hits, "/", _stats.mesh_count, " meshes loaded without conversion");
+    }
+}
 
 void UsdMeshImportHelper::apply_non_uniform_scale(Ref<Mesh> p_mesh, const pxr::GfVec3f& p_scale) {
     // This is a stub implementation for now
@@ -10,7 +10,7 @@
 #include <godot_cpp/classes/capsule_mesh.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
-#include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/classes/material.hpp>
 
 // USD headers
 #include <pxr/usd/usd/prim.h>
@@ -23,15 +23,102 @@
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/base/gf/vec3f.h>
 
+#include "usd_material_import_helper.h"
+
+#include <unordered_map>
+
 PXR_NAMESPACE_USING_DIRECTIVE
 
 namespace godot {
 
+class UsdMeshDiskCache;
+
+struct UsdMeshImportOptions {
+    // Share Godot vertices between triangle corners instead of emitting
+    // one vertex per corner
+    bool weld_vertices = false;
+
+    // Meshes with at least this many faces are triangulated on worker
+    // threads; zero disables the parallel path
+    int64_t parallel_face_threshold = 100000;
+
+    // Worker threads for the parallel path; zero means one per core
+    int thread_count = 0;
+
+    // Meshes with identical points, topology and primvars share one
+    // Ref<Mesh> for the lifetime of the helper
+    bool deduplicate_meshes = true;
+};
+
+// Running totals for every UsdGeomMesh imported by one helper
+struct UsdMeshImportStats {
+    int64_t mesh_count = 0;
+    int64_t corner_count = 0; // triangle corners, i.e. vertices without welding
+    int64_t vertex_count = 0; // vertices actually written to the ArrayMesh
+
+    // Mesh deduplication
+    int64_t cache_hits = 0;
+    int64_t cache_bytes_saved = 0; // surface array bytes not duplicated
+
+    // Meshes loaded from the on-disk cache instead of converted
+    int64_t disk_cache_hits = 0;
+};
+
+// Geometry converted from one UsdGeomMesh, ready to become an ArrayMesh.
+// Holds only packed arrays, so it can be built off the main thread.
+struct UsdMeshSurfaceData {
+    bool valid = false;
+    Array arrays;
+    int64_t corner_count = 0;
+    int64_t vertex_count = 0;
+
+    // Hash of everything the arrays were built from, plus the options
+    // that affect them. Identical hashes mean identical arrays.
+    uint64_t content_hash = 0;
+    int64_t byte_size = 0;
+
+    // Set when materialBind GeomSubsets split the mesh into surfaces. The
+    // arrays then hold one surface after another, each with its own
+    // vertices and surface-local indices; surface_ends has the (vertex,
+    // index) end of every surface and surface_names the subset it came
+    // from, empty for the faces no subset covers.
+    PackedInt32Array surface_ends;
+    PackedStringArray surface_names;
+};
+
 class UsdMeshImportHelper {
+private:
+    struct CachedMesh {
+        Ref<Mesh> mesh;
+        int64_t vertex_count = 0;
+        int64_t corner_count = 0;
+    };
+
+    UsdMeshImportOptions _options;
+    UsdMeshImportStats _stats;
+    std::unordered_map<uint64_t, CachedMesh> _mesh_cache;
+    UsdMeshDiskCache *_disk_cache = nullptr;
+    UsdMaterialImportHelper _material_helper;
+
 public:
     UsdMeshImportHelper();
     ~UsdMeshImportHelper();
 
+    void set_options(const UsdMeshImportOptions &p_options) { _options = p_options; }
+    const UsdMeshImportOptions &get_options() const { return _options; }
+    const UsdMeshImportStats &get_stats() const { return _stats; }
+
+    // Optional persistent cache consulted by import_geom_mesh before
+    // converting, and filled on a miss. Not owned.
+    void set_disk_cache(UsdMeshDiskCache *p_disk_cache) { _disk_cache = p_disk_cache; }
+
+    // Loader for material textures, e.g. one decoding on worker threads.
+    // Not owned; textures are decoded synchronously without one.
+    void set_texture_loader(UsdTextureLoader *p_loader) { _material_helper.set_texture_loader(p_loader); }
+
+    // Print vertex and mesh cache totals to the import log
+    void print_stats() const;
+
     // Import a USD mesh prim into a Godot mesh, delegates to the
     // appropriate import method based on the prim type
     Ref<Mesh> import_mesh_from_prim(const pxr::UsdPrim& p_prim);
@@ -43,10 +130,21 @@ public:
     Ref<CapsuleMesh> import_capsule(const pxr::UsdGeomCapsule& p_capsule);
     Ref<Mesh> import_geom_mesh(const pxr::UsdGeomMesh& p_mesh);
 
+    // import_geom_mesh in two steps. build_geom_mesh_surface only reads USD
+    // and fills packed arrays, so it may run on worker threads;
+    // create_geom_mesh makes the ArrayMesh and belongs on the main thread.
+    bool build_geom_mesh_surface(const pxr::UsdGeomMesh &p_mesh, UsdMeshSurfaceData *r_surface) const;
+    Ref<Mesh> create_geom_mesh(const UsdMeshSurfaceData &p_surface);
+
     // Helper method to handle non-uniform scaling
     void apply_non_uniform_scale(Ref<Mesh> p_mesh, const pxr::GfVec3f& p_scale);
 
-    Ref<StandardMaterial3D> create_material(const pxr::UsdPrim& p_prim);
+    // Shared material for a gprim; see UsdMaterialImportHelper
+    Ref<Material> get_material(const pxr::UsdPrim& p_prim) { return _material_helper.get_material(p_prim); }
+
+    // Material for surface p_surface of p_mesh, imported from p_prim.
+    // Surfaces split from a GeomSubset use the subset's binding.
+    Ref<Material> get_surface_material(const pxr::UsdPrim &p_prim, const Ref<Mesh> &p_mesh, int p_surface);
 };
 
 } // namespace godot
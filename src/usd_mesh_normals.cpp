@@ -0,0 +1,292 @@
+#include "usd_mesh_normals.h"
+
+#include <cmath>
+#include <cstring>
+
+#if !defined(USD_GODOT_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define USD_GODOT_HAS_SSE 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// AVX2 is compiled per function and selected at runtime
+#define USD_GODOT_HAS_AVX2 1
+#define USD_GODOT_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define USD_GODOT_HAS_AVX2 1
+#define USD_GODOT_TARGET_AVX2
+#endif
+#endif
+
+namespace godot {
+
+// Scalar building blocks. The SIMD kernels hand their remainders to these
+// and perform exactly the same float operations per lane.
+
+static inline void _AccumulateTriangle(const float *p_x, const float *p_y, const float *p_z,
+        int32_t p_i0, int32_t p_i1, int32_t p_i2, float *r_nx, float *r_ny, float *r_nz) {
+    const float e1x = p_x[p_i1] - p_x[p_i0];
+    const float e1y = p_y[p_i1] - p_y[p_i0];
+    const float e1z = p_z[p_i1] - p_z[p_i0];
+    const float e2x = p_x[p_i2] - p_x[p_i0];
+    const float e2y = p_y[p_i2] - p_y[p_i0];
+    const float e2z = p_z[p_i2] - p_z[p_i0];
+
+    const float cx = e1y * e2z - e1z * e2y;
+    const float cy = e1z * e2x - e1x * e2z;
+    const float cz = e1x * e2y - e1y * e2x;
+
+    r_nx[p_i0] += cx; r_ny[p_i0] += cy; r_nz[p_i0] += cz;
+    r_nx[p_i1] += cx; r_ny[p_i1] += cy; r_nz[p_i1] += cz;
+    r_nx[p_i2] += cx; r_ny[p_i2] += cy; r_nz[p_i2] += cz;
+}
+
+static inline void _NormalizeOne(float *r_x, float *r_y, float *r_z) {
+    const float length_squared = *r_x * *r_x + *r_y * *r_y + *r_z * *r_z;
+    if (length_squared == 0.0f) {
+        *r_x = *r_y = *r_z = 0.0f;
+        return;
+    }
+    const float length = std::sqrt(length_squared);
+    *r_x /= length;
+    *r_y /= length;
+    *r_z /= length;
+}
+
+static void _AccumulateScalar(const float *p_x, const float *p_y, const float *p_z,
+        const int32_t *p_indices, size_t p_triangle_count, float *r_nx, float *r_ny, float *r_nz) {
+    for (size_t t = 0; t < p_triangle_count; ++t) {
+        const int32_t *tri = p_indices + t * 3;
+        _AccumulateTriangle(p_x, p_y, p_z, tri[0], tri[1], tri[2], r_nx, r_ny, r_nz);
+    }
+}
+
+static void _NormalizeScalar(float *r_x, float *r_y, float *r_z, size_t p_count) {
+    for (size_t i = 0; i < p_count; ++i) {
+        _NormalizeOne(r_x + i, r_y + i, r_z + i);
+    }
+}
+
+#ifdef USD_GODOT_HAS_SSE
+
+// Load one coordinate of four triangle corners into a register. There is
+// no gather instruction before AVX2.
+static inline __m128 _GatherCorners4(const float *p_coord, const int32_t *p_tri, int p_corner) {
+    return _mm_setr_ps(p_coord[p_tri[p_corner]], p_coord[p_tri[3 + p_corner]],
+            p_coord[p_tri[6 + p_corner]], p_coord[p_tri[9 + p_corner]]);
+}
+
+// Scatter W face normals to their vertices in triangle order, matching the
+// scalar accumulation exactly.
+template <int W>
+static inline void _ScatterFaceNormals(const int32_t *p_tri, const float *p_cx, const float *p_cy, const float *p_cz,
+        float *r_nx, float *r_ny, float *r_nz) {
+    for (int lane = 0; lane < W; ++lane) {
+        for (int corner = 0; corner < 3; ++corner) {
+            const int32_t index = p_tri[lane * 3 + corner];
+            r_nx[index] += p_cx[lane];
+            r_ny[index] += p_cy[lane];
+            r_nz[index] += p_cz[lane];
+        }
+    }
+}
+
+static void _AccumulateSSE(const float *p_x, const float *p_y, const float *p_z,
+        const int32_t *p_indices, size_t p_triangle_count, float *r_nx, float *r_ny, float *r_nz) {
+    alignas(16) float cx[4], cy[4], cz[4];
+    size_t t = 0;
+    for (; t + 4 <= p_triangle_count; t += 4) {
+        const int32_t *tri = p_indices + t * 3;
+        const __m128 x0 = _GatherCorners4(p_x, tri, 0);
+        const __m128 y0 = _GatherCorners4(p_y, tri, 0);
+        const __m128 z0 = _GatherCorners4(p_z, tri, 0);
+        const __m128 e1x = _mm_sub_ps(_GatherCorners4(p_x, tri, 1), x0);
+        const __m128 e1y = _mm_sub_ps(_GatherCorners4(p_y, tri, 1), y0);
+        const __m128 e1z = _mm_sub_ps(_GatherCorners4(p_z, tri, 1), z0);
+        const __m128 e2x = _mm_sub_ps(_GatherCorners4(p_x, tri, 2), x0);
+        const __m128 e2y = _mm_sub_ps(_GatherCorners4(p_y, tri, 2), y0);
+        const __m128 e2z = _mm_sub_ps(_GatherCorners4(p_z, tri, 2), z0);
+
+        _mm_store_ps(cx, _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y)));
+        _mm_store_ps(cy, _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z)));
+        _mm_store_ps(cz, _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x)));
+        _ScatterFaceNormals<4>(tri, cx, cy, cz, r_nx, r_ny, r_nz);
+    }
+    _AccumulateScalar(p_x, p_y, p_z, p_indices + t * 3, p_triangle_count - t, r_nx, r_ny, r_nz);
+}
+
+static void _NormalizeSSE(float *r_x, float *r_y, float *r_z, size_t p_count) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 4 <= p_count; i += 4) {
+        const __m128 x = _mm_loadu_ps(r_x + i);
+        const __m128 y = _mm_loadu_ps(r_y + i);
+        const __m128 z = _mm_loadu_ps(r_z + i);
+        const __m128 length_squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        const __m128 nonzero = _mm_cmpneq_ps(length_squared, zero);
+        // Divide by 1 in zero lanes, then mask them to zero
+        const __m128 length = _mm_or_ps(_mm_and_ps(nonzero, _mm_sqrt_ps(length_squared)), _mm_andnot_ps(nonzero, one));
+        _mm_storeu_ps(r_x + i, _mm_and_ps(nonzero, _mm_div_ps(x, length)));
+        _mm_storeu_ps(r_y + i, _mm_and_ps(nonzero, _mm_div_ps(y, length)));
+        _mm_storeu_ps(r_z + i, _mm_and_ps(nonzero, _mm_div_ps(z, length)));
+    }
+    _NormalizeScalar(r_x + i, r_y + i, r_z + i, p_count - i);
+}
+
+#endif // USD_GODOT_HAS_SSE
+
+#ifdef USD_GODOT_HAS_AVX2
+
+USD_GODOT_TARGET_AVX2
+static void _AccumulateAVX2(const float *p_x, const float *p_y, const float *p_z,
+        const int32_t *p_indices, size_t p_triangle_count, float *r_nx, float *r_ny, float *r_nz) {
+    // Corner k of lane j lives at index j * 3 + k
+    const __m256i stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    alignas(32) float cx[8], cy[8], cz[8];
+    size_t t = 0;
+    for (; t + 8 <= p_triangle_count; t += 8) {
+        const int32_t *tri = p_indices + t * 3;
+        const __m256i i0 = _mm256_i32gather_epi32(tri, stride, 4);
+        const __m256i i1 = _mm256_i32gather_epi32(tri + 1, stride, 4);
+        const __m256i i2 = _mm256_i32gather_epi32(tri + 2, stride, 4);
+
+        const __m256 x0 = _mm256_i32gather_ps(p_x, i0, 4);
+        const __m256 y0 = _mm256_i32gather_ps(p_y, i0, 4);
+        const __m256 z0 = _mm256_i32gather_ps(p_z, i0, 4);
+        const __m256 e1x = _mm256_sub_ps(_mm256_i32gather_ps(p_x, i1, 4), x0);
+        const __m256 e1y = _mm256_sub_ps(_mm256_i32gather_ps(p_y, i1, 4), y0);
+        const __m256 e1z = _mm256_sub_ps(_mm256_i32gather_ps(p_z, i1, 4), z0);
+        const __m256 e2x = _mm256_sub_ps(_mm256_i32gather_ps(p_x, i2, 4), x0);
+        const __m256 e2y = _mm256_sub_ps(_mm256_i32gather_ps(p_y, i2, 4), y0);
+        const __m256 e2z = _mm256_sub_ps(_mm256_i32gather_ps(p_z, i2, 4), z0);
+
+        _mm256_store_ps(cx, _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y)));
+        _mm256_store_ps(cy, _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z)));
+        _mm256_store_ps(cz, _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x)));
+        _ScatterFaceNormals<8>(tri, cx, cy, cz, r_nx, r_ny, r_nz);
+    }
+    _AccumulateScalar(p_x, p_y, p_z, p_indices + t * 3, p_triangle_count - t, r_nx, r_ny, r_nz);
+}
+
+USD_GODOT_TARGET_AVX2
+static void _NormalizeAVX2(float *r_x, float *r_y, float *r_z, size_t p_count) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= p_count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(r_x + i);
+        const __m256 y = _mm256_loadu_ps(r_y + i);
+        const __m256 z = _mm256_loadu_ps(r_z + i);
+        const __m256 length_squared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+        const __m256 nonzero = _mm256_cmp_ps(length_squared, zero, _CMP_NEQ_UQ);
+        const __m256 length = _mm256_blendv_ps(one, _mm256_sqrt_ps(length_squared), nonzero);
+        _mm256_storeu_ps(r_x + i, _mm256_and_ps(nonzero, _mm256_div_ps(x, length)));
+        _mm256_storeu_ps(r_y + i, _mm256_and_ps(nonzero, _mm256_div_ps(y, length)));
+        _mm256_storeu_ps(r_z + i, _mm256_and_ps(nonzero, _mm256_div_ps(z, length)));
+    }
+    _NormalizeScalar(r_x + i, r_y + i, r_z + i, p_count - i);
+}
+
+#endif // USD_GODOT_HAS_AVX2
+
+bool UsdMeshNormals::is_kernel_supported(Kernel p_kernel) {
+    switch (p_kernel) {
+        case KERNEL_SCALAR:
+            return true;
+        case KERNEL_SSE:
+#ifdef USD_GODOT_HAS_SSE
+            return true;
+#else
+            return false;
+#endif
+        case KERNEL_AVX2:
+#if defined(USD_GODOT_HAS_AVX2) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx2");
+#elif defined(USD_GODOT_HAS_AVX2)
+            return true; // built with /arch:AVX2
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+UsdMeshNormals::Kernel UsdMeshNormals::get_best_kernel() {
+    static const Kernel best = is_kernel_supported(KERNEL_AVX2) ? KERNEL_AVX2
+            : is_kernel_supported(KERNEL_SSE) ? KERNEL_SSE
+            : KERNEL_SCALAR;
+    return best;
+}
+
+const char *UsdMeshNormals::get_kernel_name(Kernel p_kernel) {
+    switch (p_kernel) {
+        case KERNEL_SCALAR:
+            return "scalar";
+        case KERNEL_SSE:
+            return "sse";
+        case KERNEL_AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+void UsdMeshNormals::compute_area_weighted(const float *p_x, const float *p_y, const float *p_z, size_t p_vertex_count,
+        const int32_t *p_indices, size_t p_index_count,
+        float *r_nx, float *r_ny, float *r_nz) {
+    compute_area_weighted(get_best_kernel(), p_x, p_y, p_z, p_vertex_count, p_indices, p_index_count, r_nx, r_ny, r_nz);
+}
+
+void UsdMeshNormals::compute_area_weighted(Kernel p_kernel,
+        const float *p_x, const float *p_y, const float *p_z, size_t p_vertex_count,
+        const int32_t *p_indices, size_t p_index_count,
+        float *r_nx, float *r_ny, float *r_nz) {
+    if (!is_kernel_supported(p_kernel)) {
+        p_kernel = KERNEL_SCALAR;
+    }
+
+    memset(r_nx, 0, p_vertex_count * sizeof(float));
+    memset(r_ny, 0, p_vertex_count * sizeof(float));
+    memset(r_nz, 0, p_vertex_count * sizeof(float));
+
+    const size_t triangle_count = p_index_count / 3;
+    switch (p_kernel) {
+#ifdef USD_GODOT_HAS_AVX2
+        case KERNEL_AVX2:
+            _AccumulateAVX2(p_x, p_y, p_z, p_indices, triangle_count, r_nx, r_ny, r_nz);
+            break;
+#endif
+#ifdef USD_GODOT_HAS_SSE
+        case KERNEL_SSE:
+            _AccumulateSSE(p_x, p_y, p_z, p_indices, triangle_count, r_nx, r_ny, r_nz);
+            break;
+#endif
+        default:
+            _AccumulateScalar(p_x, p_y, p_z, p_indices, triangle_count, r_nx, r_ny, r_nz);
+            break;
+    }
+
+    normalize(p_kernel, r_nx, r_ny, r_nz, p_vertex_count);
+}
+
+void UsdMeshNormals::normalize(Kernel p_kernel, float *r_x, float *r_y, float *r_z, size_t p_count) {
+    if (!is_kernel_supported(p_kernel)) {
+        p_kernel = KERNEL_SCALAR;
+    }
+
+    switch (p_kernel) {
+#ifdef USD_GODOT_HAS_AVX2
+        case KERNEL_AVX2:
+            _NormalizeAVX2(r_x, r_y, r_z, p_count);
+            break;
+#endif
+#ifdef USD_GODOT_HAS_SSE
+        case KERNEL_SSE:
+            _NormalizeSSE(r_x, r_y, r_z, p_count);
+            break;
+#endif
+        default:
+            _NormalizeScalar(r_x, r_y, r_z, p_count);
+            break;
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,48 @@
+#ifndef USD_MESH_NORMALS_H
+#define USD_MESH_NORMALS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace godot {
+
+// Vertex normal generation for indexed triangle lists stored as SoA float
+// arrays. Independent of Godot and USD types so it can be used by the
+// importer and by any later mesh-processing step.
+//
+// The SIMD kernels vectorize the per-triangle cross products and the
+// final normalize pass; the scatter into shared vertices stays scalar and
+// in triangle order, so every kernel produces the same result as the
+// scalar one. Define USD_GODOT_DISABLE_SIMD to build the scalar kernel only.
+class UsdMeshNormals {
+public:
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE,
+        KERNEL_AVX2,
+    };
+
+    // Fastest kernel supported by this build and the running CPU
+    static Kernel get_best_kernel();
+    static bool is_kernel_supported(Kernel p_kernel);
+    static const char *get_kernel_name(Kernel p_kernel);
+
+    // Area-weighted vertex normals: each triangle adds its unnormalized face
+    // normal (whose length is twice its area) to its three vertices, then
+    // every vertex normal is normalized. Zero-length normals stay zero.
+    // r_nx/r_ny/r_nz hold p_vertex_count floats and are overwritten.
+    static void compute_area_weighted(const float *p_x, const float *p_y, const float *p_z, size_t p_vertex_count,
+            const int32_t *p_indices, size_t p_index_count,
+            float *r_nx, float *r_ny, float *r_nz);
+    static void compute_area_weighted(Kernel p_kernel,
+            const float *p_x, const float *p_y, const float *p_z, size_t p_vertex_count,
+            const int32_t *p_indices, size_t p_index_count,
+            float *r_nx, float *r_ny, float *r_nz);
+
+    // Normalize p_count vectors in place; zero-length vectors stay zero
+    static void normalize(Kernel p_kernel, float *r_x, float *r_y, float *r_z, size_t p_count);
+};
+
+} // namespace godot
+
+#endif // USD_MESH_NORMALS_H
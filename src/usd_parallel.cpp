@@ -0,0 +1,55 @@
+#include "usd_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace godot {
+
+int UsdParallel::resolve_thread_count(int p_requested) {
+    if (p_requested > 0) {
+        return p_requested;
+    }
+    const unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? (int)hardware : 1;
+}
+
+void UsdParallel::for_range(int64_t p_count, int p_thread_count, const std::function<void(int64_t, int64_t)> &p_body) {
+    if (p_count <= 0) {
+        return;
+    }
+
+    const int thread_count = (int)std::min<int64_t>(std::max(p_thread_count, 1), p_count);
+    if (thread_count == 1) {
+        p_body(0, p_count);
+        return;
+    }
+
+    // Several ranges per thread so an uneven range doesn't leave the other
+    // threads idle
+    const int64_t grain = std::max<int64_t>(1, p_count / ((int64_t)thread_count * 4));
+    std::atomic<int64_t> next(0);
+
+    auto worker = [&]() {
+        for (;;) {
+            const int64_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= p_count) {
+                break;
+            }
+            p_body(begin, std::min(begin + grain, p_count));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (int i = 0; i < thread_count - 1; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace godot
@@ -0,0 +1,28 @@
+#ifndef USD_PARALLEL_H
+#define USD_PARALLEL_H
+
+#include <cstdint>
+#include <functional>
+
+namespace godot {
+
+// Minimal fork/join helper for data-parallel loops in the importer and
+// exporter. Work is handed out as contiguous index ranges so callers can
+// write to precomputed output offsets and stay deterministic regardless of
+// the thread count. Bodies must not touch the scene tree or any Godot
+// object that isn't thread-safe.
+class UsdParallel {
+public:
+    // Resolve a requested worker count; zero or less means one per hardware
+    // thread.
+    static int resolve_thread_count(int p_requested);
+
+    // Call p_body(begin, end) for contiguous ranges covering [0, p_count)
+    // on up to p_thread_count threads. The calling thread takes part and the
+    // call returns once every range is done.
+    static void for_range(int64_t p_count, int p_thread_count, const std::function<void(int64_t, int64_t)> &p_body);
+};
+
+} // namespace godot
+
+#endif // USD_PARALLEL_H
@@ -0,0 +1,451 @@
+#include "usd_payload_loader.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/camera3d.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/viewport.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/bboxCache.h>
+#include <pxr/usd/usdGeom/tokens.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace godot {
+
+// Imported nodes mirror prim paths below the import parent
+static NodePath _ToNodePath(const SdfPath &p_prim_path) {
+    return NodePath(String(p_prim_path.GetText()).substr(1));
+}
+
+// Bounds of a loaded prim's contents when it has no extentsHint, so
+// unloading can still be decided by distance
+static bool _ComputeLocalBounds(const UsdPrim &p_prim, AABB *r_bounds) {
+    UsdGeomBBoxCache cache(UsdTimeCode::Default(), { UsdGeomTokens->default_, UsdGeomTokens->render }, true);
+    const GfRange3d range = cache.ComputeUntransformedBound(p_prim).ComputeAlignedRange();
+    if (range.IsEmpty()) {
+        return false;
+    }
+    const GfVec3d min = range.GetMin();
+    const GfVec3d size = range.GetSize();
+    *r_bounds = AABB(Vector3(min[0], min[1], min[2]), Vector3(size[0], size[1], size[2]));
+    return true;
+}
+
+void UsdPayloadLoader::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("open"), &UsdPayloadLoader::open);
+    ClassDB::bind_method(D_METHOD("close"), &UsdPayloadLoader::close);
+    ClassDB::bind_method(D_METHOD("is_open"), &UsdPayloadLoader::is_open);
+    ClassDB::bind_method(D_METHOD("load_payload", "prim_path"), &UsdPayloadLoader::load_payload);
+    ClassDB::bind_method(D_METHOD("unload_payload", "prim_path"), &UsdPayloadLoader::unload_payload);
+    ClassDB::bind_method(D_METHOD("is_payload_loaded", "prim_path"), &UsdPayloadLoader::is_payload_loaded);
+    ClassDB::bind_method(D_METHOD("update_streaming", "viewer_position"), &UsdPayloadLoader::update_streaming);
+    ClassDB::bind_method(D_METHOD("get_payload_paths"), &UsdPayloadLoader::get_payload_paths);
+    ClassDB::bind_method(D_METHOD("get_payload_count"), &UsdPayloadLoader::get_payload_count);
+    ClassDB::bind_method(D_METHOD("get_loaded_payload_count"), &UsdPayloadLoader::get_loaded_payload_count);
+
+    ClassDB::bind_method(D_METHOD("set_stage_path", "path"), &UsdPayloadLoader::set_stage_path);
+    ClassDB::bind_method(D_METHOD("get_stage_path"), &UsdPayloadLoader::get_stage_path);
+    ClassDB::bind_method(D_METHOD("set_root_node", "root_node"), &UsdPayloadLoader::set_root_node);
+    ClassDB::bind_method(D_METHOD("get_root_node"), &UsdPayloadLoader::get_root_node);
+    ClassDB::bind_method(D_METHOD("set_camera", "camera"), &UsdPayloadLoader::set_camera);
+    ClassDB::bind_method(D_METHOD("get_camera"), &UsdPayloadLoader::get_camera);
+    ClassDB::bind_method(D_METHOD("set_load_radius", "radius"), &UsdPayloadLoader::set_load_radius);
+    ClassDB::bind_method(D_METHOD("get_load_radius"), &UsdPayloadLoader::get_load_radius);
+    ClassDB::bind_method(D_METHOD("set_unload_margin", "margin"), &UsdPayloadLoader::set_unload_margin);
+    ClassDB::bind_method(D_METHOD("get_unload_margin"), &UsdPayloadLoader::get_unload_margin);
+    ClassDB::bind_method(D_METHOD("set_max_loads_per_frame", "count"), &UsdPayloadLoader::set_max_loads_per_frame);
+    ClassDB::bind_method(D_METHOD("get_max_loads_per_frame"), &UsdPayloadLoader::get_max_loads_per_frame);
+    ClassDB::bind_method(D_METHOD("set_state", "state"), &UsdPayloadLoader::set_state);
+    ClassDB::bind_method(D_METHOD("get_state"), &UsdPayloadLoader::get_state);
+
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "stage_path", PROPERTY_HINT_FILE, "*.usd,*.usda,*.usdc,*.usdz"), "set_stage_path", "get_stage_path");
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_node"), "set_root_node", "get_root_node");
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "camera", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "Node3D"), "set_camera", "get_camera");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "load_radius", PROPERTY_HINT_RANGE, "0,10000,0.1,or_greater,suffix:m"), "set_load_radius", "get_load_radius");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "unload_margin", PROPERTY_HINT_RANGE, "0,1000,0.1,or_greater,suffix:m"), "set_unload_margin", "get_unload_margin");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "max_loads_per_frame", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), "set_max_loads_per_frame", "get_max_loads_per_frame");
+    ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "state", PROPERTY_HINT_RESOURCE_TYPE, "UsdState"), "set_state", "get_state");
+
+    ADD_SIGNAL(MethodInfo("payload_loaded", PropertyInfo(Variant::STRING, "prim_path")));
+    ADD_SIGNAL(MethodInfo("payload_unloaded", PropertyInfo(Variant::STRING, "prim_path")));
+}
+
+UsdPayloadLoader::UsdPayloadLoader() {
+    _root_node = NodePath("..");
+    _load_radius = 0.0;
+    _unload_margin = 10.0;
+    _max_loads_per_frame = 1;
+    _stage = nullptr;
+}
+
+UsdPayloadLoader::~UsdPayloadLoader() {
+}
+
+void UsdPayloadLoader::_process(double p_delta) {
+    if (!_stage || _load_radius <= 0.0) {
+        return;
+    }
+    Node3D *camera = _get_camera();
+    if (camera) {
+        update_streaming(camera->get_global_position());
+    }
+}
+
+Error UsdPayloadLoader::open() {
+    close();
+
+    String abs_path = _stage_path;
+    if (_stage_path.begins_with("res://") || _stage_path.begins_with("user://")) {
+        abs_path = ProjectSettings::get_singleton()->globalize_path(_stage_path);
+    }
+
+    _stage = UsdStage::Open(abs_path.utf8().get_data(), UsdStage::LoadNone);
+    if (!_stage) {
+        UtilityFunctions::printerr("UsdPayloadLoader: Failed to open stage: ", _stage_path);
+        return ERR_CANT_OPEN;
+    }
+
+    Node *root = _get_root();
+    if (!root) {
+        UtilityFunctions::printerr("UsdPayloadLoader: Root node not found: ", _root_node);
+        _stage = nullptr;
+        return ERR_INVALID_PARAMETER;
+    }
+
+    if (_state.is_null()) {
+        _state.instantiate();
+    }
+    _document.instantiate();
+
+    _index_payloads(SdfPath::AbsoluteRootPath(), root);
+    UtilityFunctions::print("UsdPayloadLoader: Indexed ", get_payload_count(), " payloads (", get_loaded_payload_count(), " loaded)");
+
+    set_process(!Engine::get_singleton()->is_editor_hint());
+    return OK;
+}
+
+void UsdPayloadLoader::close() {
+    set_process(false);
+    _payloads.clear();
+    _document.unref();
+    _stage = nullptr;
+}
+
+bool UsdPayloadLoader::is_open() const {
+    return _stage != nullptr;
+}
+
+Error UsdPayloadLoader::load_payload(const String &p_prim_path) {
+    if (!_stage) {
+        UtilityFunctions::printerr("UsdPayloadLoader: load_payload() called before open()");
+        return ERR_UNCONFIGURED;
+    }
+    const SdfPath path(p_prim_path.utf8().get_data());
+    auto found = _payloads.find(path);
+    if (found == _payloads.end()) {
+        UtilityFunctions::printerr("UsdPayloadLoader: No payload indexed at ", p_prim_path);
+        return ERR_DOES_NOT_EXIST;
+    }
+    if (found->second.loaded) {
+        return OK;
+    }
+
+    Node3D *placeholder = _get_node(found->second);
+    Node *parent = placeholder ? placeholder->get_parent() : nullptr;
+    if (!parent) {
+        UtilityFunctions::printerr("UsdPayloadLoader: Placeholder for ", p_prim_path, " is no longer in the scene");
+        return ERR_DOES_NOT_EXIST;
+    }
+
+    // Nested payloads stay unloaded and are imported as placeholders
+    _stage->Load(path, UsdLoadWithoutDescendants);
+
+    const int index = placeholder->get_index();
+    parent->remove_child(placeholder);
+    Error err = _document->import_prim(_stage, path, parent, _state);
+    Node3D *node = err == OK ? Object::cast_to<Node3D>(parent->get_node_or_null(NodePath(placeholder->get_name()))) : nullptr;
+    if (!node) {
+        UtilityFunctions::printerr("UsdPayloadLoader: Failed to convert payload ", p_prim_path);
+        parent->add_child(placeholder);
+        parent->move_child(placeholder, index);
+        _stage->Unload(path);
+        return err != OK ? err : ERR_CANT_CREATE;
+    }
+    parent->move_child(node, index);
+    placeholder->queue_free();
+
+    Payload &payload = found->second;
+    payload.node_id = node->get_instance_id();
+    payload.loaded = true;
+    if (!payload.has_bounds) {
+        payload.has_bounds = _ComputeLocalBounds(_stage->GetPrimAtPath(path), &payload.bounds);
+    }
+
+    Node *root = _get_root();
+    if (root) {
+        _index_payloads(path, root);
+    }
+
+    emit_signal("payload_loaded", p_prim_path);
+    return OK;
+}
+
+Error UsdPayloadLoader::unload_payload(const String &p_prim_path) {
+    if (!_stage) {
+        UtilityFunctions::printerr("UsdPayloadLoader: unload_payload() called before open()");
+        return ERR_UNCONFIGURED;
+    }
+    const SdfPath path(p_prim_path.utf8().get_data());
+    auto found = _payloads.find(path);
+    if (found == _payloads.end()) {
+        UtilityFunctions::printerr("UsdPayloadLoader: No payload indexed at ", p_prim_path);
+        return ERR_DOES_NOT_EXIST;
+    }
+    if (!found->second.loaded) {
+        return OK;
+    }
+
+    // Nested payloads go away with their ancestor's nodes
+    for (auto it = _payloads.begin(); it != _payloads.end();) {
+        if (it->first != path && it->first.HasPrefix(path)) {
+            it = _payloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    Payload &payload = _payloads[path];
+    Node3D *node = _get_node(payload);
+    _stage->Unload(path);
+
+    Node3D *placeholder = UsdDocument::create_payload_placeholder(_stage->GetPrimAtPath(path));
+    if (node && node->get_parent()) {
+        Node *parent = node->get_parent();
+        const int index = node->get_index();
+        placeholder->set_transform(node->get_transform());
+        parent->remove_child(node);
+        node->queue_free();
+        parent->add_child(placeholder);
+        parent->move_child(placeholder, index);
+        placeholder->set_owner(parent->get_owner() ? parent->get_owner() : parent);
+    } else {
+        UtilityFunctions::printerr("UsdPayloadLoader: Nodes for ", p_prim_path, " are no longer in the scene");
+        memdelete(placeholder);
+        placeholder = nullptr;
+    }
+
+    payload.node_id = placeholder ? placeholder->get_instance_id() : 0;
+    payload.loaded = false;
+
+    emit_signal("payload_unloaded", p_prim_path);
+    return OK;
+}
+
+bool UsdPayloadLoader::is_payload_loaded(const String &p_prim_path) const {
+    auto found = _payloads.find(SdfPath(p_prim_path.utf8().get_data()));
+    return found != _payloads.end() && found->second.loaded;
+}
+
+void UsdPayloadLoader::update_streaming(const Vector3 &p_viewer_position) {
+    if (!_stage) {
+        return;
+    }
+
+    std::vector<std::pair<double, SdfPath>> to_load;
+    std::vector<SdfPath> to_unload;
+    for (const auto &entry : _payloads) {
+        const double distance = _get_distance(entry.second, p_viewer_position);
+        if (distance < 0.0) {
+            continue;
+        }
+        if (!entry.second.loaded && distance <= _load_radius) {
+            to_load.emplace_back(distance, entry.first);
+        } else if (entry.second.loaded && distance > _load_radius + _unload_margin) {
+            to_unload.push_back(entry.first);
+        }
+    }
+
+    // Unloading an ancestor drops its nested payloads from the index
+    for (const SdfPath &path : to_unload) {
+        if (_payloads.count(path)) {
+            unload_payload(String(path.GetText()));
+        }
+    }
+
+    std::sort(to_load.begin(), to_load.end());
+    size_t load_count = to_load.size();
+    if (_max_loads_per_frame > 0) {
+        load_count = std::min(load_count, (size_t)_max_loads_per_frame);
+    }
+    for (size_t i = 0; i < load_count; ++i) {
+        load_payload(String(to_load[i].second.GetText()));
+    }
+}
+
+PackedStringArray UsdPayloadLoader::get_payload_paths() const {
+    std::vector<SdfPath> paths;
+    paths.reserve(_payloads.size());
+    for (const auto &entry : _payloads) {
+        paths.push_back(entry.first);
+    }
+    std::sort(paths.begin(), paths.end());
+
+    PackedStringArray result;
+    for (const SdfPath &path : paths) {
+        result.push_back(String(path.GetText()));
+    }
+    return result;
+}
+
+int64_t UsdPayloadLoader::get_payload_count() const {
+    return (int64_t)_payloads.size();
+}
+
+int64_t UsdPayloadLoader::get_loaded_payload_count() const {
+    int64_t count = 0;
+    for (const auto &entry : _payloads) {
+        count += entry.second.loaded ? 1 : 0;
+    }
+    return count;
+}
+
+Node *UsdPayloadLoader::_get_root() const {
+    return get_node_or_null(_root_node);
+}
+
+Node3D *UsdPayloadLoader::_get_node(const Payload &p_payload) const {
+    return Object::cast_to<Node3D>(ObjectDB::get_instance(p_payload.node_id));
+}
+
+Node3D *UsdPayloadLoader::_get_camera() const {
+    if (!_camera.is_empty()) {
+        return Object::cast_to<Node3D>(get_node_or_null(_camera));
+    }
+    Viewport *viewport = get_viewport();
+    return viewport ? viewport->get_camera_3d() : nullptr;
+}
+
+void UsdPayloadLoader::_index_payloads(const SdfPath &p_parent_path, Node *p_root) {
+    // Loading recomposes the stage, so children are gathered by path first
+    // and prims looked up again afterwards
+    std::vector<SdfPath> children;
+    const UsdPrim parent = _stage->GetPrimAtPath(p_parent_path);
+    if (!parent) {
+        return;
+    }
+    for (const UsdPrim &child : parent.GetFilteredChildren(UsdPrimIsActive && UsdPrimIsDefined && !UsdPrimIsAbstract)) {
+        children.push_back(child.GetPath());
+    }
+
+    for (const SdfPath &child_path : children) {
+        const UsdPrim child = _stage->GetPrimAtPath(child_path);
+        if (!child.HasAuthoredPayloads()) {
+            if (child.IsLoaded()) {
+                _index_payloads(child_path, p_root);
+            }
+            continue;
+        }
+
+        Node3D *node = Object::cast_to<Node3D>(p_root->get_node_or_null(_ToNodePath(child_path)));
+        if (!node) {
+            continue;
+        }
+
+        Payload payload;
+        payload.node_id = node->get_instance_id();
+        if (node->has_meta("usd_payload_bounds")) {
+            payload.bounds = node->get_meta("usd_payload_bounds");
+            payload.has_bounds = true;
+        }
+
+        // A node that is not a placeholder was imported with its payload
+        // loaded; load it here too so the stage matches the scene
+        payload.loaded = child.IsLoaded() || !node->has_meta("usd_payload");
+        if (payload.loaded) {
+            _stage->Load(child_path, UsdLoadWithoutDescendants);
+            if (!payload.has_bounds) {
+                payload.has_bounds = _ComputeLocalBounds(_stage->GetPrimAtPath(child_path), &payload.bounds);
+            }
+        }
+        _payloads[child_path] = payload;
+
+        if (payload.loaded) {
+            _index_payloads(child_path, p_root);
+        }
+    }
+}
+
+double UsdPayloadLoader::_get_distance(const Payload &p_payload, const Vector3 &p_point) const {
+    Node3D *node = _get_node(p_payload);
+    if (!node || !node->is_inside_tree()) {
+        return -1.0;
+    }
+    const Transform3D transform = node->get_global_transform();
+    if (!p_payload.has_bounds) {
+        return transform.origin.distance_to(p_point);
+    }
+    const AABB bounds = transform.xform(p_payload.bounds);
+    return p_point.clamp(bounds.position, bounds.get_end()).distance_to(p_point);
+}
+
+void UsdPayloadLoader::set_stage_path(const String &p_path) {
+    _stage_path = p_path;
+}
+
+String UsdPayloadLoader::get_stage_path() const {
+    return _stage_path;
+}
+
+void UsdPayloadLoader::set_root_node(const NodePath &p_root_node) {
+    _root_node = p_root_node;
+}
+
+NodePath UsdPayloadLoader::get_root_node() const {
+    return _root_node;
+}
+
+void UsdPayloadLoader::set_camera(const NodePath &p_camera) {
+    _camera = p_camera;
+}
+
+NodePath UsdPayloadLoader::get_camera() const {
+    return _camera;
+}
+
+void UsdPayloadLoader::set_load_radius(double p_radius) {
+    _load_radius = MAX(p_radius, 0.0);
+}
+
+double UsdPayloadLoader::get_load_radius() const {
+    return _load_radius;
+}
+
+void UsdPayloadLoader::set_unload_margin(double p_margin) {
+    _unload_margin = MAX(p_margin, 0.0);
+}
+
+double UsdPayloadLoader::get_unload_margin() const {
+    return _unload_margin;
+}
+
+void UsdPayloadLoader::set_max_loads_per_frame(int p_count) {
+    _max_loads_per_frame = MAX(p_count, 0);
+}
+
+int UsdPayloadLoader::get_max_loads_per_frame() const {
+    return _max_loads_per_frame;
+}
+
+void UsdPayloadLoader::set_state(const Ref<UsdState> &p_state) {
+    _state = p_state;
+}
+
+Ref<UsdState> UsdPayloadLoader::get_state() const {
+    return _state;
+}
+
+} // namespace godot
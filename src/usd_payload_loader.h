@@ -0,0 +1,140 @@
+#ifndef USD_PAYLOAD_LOADER_H
+#define USD_PAYLOAD_LOADER_H
+
+#include "usd_document.h"
+#include "usd_state.h"
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/node_path.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+// USD headers
+#include <pxr/usd/usd/stage.h>
+#include <pxr/usd/sdf/path.h>
+
+#include <unordered_map>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+/**
+ * UsdPayloadLoader - Loads and converts the payloads of a lazily imported
+ * stage on demand, so memory follows what is near the camera rather than
+ * the size of the file.
+ *
+ * UsdDocument.import_from_file with UsdState.lazy_payloads opens the stage
+ * with UsdStage::LoadNone and leaves a placeholder Node3D for each payload
+ * prim, carrying its extentsHint as bounds. open() reopens the stage the
+ * same way and indexes those placeholders under root_node (matched by
+ * path, like UsdStagePlayer). load_payload() loads one payload and swaps
+ * its placeholder for the converted prims; nested payloads stay unloaded
+ * and become placeholders in turn. unload_payload() unloads it again and
+ * puts the placeholder back, releasing the composed USD data and the
+ * nodes.
+ *
+ * With load_radius set, payloads whose bounds come within that distance
+ * of the camera are loaded, nearest first and at most max_loads_per_frame
+ * per frame, and unloaded once they are more than load_radius +
+ * unload_margin away.
+ *
+ * Example GDScript usage:
+ *   var state = UsdState.new()
+ *   state.lazy_payloads = true
+ *   UsdDocument.new().import_from_file("res://city.usda", $City, state)
+ *   var loader = UsdPayloadLoader.new()
+ *   loader.stage_path = "res://city.usda"
+ *   loader.root_node = NodePath("../City")
+ *   loader.load_radius = 250.0
+ *   add_child(loader)
+ *   loader.open()
+ */
+class UsdPayloadLoader : public Node {
+    GDCLASS(UsdPayloadLoader, Node);
+
+private:
+    String _stage_path;
+    NodePath _root_node;
+    NodePath _camera; // empty follows the viewport's current camera
+    double _load_radius; // zero leaves loading to load_payload()
+    double _unload_margin;
+    int _max_loads_per_frame; // zero is unlimited
+    Ref<UsdState> _state; // import options for converted payloads
+
+    UsdStageRefPtr _stage;
+    Ref<UsdDocument> _document;
+
+    struct Payload {
+        uint64_t node_id = 0; // placeholder while unloaded, converted prim once loaded
+        AABB bounds; // in the prim's local space
+        bool has_bounds = false;
+        bool loaded = false;
+    };
+    std::unordered_map<SdfPath, Payload, SdfPath::Hash> _payloads;
+
+    Node *_get_root() const;
+    Node3D *_get_node(const Payload &p_payload) const;
+    Node3D *_get_camera() const;
+    void _index_payloads(const SdfPath &p_parent_path, Node *p_root);
+    double _get_distance(const Payload &p_payload, const Vector3 &p_point) const;
+
+protected:
+    static void _bind_methods();
+
+public:
+    UsdPayloadLoader();
+    ~UsdPayloadLoader();
+
+    void _process(double p_delta) override;
+
+    /// Open stage_path with no payloads loaded and index the payload
+    /// prims that have a node under root_node.
+    Error open();
+
+    /// Release the stage and the index. Converted payloads stay in the scene.
+    void close();
+    bool is_open() const;
+
+    /// Load one payload and replace its placeholder with the converted prims.
+    Error load_payload(const String &p_prim_path);
+
+    /// Unload one payload, nested payloads included, and restore its placeholder.
+    Error unload_payload(const String &p_prim_path);
+
+    bool is_payload_loaded(const String &p_prim_path) const;
+
+    /// Load and unload by distance from p_viewer_position. Called every
+    /// frame with the camera position when load_radius is set.
+    void update_streaming(const Vector3 &p_viewer_position);
+
+    PackedStringArray get_payload_paths() const;
+    int64_t get_payload_count() const;
+    int64_t get_loaded_payload_count() const;
+
+    void set_stage_path(const String &p_path);
+    String get_stage_path() const;
+
+    void set_root_node(const NodePath &p_root_node);
+    NodePath get_root_node() const;
+
+    void set_camera(const NodePath &p_camera);
+    NodePath get_camera() const;
+
+    void set_load_radius(double p_radius);
+    double get_load_radius() const;
+
+    void set_unload_margin(double p_margin);
+    double get_unload_margin() const;
+
+    void set_max_loads_per_frame(int p_count);
+    int get_max_loads_per_frame() const;
+
+    void set_state(const Ref<UsdState> &p_state);
+    Ref<UsdState> get_state() const;
+};
+
+} // namespace godot
+
+#endif // USD_PAYLOAD_LOADER_H
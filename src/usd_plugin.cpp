@@ -3,11 +3,14 @@
 #include "usd_export_settings.h"
 #include "usd_mesh_export_helper.h"
 #include "usd_mesh_import_helper.h"
+#include "usd_instance_import_helper.h"
 #include "usd_state.h"
 #include "mcp_control_panel.h"
 #include "mcp_server.h"
 #include "mcp_globals.h"
 #include "usd_stage_group_mapping.h"
+#include "usd_group_reflector.h"
+#include "usd_stage_manager.h"
 #include "usd_stage_manager_panel.h"
 #include <godot_cpp/classes/button.hpp>
 #include <godot_cpp/classes/dir_access.hpp>
@@ -25,6 +28,7 @@
 #include <godot_cpp/classes/packed_scene.hpp>
 #include <godot_cpp/classes/resource_saver.hpp>
 #include <godot_cpp/classes/standard_material3d.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/material.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/memory.hpp>
@@ -34,6 +38,7 @@
 #include <pxr/base/plug/registry.h>
 #include <pxr/base/vt/array.h>
 #include <pxr/base/gf/vec3f.h>
+#include <pxr/usd/usd/primRange.h>
 
 #include <mutex>
 #include <condition_variable>
@@ -58,7 +63,7 @@ void USDPlugin::_bind_methods() {
     ClassDB::bind_method(D_METHOD("_popup_usd_import_dialog"), &USDPlugin::_popup_usd_import_dialog);
     ClassDB::bind_method(D_METHOD("_import_usd_file", "file_path"), &USDPlugin::_import_usd_file);
     ClassDB::bind_method(D_METHOD("_on_import_confirmed"), &USDPlugin::_on_import_confirmed);
-    ClassDB::bind_method(D_METHOD("_import_to_group", "file_path", "group_name", "force"), &USDPlugin::_import_to_group);
+    ClassDB::bind_method(D_METHOD("_import_to_group", "file_path", "group_name", "force", "incremental"), &USDPlugin::_import_to_group, DEFVAL(false), DEFVAL(false));
     ClassDB::bind_method(D_METHOD("_query_scene_tree", "path"), &USDPlugin::_query_scene_tree);
     ClassDB::bind_method(D_METHOD("_perform_scene_query_deferred", "query_id"), &USDPlugin::_perform_scene_query_deferred);
 
@@ -112,6 +117,9 @@ USDPlugin::~USDPlugin() {
 void USDPlugin::_enter_tree() {
     // Called when the plugin is added to the editor
     UtilityFunctions::print("USD Plugin: Enter Tree");
+
+    // Live stage edits are pushed into reflected groups once per frame
+    set_process(true);
     
     // Get the project root directory
     // In Godot, we can use the OS class to get the current directory
@@ -166,13 +174,13 @@ void USDPlugin::_enter_tree() {
     // Set up MCP import callback (for usd/reflect_to_scene and usd/confirm_reflect commands)
     mcp::McpServer* mcp_server = usd_godot::get_mcp_server_instance();
     if (mcp_server) {
-        mcp_server->set_import_callback([this](const std::string& file_path, const std::string& group_name, bool force) -> int {
+        mcp_server->set_import_callback([this](const std::string& file_path, const std::string& group_name, bool force, bool incremental) -> int {
             // This callback runs on MCP thread, so use call_deferred to run on main thread
             String godot_file_path(file_path.c_str());
             String godot_group_name(group_name.c_str());
 
             // Use call_deferred to run on main thread
-            call_deferred("_import_to_group", godot_file_path, godot_group_name, force);
+            call_deferred("_import_to_group", godot_file_path, godot_group_name, force, incremental);
 
             // Return 0 to indicate success (actual node count can't be returned from async operation)
             return 0;
@@ -477,7 +485,7 @@ void USDPlugin::_popup_usd_export_dialog() {
     if (filename.is_empty()) {
         filename = edited_scene_root->get_name();
     }
-    _file_dialog->set_current_file(filename + String(".usd"));
+    _file_dialog->set_current_file(filename + String(".") + _usd_document->get_file_extension_for_format(_export_settings->get_use_binary_format()));
     
     // Generate and refresh the export settings
     _export_settings->generate_property_list(_usd_document, edited_scene_root);
@@ -528,6 +536,10 @@ void USDPlugin::_export_scene_as_usd(const String &p_file_path) {
     state.instantiate();
     state->set_copyright(_export_settings->get_copyright());
     state->set_bake_fps(_export_settings->get_bake_fps());
+    state->set_export_animations(_export_settings->get_export_animations());
+    state->set_use_binary_format(_export_settings->get_use_binary_format());
+    state->set_export_materials(_export_settings->get_export_materials());
+    state->set_export_textures(_export_settings->get_export_textures());
     
     // Export the scene
     Error err = _usd_document->append_from_scene(edited_scene_root, state);
@@ -611,7 +623,11 @@ void USDPlugin::_import_usd_file(const String &p_file_path) {
         
         // Convert USD prims to Godot nodes
         // Pass the root node as both the parent and the scene root
-        _convert_prim_to_node(defaultPrim, root, root);
+        UsdMeshImportHelper mesh_helper;
+        UsdInstanceImportHelper instance_helper(mesh_helper);
+        UsdGroupReflector::convert_prim(defaultPrim, root, root, mesh_helper, instance_helper);
+        instance_helper.build_instance_groups(root, root);
+        mesh_helper.print_stats();
         
         // Print the node hierarchy for debugging
         //UtilityFunctions::print("USD Import: Node hierarchy before packing:");
@@ -649,152 +665,6 @@ void USDPlugin::_import_usd_file(const String &p_file_path) {
     }
 }
 
-// Helper method to extract and apply transform from a USD prim to a Godot node
-bool USDPlugin::_apply_transform_from_usd_prim(const UsdPrim &p_prim, Node3D *p_node) {
-    if (!p_node) {
-        return false;
-    }
-    
-    // Extract transform from USD prim
-    UsdGeomXform usdXform(p_prim);
-    bool reset_xform_stack = false;
-    std::vector<UsdGeomXformOp> xform_ops = usdXform.GetOrderedXformOps(&reset_xform_stack);
-    
-    if (xform_ops.empty()) {
-        //UtilityFunctions::print("USD Import: No transform found for node: ", p_node->get_name());
-        return false;
-    }
-    
-    // Get the transform matrix
-    GfMatrix4d usd_matrix;
-    bool resetsXformStack = false;
-    usdXform.GetLocalTransformation(&usd_matrix, &resetsXformStack);
-    
-    // Convert USD matrix to Godot transform
-    Transform3D transform;
-    
-    // Extract basis (rotation and scale)
-    Basis basis(
-        Vector3(usd_matrix[0][0], usd_matrix[0][1], usd_matrix[0][2]),
-        Vector3(usd_matrix[1][0], usd_matrix[1][1], usd_matrix[1][2]),
-        Vector3(usd_matrix[2][0], usd_matrix[2][1], usd_matrix[2][2])
-    );
-    
-    // Extract translation
-    Vector3 origin(usd_matrix[3][0], usd_matrix[3][1], usd_matrix[3][2]);
-    
-    // Set the transform
-    transform.set_basis(basis);
-    transform.set_origin(origin);
-    
-    // Apply the transform to the node
-    p_node->set_transform(transform);
-    
-    //UtilityFunctions::print("USD Import: Applied transform to node: ", p_node->get_name());
-    return true;
-}
-
-// Helper method to convert a USD prim to a Godot node
-Node *USDPlugin::_convert_prim_to_node(const UsdPrim &p_prim, Node *p_parent, Node *p_scene_root) {
-    // Skip the pseudo-root
-    if (p_prim.IsPseudoRoot()) {
-        // Process children
-        for (UsdPrim child : p_prim.GetChildren()) {
-            _convert_prim_to_node(child, p_parent, p_scene_root ? p_scene_root : p_parent);
-        }
-        return p_parent;
-    }
-    
-    // Get the prim type and name
-    String prim_type = String(p_prim.GetTypeName().GetText());
-    String prim_name = String(p_prim.GetName().GetText());
-    
-    bool prim_is_mesh = !!pxr::UsdGeomGprim(p_prim);
-
-    // Debug output
-    //UtilityFunctions::print("USD Import: Converting prim: ", prim_name, " with type: ", prim_type);
-    
-    // Create a node based on the prim type
-    Node *node = nullptr;
-    
-    if (prim_type == "Xform") {
-        // Create a Node3D for Xform prims
-        Node3D *xform = memnew(Node3D);
-        xform->set_name(prim_name);
-        
-        // Apply transform from USD prim
-        _apply_transform_from_usd_prim(p_prim, xform);
-        
-        node = xform;
-    } else if (prim_type == "Scope") {
-        // Create a Node3D for Scope prims (organizational)
-        Node3D *scope = memnew(Node3D);
-        scope->set_name(prim_name);
-        
-        // Apply transform from USD prim
-        _apply_transform_from_usd_prim(p_prim, scope);
-        
-        //UtilityFunctions::print("USD Import: Created Scope node: ", prim_name);
-        node = scope;
-    } else if (prim_type == "Material" || prim_type == "Shader") {
-        // Skip materials and shaders for now
-        // In a full implementation, we would create materials and shaders
-        // UtilityFunctions::print("USD Import: Skipping Material/Shader: ", prim_name);
-    } else if (prim_is_mesh) {
-        // Create a MeshInstance3D with a BoxMesh for Cube prims
-        MeshInstance3D *mesh_instance = memnew(MeshInstance3D);
-        mesh_instance->set_name(prim_name);
-        
-        UsdMeshImportHelper helper;
-        Ref<Mesh> box_mesh = helper.import_mesh_from_prim(p_prim);
-        if (box_mesh.is_valid()) {
-            mesh_instance->set_mesh(box_mesh);
-            auto mat = helper.create_material(p_prim);
-                        
-            // Apply the material to the mesh
-            if (mat.is_valid()) {
-                mesh_instance->set_surface_override_material(0, mat);
-            }
-
-            // Apply transform from USD prim
-            _apply_transform_from_usd_prim(p_prim, mesh_instance);
-        }        
-        //UtilityFunctions::print("USD Import: Created ", prim_type, " node: ", prim_name);
-        node = mesh_instance;
-    } else {
-        // For empty or unknown prim types, create a Node3D
-        // This handles cases like "Shapes" and "Materials" which have empty type names
-        Node3D *generic = memnew(Node3D);
-        generic->set_name(prim_name);
-        
-        // Apply transform from USD prim
-        _apply_transform_from_usd_prim(p_prim, generic);
-        
-        //UtilityFunctions::print("USD Import: Created generic node for type: ", prim_type, " prim: ", prim_name);
-        node = generic;
-    }
-    
-    // Add the node to the parent
-    if (node) {
-        p_parent->add_child(node);
-        
-        // Set the owner for proper serialization
-        if (p_scene_root) {
-            node->set_owner(p_scene_root);
-        } else {
-            // If no scene root is provided, use the node itself as the owner
-            node->set_owner(p_parent->get_owner());
-        }
-        
-        // Process children
-        for (UsdPrim child : p_prim.GetChildren()) {
-            _convert_prim_to_node(child, node, p_scene_root);
-        }
-    }
-    
-    return node;
-}
-
 // Helper method to print the prim hierarchy
 void USDPlugin::_print_prim_hierarchy(const UsdPrim &p_prim, int p_indent) {
     // Create an indentation string
@@ -834,6 +704,53 @@ void USDPlugin::_print_node_hierarchy(Node *p_node, int p_indent) {
     }
 }
 
+void USDPlugin::_process(double p_delta) {
+    _dispatch_stage_changes();
+}
+
+void USDPlugin::_dispatch_stage_changes() {
+    UsdStageGroupMapping *mapping = UsdStageGroupMapping::get_singleton();
+    if (!mapping || _group_syncs.empty()) {
+        return;
+    }
+
+    // Each group listens to its own stage, so stage records keep their
+    // changes for UsdStageProxy.take_changes() and MCP. Collected first
+    // because a fallback rebuild replaces the group's entry.
+    std::vector<std::pair<String, String>> pending; // file path, group name
+    for (const auto &entry : _group_syncs) {
+        if (entry.second->has_pending_changes()) {
+            pending.emplace_back(entry.second->get_file_path(), String(entry.first.c_str()));
+        }
+    }
+
+    usd_godot::UsdStageManager &manager = usd_godot::UsdStageManager::get_singleton();
+    for (const std::pair<String, String> &group : pending) {
+        const String &file_path = group.first;
+        const String &group_name = group.second;
+        if (!mapping->has_mapping(file_path) || mapping->get_group_name(file_path) != group_name) {
+            continue;
+        }
+
+        // Everything edited since the last frame goes out as one update.
+        // MCP edits wait until the sync, or the rebuild replacing it, is
+        // done reading the shared layers.
+        std::unique_lock<std::recursive_mutex> layers_lock = manager.lock_layers();
+        if (!_sync_group(file_path, group_name, false)) {
+            _import_to_group(file_path, group_name, true, false);
+        }
+
+        const std::string path = file_path.utf8().get_data();
+        for (usd_godot::StageId stage_id : manager.get_active_stages()) {
+            usd_godot::StageRecord *record = manager.get_stage_record(stage_id);
+            if (record && record->get_file_path() == path) {
+                mapping->update_generation(file_path, record->get_generation());
+                break;
+            }
+        }
+    }
+}
+
 bool USDPlugin::_has_main_screen() const {
     // Return true if the plugin needs a main screen
     return false;
@@ -900,7 +817,7 @@ void USDPlugin::_on_import_confirmed() {
 }
 
 // Import USD file to a scene group
-void USDPlugin::_import_to_group(const String &p_file_path, const String &p_group_name, bool p_force) {
+void USDPlugin::_import_to_group(const String &p_file_path, const String &p_group_name, bool p_force, bool p_incremental) {
     EditorInterface *editor = EditorInterface::get_singleton();
     if (!editor) {
         UtilityFunctions::printerr("USD Import: Failed to get EditorInterface singleton");
@@ -930,7 +847,13 @@ void USDPlugin::_import_to_group(const String &p_file_path, const String &p_grou
         }
     }
 
+    // Apply only what changed since the last reflect when possible
+    if (p_force && p_incremental && _sync_group(p_file_path, p_group_name)) {
+        return;
+    }
+
     // If force=true or group is empty, proceed with import
+    _group_syncs.erase(std::string(p_group_name.utf8().get_data()));
     if (p_force) {
         // Remove existing nodes in group
         _remove_nodes_in_group(p_group_name);
@@ -938,64 +861,51 @@ void USDPlugin::_import_to_group(const String &p_file_path, const String &p_grou
 
     UtilityFunctions::print("USD Import: Importing USD file to group '", p_group_name, "' from ", p_file_path);
 
-    try {
-        // Open the USD stage
-        UsdStageRefPtr stage = UsdStage::Open(p_file_path.utf8().get_data());
-        if (!stage) {
-            UtilityFunctions::printerr("USD Import: Failed to open USD stage from ", p_file_path);
-            return;
-        }
-
-        // Get the default prim
-        UsdPrim defaultPrim = stage->GetDefaultPrim();
-        if (!defaultPrim) {
-            defaultPrim = stage->GetPseudoRoot();
-        }
+    // The reflector remembers which node each prim became, for
+    // incremental reflects and live updates
+    Ref<UsdGroupReflector> reflector;
+    reflector.instantiate();
+    if (!reflector->reflect(p_file_path, edited_scene, p_group_name)) {
+        return;
+    }
 
-        // Create a parent node for the imported hierarchy
-        Node3D *group_parent = memnew(Node3D);
-        group_parent->set_name(p_group_name);
+    // Update mapping with current generation (0 for now, will be tracked by MCP)
+    UsdStageGroupMapping::get_singleton()->set_mapping(p_file_path, p_group_name);
+    UsdStageGroupMapping::get_singleton()->update_generation(p_file_path, 0);
 
-        // Add the parent to the scene FIRST (before converting prims)
-        // This ensures the parent is in the tree before we set_owner on children
-        edited_scene->add_child(group_parent);
-        group_parent->set_owner(edited_scene);
+    _group_syncs[std::string(p_group_name.utf8().get_data())] = reflector;
 
-        // Now convert USD prims to Godot nodes
-        _convert_prim_to_node(defaultPrim, group_parent, edited_scene);
+    UtilityFunctions::print("USD Import: Successfully imported to group '", p_group_name, "' with ", _count_nodes_in_group(p_group_name), " nodes");
+}
 
-        // Add all imported nodes (including parent) to the group
-        TypedArray<Node> all_children;
-        all_children.push_back(group_parent);
+// Apply the changes collected since the last reflect to an existing group.
+// Returns false when the group has to be rebuilt instead.
+bool USDPlugin::_sync_group(const String &p_file_path, const String &p_group_name, bool p_verbose) {
+    auto found = _group_syncs.find(std::string(p_group_name.utf8().get_data()));
+    if (found == _group_syncs.end() || found->second->get_file_path() != p_file_path) {
+        return false;
+    }
+    Ref<UsdGroupReflector> reflector = found->second;
+    Node *group_root = reflector->get_group_root();
+    Node *edited_scene = EditorInterface::get_singleton()->get_edited_scene_root();
+    if (!group_root || !edited_scene || !edited_scene->is_ancestor_of(group_root)) {
+        return false;
+    }
 
-        // Recursively collect all children
-        std::function<void(Node*)> collect_children;
-        collect_children = [&](Node *node) {
-            for (int i = 0; i < node->get_child_count(); i++) {
-                Node *child = node->get_child(i);
-                all_children.push_back(child);
-                collect_children(child);
-            }
-        };
-        collect_children(group_parent);
+    if (!reflector->sync()) {
+        return false;
+    }
 
-        // Add all nodes to the group
-        for (int i = 0; i < all_children.size(); i++) {
-            Node *node = Object::cast_to<Node>(all_children[i]);
-            if (node) {
-                node->add_to_group(p_group_name);
-            }
+    if (p_verbose) {
+        Dictionary stats = reflector->get_sync_stats();
+        if ((int64_t)stats["change_count"] == 0) {
+            UtilityFunctions::print("USD Import: Group '", p_group_name, "' is up to date");
+        } else {
+            UtilityFunctions::print("USD Import: Synced group '", p_group_name, "': ", stats["rebuilt_count"], " prims rebuilt, ",
+                    stats["updated_count"], " properties updated in ", stats["sync_usec"], " us");
         }
-
-        // Update mapping with current generation (0 for now, will be tracked by MCP)
-        UsdStageGroupMapping::get_singleton()->set_mapping(p_file_path, p_group_name);
-        UsdStageGroupMapping::get_singleton()->update_generation(p_file_path, 0);
-
-        UtilityFunctions::print("USD Import: Successfully imported to group '", p_group_name, "' with ", all_children.size(), " nodes");
-
-    } catch (const std::exception& e) {
-        UtilityFunctions::printerr("USD Import: Exception occurred: ", e.what());
     }
+    return true;
 }
 
 String USDPlugin::_query_scene_tree(const String &p_path) {
@@ -1492,22 +1402,20 @@ String USDPlugin::_get_bounding_box(const String &p_node_path) {
         return "{}";
     }
 
-    // Calculate AABB from all VisualInstance3D children
+    // Prims of reflected groups are answered from the stage's cached
+    // bounds hierarchy; anything else walks the scene
     AABB combined_aabb;
-    bool has_aabb = false;
+    bool has_aabb = _get_group_bounds(target_node, &combined_aabb);
+    const char *source = "usd";
 
     // Helper lambda to recursively collect AABBs
     std::function<void(Node*)> collect_aabbs = [&](Node* node) {
         // Check if this node is a VisualInstance3D (has AABB)
         VisualInstance3D *visual = Object::cast_to<VisualInstance3D>(node);
         if (visual) {
-            AABB local_aabb = visual->get_aabb();
-            Transform3D global_transform = visual->get_global_transform();
-
-            // Transform AABB to global space
-            AABB global_aabb = local_aabb;
-            global_aabb.position = global_transform.xform(local_aabb.position);
-            global_aabb.size *= global_transform.basis.get_scale();
+            // Transform all eight corners, so rotated nodes get the box
+            // that encloses them
+            AABB global_aabb = visual->get_global_transform().xform(visual->get_aabb());
 
             if (!has_aabb) {
                 combined_aabb = global_aabb;
@@ -1523,8 +1431,10 @@ String USDPlugin::_get_bounding_box(const String &p_node_path) {
         }
     };
 
-    // Start collection from target node
-    collect_aabbs(target_node);
+    if (!has_aabb) {
+        source = "scene";
+        collect_aabbs(target_node);
+    }
 
     if (!has_aabb) {
         return "{}";
@@ -1540,12 +1450,50 @@ String USDPlugin::_get_bounding_box(const String &p_node_path) {
     result += "\"min\":[" + String::num(min_point.x) + "," + String::num(min_point.y) + "," + String::num(min_point.z) + "],";
     result += "\"max\":[" + String::num(max_point.x) + "," + String::num(max_point.y) + "," + String::num(max_point.z) + "],";
     result += "\"center\":[" + String::num(center.x) + "," + String::num(center.y) + "," + String::num(center.z) + "],";
-    result += "\"size\":[" + String::num(size.x) + "," + String::num(size.y) + "," + String::num(size.z) + "]";
+    result += "\"size\":[" + String::num(size.x) + "," + String::num(size.y) + "," + String::num(size.z) + "],";
+    result += "\"source\":\"" + String(source) + "\"";
     result += "}";
 
     return result;
 }
 
+bool USDPlugin::_get_group_bounds(Node *p_node, AABB *r_bounds) {
+    for (const auto &entry : _group_syncs) {
+        UsdGroupSync *sync = entry.second->get_group_sync();
+        Node3D *group_root = Object::cast_to<Node3D>(sync->get_group_root());
+        if (!group_root || (group_root != p_node && !group_root->is_ancestor_of(p_node))) {
+            continue;
+        }
+
+        // Nodes added by hand or merged into instance groups have no prim
+        SdfPath prim_path = sync->get_prim_path(p_node);
+        if (prim_path.IsEmpty()) {
+            return false;
+        }
+        if (prim_path.IsAbsoluteRootPath()) {
+            // The group root holds what was imported, not the whole stage
+            prim_path = sync->get_import_root();
+        }
+
+        GfRange3d range;
+        {
+            std::unique_lock<std::recursive_mutex> layers_lock = usd_godot::UsdStageManager::get_singleton().lock_layers();
+            range = sync->get_bounds_hierarchy()->get_bounds(prim_path);
+        }
+        if (range.IsEmpty()) {
+            return false;
+        }
+
+        // Stage space is the group root's local space
+        const GfVec3d min = range.GetMin();
+        const GfVec3d size = range.GetSize();
+        AABB local_aabb(Vector3(min[0], min[1], min[2]), Vector3(size[0], size[1], size[2]));
+        *r_bounds = group_root->get_global_transform().xform(local_aabb);
+        return true;
+    }
+    return false;
+}
+
 String USDPlugin::_get_selection() {
     EditorInterface *editor = EditorInterface::get_singleton();
     if (!editor) {
@@ -1,6 +1,7 @@
 #ifndef USD_PLUGIN_H
 #define USD_PLUGIN_H
 
+#include "usd_group_reflector.h"
 #include <godot_cpp/classes/editor_plugin.hpp>
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/variant/string.hpp>
@@ -67,20 +68,27 @@ private:
     void _import_usd_file(const String &p_file_path);
     void _on_import_confirmed();
     int _count_nodes_in_group(const String &p_group_name);
+    // Live updates pass p_verbose = false so every frame with an edit does
+    // not log; explicit reflects report what they did
+    bool _sync_group(const String &p_file_path, const String &p_group_name, bool p_verbose = true);
+
+    // Push stage edits collected since the last frame into reflected groups
+    void _dispatch_stage_changes();
+
+    // Reflect state per scene group name, for incremental reflects
+    std::map<std::string, Ref<UsdGroupReflector>> _group_syncs;
     void _remove_nodes_in_group(const String &p_group_name);
 
+    // World bounds of a node that a reflected group maps to a prim, from
+    // that group's bounds hierarchy instead of the scene tree
+    bool _get_group_bounds(Node *p_node, AABB *r_bounds);
+
     // Helper method to print the prim hierarchy
     void _print_prim_hierarchy(const UsdPrim &p_prim, int p_indent);
     
     // Helper method to print the node hierarchy
     void _print_node_hierarchy(Node *p_node, int p_indent);
     
-    // Helper method to extract and apply transform from a USD prim to a Godot node
-    bool _apply_transform_from_usd_prim(const UsdPrim &p_prim, Node3D *p_node);
-    
-    // Helper method to convert a USD prim to a Godot node
-    Node *_convert_prim_to_node(const UsdPrim &p_prim, Node *p_parent, Node *p_scene_root);
-
 protected:
     static void _bind_methods();
 
@@ -90,13 +98,16 @@ public:
 
     virtual void _enter_tree() override;
     virtual void _exit_tree() override;
+    virtual void _process(double p_delta) override;
     virtual bool _has_main_screen() const override;
     virtual String _get_plugin_name() const override;
 
     void _on_hello_button_pressed();
 
     // Public import method for USD Stage Manager Panel
-    void _import_to_group(const String &p_file_path, const String &p_group_name, bool p_force = false);
+    // With p_force and p_incremental an existing group is updated in place
+    // from the changes since the last reflect, falling back to a rebuild
+    void _import_to_group(const String &p_file_path, const String &p_group_name, bool p_force = false, bool p_incremental = false);
 
     // Public scene query method for MCP
     String _query_scene_tree(const String &p_path);
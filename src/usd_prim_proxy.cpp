@@ -1,4 +1,5 @@
 #include "usd_prim_proxy.h"
+#include "usd_array_utils.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
@@ -880,19 +881,18 @@ Variant UsdPrimProxy::_usd_value_to_variant(const pxr::VtValue &p_value) {
         return result;
     }
     if (p_value.IsHolding<pxr::VtArray<int>>()) {
-        pxr::VtArray<int> arr = p_value.Get<pxr::VtArray<int>>();
         PackedInt32Array result;
-        for (int i : arr) {
-            result.push_back(i);
-        }
+        UsdArrayUtils::to_packed_array(p_value.UncheckedGet<pxr::VtArray<int>>(), &result);
         return result;
     }
     if (p_value.IsHolding<pxr::VtArray<pxr::GfVec3f>>()) {
-        pxr::VtArray<pxr::GfVec3f> arr = p_value.Get<pxr::VtArray<pxr::GfVec3f>>();
         PackedVector3Array result;
-        for (const pxr::GfVec3f &v : arr) {
-            result.push_back(Vector3(v[0], v[1], v[2]));
-        }
+        UsdArrayUtils::to_packed_array(p_value.UncheckedGet<pxr::VtArray<pxr::GfVec3f>>(), &result);
+        return result;
+    }
+    if (p_value.IsHolding<pxr::VtArray<pxr::GfVec2f>>()) {
+        PackedVector2Array result;
+        UsdArrayUtils::to_packed_array(p_value.UncheckedGet<pxr::VtArray<pxr::GfVec2f>>(), &result);
         return result;
     }
 
@@ -222,6 +222,7 @@ UsdStageRefPtr StageRecord::ensure_stage() {
         stage_ = UsdStage::Open(file_path_);
         if (stage_) {
             is_loaded_ = true;
+            listener_->attach(stage_);
         }
     }
     return stage_;
@@ -230,11 +231,24 @@ UsdStageRefPtr StageRecord::ensure_stage() {
 void StageRecord::unload() {
     if (stage_) {
         UtilityFunctions::print("UsdStageManager: Unloading stage ", String(file_path_.c_str()));
+        listener_->detach();
+        bounds_.reset();
         stage_ = nullptr;
         is_loaded_ = false;
     }
 }
 
+UsdBoundsHierarchy* StageRecord::get_bounds_hierarchy() {
+    if (!stage_) {
+        return nullptr;
+    }
+    if (!bounds_) {
+        bounds_ = std::make_shared<UsdBoundsHierarchy>(stage_);
+    }
+    bounds_->update();
+    return bounds_.get();
+}
+
 // ============================================================================
 // UsdStageManager Implementation
 // ============================================================================
@@ -245,7 +259,7 @@ UsdStageManager& UsdStageManager::get_singleton() {
 }
 
 StageId UsdStageManager::create_stage(const std::string& file_path) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     UsdStageRefPtr stage;
 
@@ -273,7 +287,7 @@ StageId UsdStageManager::create_stage(const std::string& file_path) {
 }
 
 StageId UsdStageManager::open_stage(const std::string& file_path) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     UsdStageRefPtr stage = UsdStage::Open(file_path);
 
@@ -293,7 +307,7 @@ StageId UsdStageManager::open_stage(const std::string& file_path) {
 }
 
 StageRecord* UsdStageManager::get_stage_record(StageId id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -304,7 +318,7 @@ StageRecord* UsdStageManager::get_stage_record(StageId id) {
 }
 
 bool UsdStageManager::close_stage(StageId id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -318,7 +332,7 @@ bool UsdStageManager::close_stage(StageId id) {
 }
 
 bool UsdStageManager::save_stage(StageId id, const std::string& file_path) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -355,7 +369,7 @@ bool UsdStageManager::save_stage(StageId id, const std::string& file_path) {
 }
 
 uint64_t UsdStageManager::get_generation(StageId id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -366,7 +380,7 @@ uint64_t UsdStageManager::get_generation(StageId id) {
 }
 
 bool UsdStageManager::create_prim(StageId id, const std::string& path, const std::string& type_name) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -390,7 +404,7 @@ bool UsdStageManager::create_prim(StageId id, const std::string& path, const std
 }
 
 std::vector<StageId> UsdStageManager::get_active_stages() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     std::vector<StageId> ids;
     ids.reserve(stages_.size());
@@ -405,7 +419,7 @@ std::vector<StageId> UsdStageManager::get_active_stages() const {
 bool UsdStageManager::set_prim_attribute(StageId id, const std::string& prim_path,
                                          const std::string& attr_name, const std::string& value_type,
                                          const std::string& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -428,7 +442,7 @@ bool UsdStageManager::set_prim_attribute(StageId id, const std::string& prim_pat
 bool UsdStageManager::get_prim_attribute(StageId id, const std::string& prim_path,
                                          const std::string& attr_name, std::string& out_value,
                                          std::string& out_type) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -444,7 +458,7 @@ bool UsdStageManager::set_prim_transform(StageId id, const std::string& prim_pat
                                          double tx, double ty, double tz,
                                          double rx, double ry, double rz,
                                          double sx, double sy, double sz) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     auto it = stages_.find(id);
     if (it == stages_.end()) {
@@ -464,7 +478,7 @@ bool UsdStageManager::set_prim_transform(StageId id, const std::string& prim_pat
 }
 
 std::vector<std::string> UsdStageManager::list_prims(StageId id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     std::vector<std::string> prim_paths;
 
@@ -491,7 +505,7 @@ std::vector<std::string> UsdStageManager::list_prims(StageId id) {
 
 // Registry persistence for lazy loading
 StageId UsdStageManager::register_stage(const std::string& file_path, uint64_t generation) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
 
     StageId id = next_id_++;
     stages_.emplace(id, StageRecord(file_path, generation));
@@ -1,9 +1,13 @@
 #ifndef USD_GODOT_STAGE_MANAGER_H
 #define USD_GODOT_STAGE_MANAGER_H
 
+#include "usd_change_listener.h"
+#include "usd_bounds_hierarchy.h"
+
 #include <pxr/usd/usd/stage.h>
 #include <string>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <cstdint>
 
@@ -20,11 +24,13 @@ class StageRecord {
 public:
     // Constructor for loaded stage
     StageRecord(UsdStageRefPtr stage, const std::string& file_path = "")
-        : stage_(stage), file_path_(file_path), generation_(0), is_loaded_(true) {}
+        : stage_(stage), file_path_(file_path), generation_(0), is_loaded_(true),
+          listener_(std::make_shared<UsdChangeListener>()) { listener_->attach(stage_); }
 
     // Constructor for unloaded stage (lazy loading)
     StageRecord(const std::string& file_path, uint64_t generation = 0)
-        : stage_(nullptr), file_path_(file_path), generation_(generation), is_loaded_(false) {}
+        : stage_(nullptr), file_path_(file_path), generation_(generation), is_loaded_(false),
+          listener_(std::make_shared<UsdChangeListener>()) {}
 
     // Read-only access - returns stage (may be null if not loaded)
     UsdStageRefPtr get_stage() const { return stage_; }
@@ -38,6 +44,16 @@ public:
     // Unload stage to free memory
     void unload();
 
+    // Changes reported by UsdNotice::ObjectsChanged since the last take,
+    // from any editor of the stage. Safe to call from any thread.
+    bool has_pending_changes() const { return listener_->has_changes(); }
+    bool take_changes(StageChanges* out_changes) { return listener_->take_changes(out_changes); }
+
+    // World-space bounds of the stage's leaves for bounds, ray and frustum
+    // queries. Built on first use and brought up to date from change
+    // notices on every call. Null if the stage is not loaded.
+    UsdBoundsHierarchy* get_bounds_hierarchy();
+
     // Set generation (for loading from registry)
     void set_generation(uint64_t gen) { generation_ = gen; }
 
@@ -76,6 +92,12 @@ private:
     std::string file_path_;
     uint64_t generation_;
     bool is_loaded_;
+
+    // Shared so the registration survives copies of the record
+    std::shared_ptr<UsdChangeListener> listener_;
+
+    // Shared for the same reason; created by get_bounds_hierarchy()
+    std::shared_ptr<UsdBoundsHierarchy> bounds_;
 };
 
 // Central stage manager - shared between MCP server and GDScript bindings
@@ -134,6 +156,13 @@ public:
     // Register a stage without loading it (for lazy loading)
     StageId register_stage(const std::string& file_path, uint64_t generation = 0);
 
+    // Layers are shared through the SdfLayer registry, so every stage on
+    // the same files (a reflected scene group, a bounds hierarchy) reads
+    // what MCP edits write. Hold this around such reads on the main thread
+    // so the MCP thread can't change a layer mid-read. Recursive, so
+    // manager calls made while holding it don't deadlock.
+    std::unique_lock<std::recursive_mutex> lock_layers() const { return std::unique_lock<std::recursive_mutex>(mutex_); }
+
 private:
     UsdStageManager() : next_id_(1) {}
     ~UsdStageManager() = default;
@@ -144,7 +173,7 @@ private:
 
     std::map<StageId, StageRecord> stages_;
     StageId next_id_;
-    mutable std::mutex mutex_;
+    mutable std::recursive_mutex mutex_;
 };
 
 } // namespace usd_godot
@@ -0,0 +1,285 @@
+#include "usd_stage_player.h"
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/imageable.h>
+#include <pxr/usd/usdGeom/tokens.h>
+#include <pxr/usd/usdGeom/xformable.h>
+
+#include <cmath>
+
+namespace godot {
+
+void UsdStagePlayer::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("load"), &UsdStagePlayer::load);
+    ClassDB::bind_method(D_METHOD("unload"), &UsdStagePlayer::unload);
+    ClassDB::bind_method(D_METHOD("is_loaded"), &UsdStagePlayer::is_loaded);
+    ClassDB::bind_method(D_METHOD("play"), &UsdStagePlayer::play);
+    ClassDB::bind_method(D_METHOD("stop"), &UsdStagePlayer::stop);
+    ClassDB::bind_method(D_METHOD("is_playing"), &UsdStagePlayer::is_playing);
+    ClassDB::bind_method(D_METHOD("seek", "time_code"), &UsdStagePlayer::seek);
+    ClassDB::bind_method(D_METHOD("get_animated_prim_count"), &UsdStagePlayer::get_animated_prim_count);
+    ClassDB::bind_method(D_METHOD("get_start_time_code"), &UsdStagePlayer::get_start_time_code);
+    ClassDB::bind_method(D_METHOD("get_end_time_code"), &UsdStagePlayer::get_end_time_code);
+
+    ClassDB::bind_method(D_METHOD("set_stage_path", "path"), &UsdStagePlayer::set_stage_path);
+    ClassDB::bind_method(D_METHOD("get_stage_path"), &UsdStagePlayer::get_stage_path);
+    ClassDB::bind_method(D_METHOD("set_root_node", "root_node"), &UsdStagePlayer::set_root_node);
+    ClassDB::bind_method(D_METHOD("get_root_node"), &UsdStagePlayer::get_root_node);
+    ClassDB::bind_method(D_METHOD("set_time_code", "time_code"), &UsdStagePlayer::set_time_code);
+    ClassDB::bind_method(D_METHOD("get_time_code"), &UsdStagePlayer::get_time_code);
+    ClassDB::bind_method(D_METHOD("set_frames_per_second", "fps"), &UsdStagePlayer::set_frames_per_second);
+    ClassDB::bind_method(D_METHOD("get_frames_per_second"), &UsdStagePlayer::get_frames_per_second);
+    ClassDB::bind_method(D_METHOD("set_loop", "loop"), &UsdStagePlayer::set_loop);
+    ClassDB::bind_method(D_METHOD("get_loop"), &UsdStagePlayer::get_loop);
+    ClassDB::bind_method(D_METHOD("set_autoplay", "autoplay"), &UsdStagePlayer::set_autoplay);
+    ClassDB::bind_method(D_METHOD("get_autoplay"), &UsdStagePlayer::get_autoplay);
+    ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &UsdStagePlayer::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &UsdStagePlayer::get_thread_count);
+
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "stage_path", PROPERTY_HINT_FILE, "*.usd,*.usda,*.usdc,*.usdz"), "set_stage_path", "get_stage_path");
+    ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_node"), "set_root_node", "get_root_node");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "time_code"), "set_time_code", "get_time_code");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "frames_per_second", PROPERTY_HINT_RANGE, "0,240,0.01,or_greater"), "set_frames_per_second", "get_frames_per_second");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "get_loop");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "autoplay"), "set_autoplay", "get_autoplay");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "thread_count", PROPERTY_HINT_RANGE, "0,256,1"), "set_thread_count", "get_thread_count");
+
+    ADD_SIGNAL(MethodInfo("finished"));
+}
+
+UsdStagePlayer::UsdStagePlayer() {
+    _root_node = NodePath("..");
+    _time_code = 0.0;
+    _frames_per_second = 0.0;
+    _playing = false;
+    _loop = true;
+    _autoplay = false;
+    _thread_count = 1;
+    _stage = nullptr;
+    _start_time_code = 0.0;
+    _end_time_code = 0.0;
+    _stage_frames_per_second = 24.0;
+}
+
+UsdStagePlayer::~UsdStagePlayer() {
+}
+
+void UsdStagePlayer::_ready() {
+    if (_autoplay && !Engine::get_singleton()->is_editor_hint() && load() == OK) {
+        play();
+    }
+}
+
+void UsdStagePlayer::_process(double p_delta) {
+    if (!_playing || !_stage) {
+        return;
+    }
+
+    const double fps = _frames_per_second > 0.0 ? _frames_per_second : _stage_frames_per_second;
+    double time_code = _time_code + p_delta * fps;
+    const double length = _end_time_code - _start_time_code;
+
+    if (time_code > _end_time_code) {
+        if (_loop && length > 0.0) {
+            time_code = _start_time_code + std::fmod(time_code - _start_time_code, length);
+        } else {
+            time_code = _end_time_code;
+            _playing = false;
+            set_process(false);
+            _time_code = time_code;
+            _evaluate();
+            emit_signal("finished");
+            return;
+        }
+    }
+
+    _time_code = time_code;
+    _evaluate();
+}
+
+Error UsdStagePlayer::load() {
+    unload();
+
+    String abs_path = _stage_path;
+    if (_stage_path.begins_with("res://") || _stage_path.begins_with("user://")) {
+        abs_path = ProjectSettings::get_singleton()->globalize_path(_stage_path);
+    }
+
+    _stage = UsdStage::Open(abs_path.utf8().get_data());
+    if (!_stage) {
+        UtilityFunctions::printerr("UsdStagePlayer: Failed to open stage: ", _stage_path);
+        return ERR_CANT_OPEN;
+    }
+
+    Node *root = get_node_or_null(_root_node);
+    if (!root) {
+        UtilityFunctions::printerr("UsdStagePlayer: Root node not found: ", _root_node);
+        _stage = nullptr;
+        return ERR_INVALID_PARAMETER;
+    }
+
+    _start_time_code = _stage->GetStartTimeCode();
+    _end_time_code = _stage->GetEndTimeCode();
+    _stage_frames_per_second = _stage->GetTimeCodesPerSecond();
+
+    // Index once; per-frame work never looks at static prims
+    int64_t unmapped_count = 0;
+    for (const UsdPrim &prim : UsdPrimRange(_stage->GetPseudoRoot())) {
+        if (prim.IsPseudoRoot()) {
+            continue;
+        }
+
+        const UsdGeomXformable xformable(prim);
+        const bool transform_varies = xformable && xformable.TransformMightBeTimeVarying();
+        UsdAttribute visibility = xformable ? xformable.GetVisibilityAttr() : UsdAttribute();
+        const bool visibility_varies = visibility && visibility.ValueMightBeTimeVarying();
+        if (!transform_varies && !visibility_varies) {
+            continue;
+        }
+
+        // Imported nodes mirror prim paths below the import parent
+        Node3D *node = Object::cast_to<Node3D>(root->get_node_or_null(NodePath(String(prim.GetPath().GetText()).substr(1))));
+        if (!node) {
+            unmapped_count++;
+            continue;
+        }
+        if (transform_varies) {
+            _transforms.add(prim, node);
+        }
+        if (visibility_varies) {
+            _visibility.push_back({ visibility, node->get_instance_id() });
+        }
+    }
+
+    UtilityFunctions::print("UsdStagePlayer: Indexed ", _transforms.size(), " animated transforms and ", (int64_t)_visibility.size(),
+            " animated visibilities over time codes ", _start_time_code, "-", _end_time_code,
+            unmapped_count > 0 ? String(" (") + String::num_int64(unmapped_count) + " prims without nodes)" : String());
+
+    _time_code = CLAMP(_time_code, _start_time_code, _end_time_code);
+    _evaluate();
+    return OK;
+}
+
+void UsdStagePlayer::unload() {
+    stop();
+    _transforms.clear();
+    _visibility.clear();
+    _stage = nullptr;
+}
+
+bool UsdStagePlayer::is_loaded() const {
+    return _stage != nullptr;
+}
+
+void UsdStagePlayer::play() {
+    if (!_stage) {
+        UtilityFunctions::printerr("UsdStagePlayer: play() called before load()");
+        return;
+    }
+    _playing = true;
+    set_process(true);
+}
+
+void UsdStagePlayer::stop() {
+    _playing = false;
+    set_process(false);
+}
+
+bool UsdStagePlayer::is_playing() const {
+    return _playing;
+}
+
+void UsdStagePlayer::seek(double p_time_code) {
+    _time_code = p_time_code;
+    if (_stage) {
+        _evaluate();
+    }
+}
+
+void UsdStagePlayer::_evaluate() {
+    const UsdTimeCode time(_time_code);
+    _transforms.update(time, _thread_count);
+
+    for (const AnimatedVisibility &entry : _visibility) {
+        Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(entry.node_id));
+        TfToken visibility;
+        if (node && entry.attribute.Get(&visibility, time)) {
+            node->set_visible(visibility != UsdGeomTokens->invisible);
+        }
+    }
+}
+
+int64_t UsdStagePlayer::get_animated_prim_count() const {
+    return _transforms.size() + (int64_t)_visibility.size();
+}
+
+double UsdStagePlayer::get_start_time_code() const {
+    return _start_time_code;
+}
+
+double UsdStagePlayer::get_end_time_code() const {
+    return _end_time_code;
+}
+
+void UsdStagePlayer::set_stage_path(const String &p_path) {
+    _stage_path = p_path;
+}
+
+String UsdStagePlayer::get_stage_path() const {
+    return _stage_path;
+}
+
+void UsdStagePlayer::set_root_node(const NodePath &p_root_node) {
+    _root_node = p_root_node;
+}
+
+NodePath UsdStagePlayer::get_root_node() const {
+    return _root_node;
+}
+
+void UsdStagePlayer::set_time_code(double p_time_code) {
+    seek(p_time_code);
+}
+
+double UsdStagePlayer::get_time_code() const {
+    return _time_code;
+}
+
+void UsdStagePlayer::set_frames_per_second(double p_fps) {
+    _frames_per_second = p_fps;
+}
+
+double UsdStagePlayer::get_frames_per_second() const {
+    return _frames_per_second;
+}
+
+void UsdStagePlayer::set_loop(bool p_loop) {
+    _loop = p_loop;
+}
+
+bool UsdStagePlayer::get_loop() const {
+    return _loop;
+}
+
+void UsdStagePlayer::set_autoplay(bool p_autoplay) {
+    _autoplay = p_autoplay;
+}
+
+bool UsdStagePlayer::get_autoplay() const {
+    return _autoplay;
+}
+
+void UsdStagePlayer::set_thread_count(int p_count) {
+    _thread_count = p_count;
+}
+
+int UsdStagePlayer::get_thread_count() const {
+    return _thread_count;
+}
+
+} // namespace godot
@@ -5,6 +5,7 @@
 #include <godot_cpp/classes/node3d.hpp>
 #include <godot_cpp/classes/file_access.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/variant/plane.hpp>
 
 // USD headers
 #include <pxr/usd/usd/stage.h>
@@ -54,6 +55,14 @@ void UsdStageProxy::_bind_methods() {
     // Shared State (MCP Interop)
     ClassDB::bind_method(D_METHOD("get_stage_id"), &UsdStageProxy::get_stage_id);
     ClassDB::bind_method(D_METHOD("get_generation"), &UsdStageProxy::get_generation);
+    ClassDB::bind_method(D_METHOD("take_changes"), &UsdStageProxy::take_changes);
+
+    // Spatial Queries
+    ClassDB::bind_method(D_METHOD("get_bounds", "prim_path"), &UsdStageProxy::get_bounds, DEFVAL("/"));
+    ClassDB::bind_method(D_METHOD("raycast", "origin", "direction", "max_distance"), &UsdStageProxy::raycast, DEFVAL(1e30));
+    ClassDB::bind_method(D_METHOD("query_frustum", "planes"), &UsdStageProxy::query_frustum);
+    ClassDB::bind_method(D_METHOD("query_aabb", "box"), &UsdStageProxy::query_aabb);
+    ClassDB::bind_method(D_METHOD("get_bounds_stats"), &UsdStageProxy::get_bounds_stats);
 
     // Time / Animation
     ClassDB::bind_method(D_METHOD("set_time_code", "time"), &UsdStageProxy::set_time_code);
@@ -619,6 +628,148 @@ int64_t UsdStageProxy::get_generation() const {
     return UsdStageManager::get_singleton().get_generation(_stage_id);
 }
 
+Dictionary UsdStageProxy::take_changes() {
+    PackedStringArray resynced;
+    PackedStringArray changed_info;
+
+    StageRecord* record = get_stage_record();
+    usd_godot::StageChanges changes;
+    if (record && record->take_changes(&changes)) {
+        for (const SdfPath& path : changes.resynced) {
+            resynced.push_back(String(path.GetText()));
+        }
+        for (const SdfPath& path : changes.changed_info) {
+            changed_info.push_back(String(path.GetText()));
+        }
+    }
+
+    Dictionary result;
+    result["resynced"] = resynced;
+    result["changed_info"] = changed_info;
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+// Spatial Queries
+// -----------------------------------------------------------------------------
+
+static AABB _ToAABB(const GfRange3d &p_range) {
+    if (p_range.IsEmpty()) {
+        return AABB();
+    }
+    const GfVec3d min = p_range.GetMin();
+    const GfVec3d size = p_range.GetSize();
+    return AABB(Vector3(min[0], min[1], min[2]), Vector3(size[0], size[1], size[2]));
+}
+
+static PackedStringArray _ToPathArray(const SdfPathVector &p_paths) {
+    PackedStringArray result;
+    for (const SdfPath &path : p_paths) {
+        result.push_back(String(path.GetText()));
+    }
+    return result;
+}
+
+UsdBoundsHierarchy* UsdStageProxy::_get_bounds_hierarchy() {
+    // The update reads layers the MCP thread may be editing
+    std::unique_lock<std::recursive_mutex> layers_lock = UsdStageManager::get_singleton().lock_layers();
+    StageRecord* record = get_stage_record();
+    UsdBoundsHierarchy* bounds = record ? record->get_bounds_hierarchy() : nullptr;
+    if (!bounds) {
+        UtilityFunctions::printerr("UsdStageProxy: No stage open");
+        return nullptr;
+    }
+    bounds->set_time(UsdTimeCode(_current_time_code));
+    return bounds;
+}
+
+AABB UsdStageProxy::get_bounds(const String &p_prim_path) {
+    UsdBoundsHierarchy* bounds = _get_bounds_hierarchy();
+    if (!bounds) {
+        return AABB();
+    }
+
+    const std::string path_str = p_prim_path.utf8().get_data();
+    if (!SdfPath::IsValidPathString(path_str)) {
+        UtilityFunctions::printerr("UsdStageProxy: Invalid prim path ", p_prim_path);
+        return AABB();
+    }
+    return _ToAABB(bounds->get_bounds(SdfPath(path_str)));
+}
+
+Dictionary UsdStageProxy::raycast(const Vector3 &p_origin, const Vector3 &p_direction, double p_max_distance) {
+    Dictionary result;
+    UsdBoundsHierarchy* bounds = _get_bounds_hierarchy();
+    if (!bounds) {
+        return result;
+    }
+
+    UsdBoundsHierarchy::RayHit hit;
+    const GfVec3d origin(p_origin.x, p_origin.y, p_origin.z);
+    const GfVec3d direction(p_direction.x, p_direction.y, p_direction.z);
+    if (!bounds->raycast(origin, direction, p_max_distance, &hit)) {
+        return result;
+    }
+
+    result["prim_path"] = String(hit.path.GetText());
+    result["distance"] = hit.distance;
+    result["position"] = p_origin + p_direction.normalized() * hit.distance;
+    return result;
+}
+
+PackedStringArray UsdStageProxy::query_frustum(const Array &p_planes) {
+    UsdBoundsHierarchy* bounds = _get_bounds_hierarchy();
+    if (!bounds) {
+        return PackedStringArray();
+    }
+
+    // Godot planes keep their normals pointing out of the volume, which is
+    // what the hierarchy expects
+    std::vector<UsdBoundsHierarchy::Plane> planes;
+    planes.reserve(p_planes.size());
+    for (int64_t i = 0; i < p_planes.size(); ++i) {
+        if (p_planes[i].get_type() != Variant::PLANE) {
+            UtilityFunctions::printerr("UsdStageProxy: query_frustum expects an Array of Plane");
+            return PackedStringArray();
+        }
+        const Plane plane = p_planes[i];
+        planes.push_back({GfVec3d(plane.normal.x, plane.normal.y, plane.normal.z), plane.d});
+    }
+
+    SdfPathVector paths;
+    bounds->query_frustum(planes, &paths);
+    return _ToPathArray(paths);
+}
+
+PackedStringArray UsdStageProxy::query_aabb(const AABB &p_box) {
+    UsdBoundsHierarchy* bounds = _get_bounds_hierarchy();
+    if (!bounds) {
+        return PackedStringArray();
+    }
+
+    const Vector3 end = p_box.get_end();
+    const GfRange3d box(GfVec3d(p_box.position.x, p_box.position.y, p_box.position.z),
+                        GfVec3d(end.x, end.y, end.z));
+    SdfPathVector paths;
+    bounds->query_box(box, &paths);
+    return _ToPathArray(paths);
+}
+
+Dictionary UsdStageProxy::get_bounds_stats() {
+    Dictionary result;
+    UsdBoundsHierarchy* bounds = _get_bounds_hierarchy();
+    if (!bounds) {
+        return result;
+    }
+
+    const UsdBoundsHierarchy::Stats &stats = bounds->get_stats();
+    result["leaf_count"] = stats.leaf_count;
+    result["node_count"] = stats.node_count;
+    result["rebuild_count"] = stats.rebuild_count;
+    result["refit_count"] = stats.refit_count;
+    return result;
+}
+
 StageRecord* UsdStageProxy::get_stage_record() const {
     if (_stage_id == 0) {
         return nullptr;
@@ -7,6 +7,8 @@
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/packed_string_array.hpp>
+#include <godot_cpp/variant/aabb.hpp>
+#include <godot_cpp/variant/vector3.hpp>
 
 #include "usd_stage_manager.h"
 
@@ -44,6 +46,9 @@ private:
     String _file_path;
     double _current_time_code;
 
+    // The stage's bounds hierarchy, updated and set to the current time code
+    usd_godot::UsdBoundsHierarchy* _get_bounds_hierarchy();
+
 protected:
     static void _bind_methods();
 
@@ -150,6 +155,38 @@ public:
     /// Get the generation number (tracks modifications). Returns 0 if stage is not open.
     int64_t get_generation() const;
 
+    /// Paths changed since the last call, from any editor of this stage
+    /// (GDScript, MCP or a reload). Returns a Dictionary with "resynced" and
+    /// "changed_info" PackedStringArrays; both are empty if nothing changed.
+    Dictionary take_changes();
+
+    // -------------------------------------------------------------------------
+    // Spatial Queries
+    // -------------------------------------------------------------------------
+    // Answered from a bounds hierarchy cached with the stage (shared with
+    // MCP) and evaluated at the current time code. Boxes are world-space
+    // and axis-aligned; the leaves are gprims, point instancers and
+    // unloaded payloads.
+
+    /// World-space bounds of everything at or below a prim. Empty AABB if
+    /// there is no geometry.
+    AABB get_bounds(const String &p_prim_path = "/");
+
+    /// Nearest leaf whose box the ray enters within p_max_distance. Returns
+    /// a Dictionary with "prim_path", "distance" and "position", or an
+    /// empty Dictionary on a miss.
+    Dictionary raycast(const Vector3 &p_origin, const Vector3 &p_direction, double p_max_distance = 1e30);
+
+    /// Leaves inside or crossing a convex volume, e.g. Camera3D.get_frustum().
+    PackedStringArray query_frustum(const Array &p_planes);
+
+    /// Leaves whose boxes intersect p_box.
+    PackedStringArray query_aabb(const AABB &p_box);
+
+    /// Leaf and node counts of the hierarchy, and how often it was rebuilt
+    /// or refitted from change notices.
+    Dictionary get_bounds_stats();
+
     // -------------------------------------------------------------------------
     // Time / Animation
     // -------------------------------------------------------------------------
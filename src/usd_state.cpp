@@ -9,16 +9,71 @@ void UsdState::_bind_methods() {
     
     ClassDB::bind_method(D_METHOD("set_bake_fps", "fps"), &UsdState::set_bake_fps);
     ClassDB::bind_method(D_METHOD("get_bake_fps"), &UsdState::get_bake_fps);
+
+    ClassDB::bind_method(D_METHOD("set_export_animations", "enabled"), &UsdState::set_export_animations);
+    ClassDB::bind_method(D_METHOD("get_export_animations"), &UsdState::get_export_animations);
+
+    ClassDB::bind_method(D_METHOD("set_use_binary_format", "enabled"), &UsdState::set_use_binary_format);
+    ClassDB::bind_method(D_METHOD("get_use_binary_format"), &UsdState::get_use_binary_format);
+
+    ClassDB::bind_method(D_METHOD("set_export_materials", "enabled"), &UsdState::set_export_materials);
+    ClassDB::bind_method(D_METHOD("get_export_materials"), &UsdState::get_export_materials);
+
+    ClassDB::bind_method(D_METHOD("set_export_textures", "enabled"), &UsdState::set_export_textures);
+    ClassDB::bind_method(D_METHOD("get_export_textures"), &UsdState::get_export_textures);
+
+    ClassDB::bind_method(D_METHOD("set_weld_vertices", "weld"), &UsdState::set_weld_vertices);
+    ClassDB::bind_method(D_METHOD("get_weld_vertices"), &UsdState::get_weld_vertices);
+
+    ClassDB::bind_method(D_METHOD("set_parallel_face_threshold", "threshold"), &UsdState::set_parallel_face_threshold);
+    ClassDB::bind_method(D_METHOD("get_parallel_face_threshold"), &UsdState::get_parallel_face_threshold);
+
+    ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &UsdState::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &UsdState::get_thread_count);
+
+    ClassDB::bind_method(D_METHOD("set_deduplicate_meshes", "deduplicate"), &UsdState::set_deduplicate_meshes);
+    ClassDB::bind_method(D_METHOD("get_deduplicate_meshes"), &UsdState::get_deduplicate_meshes);
+
+    ClassDB::bind_method(D_METHOD("set_import_animation", "import"), &UsdState::set_import_animation);
+    ClassDB::bind_method(D_METHOD("get_import_animation"), &UsdState::get_import_animation);
+
+    ClassDB::bind_method(D_METHOD("set_animation_decimation_tolerance", "tolerance"), &UsdState::set_animation_decimation_tolerance);
+    ClassDB::bind_method(D_METHOD("get_animation_decimation_tolerance"), &UsdState::get_animation_decimation_tolerance);
+
+    ClassDB::bind_method(D_METHOD("set_lazy_payloads", "lazy"), &UsdState::set_lazy_payloads);
+    ClassDB::bind_method(D_METHOD("get_lazy_payloads"), &UsdState::get_lazy_payloads);
     
     // Add properties to the inspector
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "copyright", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT), "set_copyright", "get_copyright");
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "bake_fps", PROPERTY_HINT_RANGE, "1,120,0.1"), "set_bake_fps", "get_bake_fps");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "export_animations"), "set_export_animations", "get_export_animations");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_binary_format"), "set_use_binary_format", "get_use_binary_format");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "export_materials"), "set_export_materials", "get_export_materials");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "export_textures"), "set_export_textures", "get_export_textures");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "weld_vertices"), "set_weld_vertices", "get_weld_vertices");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "parallel_face_threshold", PROPERTY_HINT_RANGE, "0,10000000,1,or_greater"), "set_parallel_face_threshold", "get_parallel_face_threshold");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "thread_count", PROPERTY_HINT_RANGE, "0,256,1"), "set_thread_count", "get_thread_count");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deduplicate_meshes"), "set_deduplicate_meshes", "get_deduplicate_meshes");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "import_animation"), "set_import_animation", "get_import_animation");
+    ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "animation_decimation_tolerance", PROPERTY_HINT_RANGE, "0,1,0.0001,or_greater"), "set_animation_decimation_tolerance", "get_animation_decimation_tolerance");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "lazy_payloads"), "set_lazy_payloads", "get_lazy_payloads");
 }
 
 UsdState::UsdState() {
     // Set default values
     _copyright = "";
     _bake_fps = 30.0f;
+    _export_animations = false;
+    _use_binary_format = false;
+    _export_materials = true;
+    _export_textures = true;
+    _weld_vertices = false;
+    _parallel_face_threshold = 100000;
+    _thread_count = 0;
+    _deduplicate_meshes = true;
+    _import_animation = false;
+    _animation_decimation_tolerance = 0.0f;
+    _lazy_payloads = false;
     _stage = nullptr;
 }
 
@@ -38,6 +93,94 @@ float UsdState::get_bake_fps() const {
     return _bake_fps;
 }
 
+void UsdState::set_export_animations(bool p_enabled) {
+    _export_animations = p_enabled;
+}
+
+bool UsdState::get_export_animations() const {
+    return _export_animations;
+}
+
+void UsdState::set_use_binary_format(bool p_enabled) {
+    _use_binary_format = p_enabled;
+}
+
+bool UsdState::get_use_binary_format() const {
+    return _use_binary_format;
+}
+
+void UsdState::set_export_materials(bool p_enabled) {
+    _export_materials = p_enabled;
+}
+
+bool UsdState::get_export_materials() const {
+    return _export_materials;
+}
+
+void UsdState::set_export_textures(bool p_enabled) {
+    _export_textures = p_enabled;
+}
+
+bool UsdState::get_export_textures() const {
+    return _export_textures;
+}
+
+void UsdState::set_weld_vertices(bool p_weld) {
+    _weld_vertices = p_weld;
+}
+
+bool UsdState::get_weld_vertices() const {
+    return _weld_vertices;
+}
+
+void UsdState::set_parallel_face_threshold(int64_t p_threshold) {
+    _parallel_face_threshold = p_threshold;
+}
+
+int64_t UsdState::get_parallel_face_threshold() const {
+    return _parallel_face_threshold;
+}
+
+void UsdState::set_thread_count(int p_count) {
+    _thread_count = p_count;
+}
+
+int UsdState::get_thread_count() const {
+    return _thread_count;
+}
+
+void UsdState::set_deduplicate_meshes(bool p_deduplicate) {
+    _deduplicate_meshes = p_deduplicate;
+}
+
+bool UsdState::get_deduplicate_meshes() const {
+    return _deduplicate_meshes;
+}
+
+void UsdState::set_import_animation(bool p_import) {
+    _import_animation = p_import;
+}
+
+bool UsdState::get_import_animation() const {
+    return _import_animation;
+}
+
+void UsdState::set_animation_decimation_tolerance(float p_tolerance) {
+    _animation_decimation_tolerance = p_tolerance;
+}
+
+float UsdState::get_animation_decimation_tolerance() const {
+    return _animation_decimation_tolerance;
+}
+
+void UsdState::set_lazy_payloads(bool p_lazy) {
+    _lazy_payloads = p_lazy;
+}
+
+bool UsdState::get_lazy_payloads() const {
+    return _lazy_payloads;
+}
+
 void UsdState::set_stage(UsdStageRefPtr p_stage) {
     _stage = p_stage;
 }
@@ -46,4 +189,12 @@ UsdStageRefPtr UsdState::get_stage() const {
     return _stage;
 }
 
+void UsdState::set_texture_files(const std::vector<std::pair<SdfPath, std::string>> &p_files) {
+    _texture_files = p_files;
+}
+
+const std::vector<std::pair<SdfPath, std::string>> &UsdState::get_texture_files() const {
+    return _texture_files;
+}
+
 }
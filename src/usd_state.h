@@ -6,6 +6,11 @@
 
 // USD headers
 #include <pxr/usd/usd/stage.h>
+#include <pxr/usd/sdf/path.h>
+
+#include <string>
+#include <utility>
+#include <vector>
 
 PXR_NAMESPACE_USING_DIRECTIVE
 
@@ -18,9 +23,23 @@ private:
     // Export state
     String _copyright;
     float _bake_fps;
+    bool _export_animations;
+    bool _use_binary_format;
+    bool _export_materials;
+    bool _export_textures;
+
+    // Import options
+    bool _weld_vertices;
+    int64_t _parallel_face_threshold;
+    int _thread_count;
+    bool _deduplicate_meshes;
+    bool _import_animation;
+    float _animation_decimation_tolerance;
+    bool _lazy_payloads;
     
     // USD-specific state
     UsdStageRefPtr _stage;
+    std::vector<std::pair<SdfPath, std::string>> _texture_files;
 
 protected:
     static void _bind_methods();
@@ -34,10 +53,50 @@ public:
     
     void set_bake_fps(float p_fps);
     float get_bake_fps() const;
+
+    void set_export_animations(bool p_enabled);
+    bool get_export_animations() const;
+
+    void set_use_binary_format(bool p_enabled);
+    bool get_use_binary_format() const;
+
+    void set_export_materials(bool p_enabled);
+    bool get_export_materials() const;
+
+    void set_export_textures(bool p_enabled);
+    bool get_export_textures() const;
+
+    void set_weld_vertices(bool p_weld);
+    bool get_weld_vertices() const;
+
+    void set_parallel_face_threshold(int64_t p_threshold);
+    int64_t get_parallel_face_threshold() const;
+
+    void set_thread_count(int p_count);
+    int get_thread_count() const;
+
+    void set_deduplicate_meshes(bool p_deduplicate);
+    bool get_deduplicate_meshes() const;
+
+    void set_import_animation(bool p_import);
+    bool get_import_animation() const;
+
+    void set_animation_decimation_tolerance(float p_tolerance);
+    float get_animation_decimation_tolerance() const;
+
+    // Open with UsdStage::LoadNone and import payload prims as
+    // placeholders; see UsdPayloadLoader
+    void set_lazy_payloads(bool p_lazy);
+    bool get_lazy_payloads() const;
     
     // Stage management
     void set_stage(UsdStageRefPtr p_stage);
     UsdStageRefPtr get_stage() const;
+
+    // Texture asset attributes of the exported stage and the absolute
+    // files they point at, made relative when the stage is written
+    void set_texture_files(const std::vector<std::pair<SdfPath, std::string>> &p_files);
+    const std::vector<std::pair<SdfPath, std::string>> &get_texture_files() const;
 };
 
 }
@@ -0,0 +1,255 @@
+#include "usd_texture_loader.h"
+#include "usd_parallel.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+
+// USD headers
+#include <pxr/usd/ar/asset.h>
+#include <pxr/usd/ar/resolvedPath.h>
+#include <pxr/usd/ar/resolver.h>
+#include <pxr/base/tf/stringUtils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace godot {
+
+static int64_t _ElapsedUsec(const std::chrono::steady_clock::time_point &p_start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - p_start).count();
+}
+
+UsdTextureLoader::~UsdTextureLoader() {
+    finish();
+}
+
+void UsdTextureLoader::start(int p_thread_count, int p_max_ready_images) {
+    if (!_workers.empty()) {
+        return;
+    }
+    _thread_count = UsdParallel::resolve_thread_count(p_thread_count);
+    _max_ready = (size_t)std::max(p_max_ready_images, 1);
+    _stopping = false;
+    for (int i = 0; i < _thread_count; ++i) {
+        _workers.emplace_back(&UsdTextureLoader::_worker, this);
+    }
+}
+
+Ref<Texture2D> UsdTextureLoader::request(const SdfAssetPath &p_asset) {
+    // Attribute values come back already resolved against their layer;
+    // otherwise ask the resolver directly (search paths, absolute paths)
+    std::string resolved_path = p_asset.GetResolvedPath();
+    if (resolved_path.empty() && !p_asset.GetAssetPath().empty()) {
+        resolved_path = ArGetResolver().Resolve(p_asset.GetAssetPath());
+    }
+    if (resolved_path.empty()) {
+        UtilityFunctions::printerr("USD Import: Could not resolve texture ", String::utf8(p_asset.GetAssetPath().c_str()));
+        return Ref<Texture2D>();
+    }
+
+    auto found = _entry_indices.find(resolved_path);
+    if (found != _entry_indices.end()) {
+        return _entries[found->second].texture;
+    }
+
+    const size_t index = _entries.size();
+    _entry_indices.emplace(resolved_path, index);
+    _entries.push_back(Entry());
+    Entry &entry = _entries.back();
+
+    if (_workers.empty()) {
+        // Synchronous: decode here
+        UsdTextureStats stats;
+        Ref<Image> image = _decode(resolved_path, &stats);
+        if (image.is_valid()) {
+            entry.texture = ImageTexture::create_from_image(image);
+        } else {
+            UtilityFunctions::printerr("USD Import: Failed to load texture ", String::utf8(resolved_path.c_str()));
+        }
+        _stats.push_back(stats);
+        return entry.texture;
+    }
+
+    if (_placeholder_image.is_null()) {
+        _placeholder_image = Image::create(1, 1, false, Image::FORMAT_RGBA8);
+        _placeholder_image->fill(Color(1, 1, 1, 1));
+    }
+    entry.texture = ImageTexture::create_from_image(_placeholder_image);
+    _outstanding++;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(Job{ index, resolved_path });
+    }
+    _job_available.notify_one();
+
+    // Swap in whatever finished meanwhile, keeping the ready queue short
+    poll();
+    return entry.texture;
+}
+
+void UsdTextureLoader::poll() {
+    std::deque<Result> ready;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ready.swap(_ready);
+    }
+    _ready_space.notify_all();
+    for (Result &result : ready) {
+        _apply(result);
+    }
+}
+
+void UsdTextureLoader::finish() {
+    if (_workers.empty()) {
+        return;
+    }
+
+    while (_outstanding > 0) {
+        std::deque<Result> ready;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _result_available.wait(lock, [this]() { return !_ready.empty(); });
+            ready.swap(_ready);
+        }
+        _ready_space.notify_all();
+        for (Result &result : ready) {
+            _apply(result);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _job_available.notify_all();
+    _ready_space.notify_all();
+    for (std::thread &worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+    _stopping = false;
+}
+
+int64_t UsdTextureLoader::get_decoded_bytes() const {
+    int64_t total = 0;
+    for (const UsdTextureStats &stats : _stats) {
+        total += stats.decoded_bytes;
+    }
+    return total;
+}
+
+void UsdTextureLoader::print_summary() const {
+    if (_stats.empty()) {
+        return;
+    }
+
+    int64_t encoded_bytes = 0;
+    int64_t decode_usec = 0;
+    int64_t failed = 0;
+    for (const UsdTextureStats &stats : _stats) {
+        const String path = String::utf8(stats.resolved_path.c_str());
+        if (stats.failed) {
+            UtilityFunctions::print("USD Import: Texture ", path, ": failed after ", String::num(stats.decode_usec / 1000.0, 2), " ms");
+        } else {
+            UtilityFunctions::print("USD Import: Texture ", path, ": ", stats.width, "x", stats.height, ", ",
+                    String::num(stats.encoded_bytes / 1024.0, 1), " KiB -> ", String::num(stats.decoded_bytes / 1024.0, 1),
+                    " KiB, ", String::num(stats.decode_usec / 1000.0, 2), " ms");
+        }
+        encoded_bytes += stats.encoded_bytes;
+        decode_usec += stats.decode_usec;
+        failed += stats.failed ? 1 : 0;
+    }
+
+    UtilityFunctions::print("USD Import: ", (int64_t)_stats.size(), " textures (", failed, " failed) on ",
+            _thread_count > 0 ? _thread_count : 1, " decode thread(s): ", String::num(encoded_bytes / (1024.0 * 1024.0), 2),
+            " MiB read, ", String::num(get_decoded_bytes() / (1024.0 * 1024.0), 2), " MiB decoded, ",
+            String::num(decode_usec / 1000.0, 1), " ms of decode time");
+}
+
+Ref<Image> UsdTextureLoader::_decode(const std::string &p_resolved_path, UsdTextureStats *r_stats) {
+    const auto start = std::chrono::steady_clock::now();
+    r_stats->resolved_path = p_resolved_path;
+
+    ArResolver &resolver = ArGetResolver();
+    std::shared_ptr<ArAsset> asset = resolver.OpenAsset(ArResolvedPath(p_resolved_path));
+    std::shared_ptr<const char> buffer = asset ? asset->GetBuffer() : nullptr;
+
+    Ref<Image> image;
+    if (buffer) {
+        PackedByteArray bytes;
+        bytes.resize(asset->GetSize());
+        memcpy(bytes.ptrw(), buffer.get(), bytes.size());
+        r_stats->encoded_bytes = bytes.size();
+
+        // Package-relative paths ("a.usdz[b.png]") need the resolver's
+        // idea of the extension
+        const std::string extension = TfStringToLower(resolver.GetExtension(p_resolved_path));
+        image.instantiate();
+        Error err = ERR_FILE_UNRECOGNIZED;
+        if (extension == "png") {
+            err = image->load_png_from_buffer(bytes);
+        } else if (extension == "jpg" || extension == "jpeg") {
+            err = image->load_jpg_from_buffer(bytes);
+        } else if (extension == "webp") {
+            err = image->load_webp_from_buffer(bytes);
+        } else if (extension == "tga") {
+            err = image->load_tga_from_buffer(bytes);
+        } else if (extension == "bmp") {
+            err = image->load_bmp_from_buffer(bytes);
+        } else if (extension == "ktx") {
+            err = image->load_ktx_from_buffer(bytes);
+        }
+
+        if (err == OK && !image->is_empty()) {
+            image->generate_mipmaps();
+            r_stats->width = image->get_width();
+            r_stats->height = image->get_height();
+            r_stats->decoded_bytes = image->get_data().size();
+        } else {
+            image.unref();
+        }
+    }
+
+    r_stats->failed = image.is_null();
+    r_stats->decode_usec = _ElapsedUsec(start);
+    return image;
+}
+
+void UsdTextureLoader::_worker() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _job_available.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+            if (_jobs.empty()) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        Result result;
+        result.entry = job.entry;
+        result.image = _decode(job.resolved_path, &result.stats);
+
+        // Hold on to the image until the main thread has room for it
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _ready_space.wait(lock, [this]() { return _stopping || _ready.size() < _max_ready; });
+            _ready.push_back(std::move(result));
+        }
+        _result_available.notify_one();
+    }
+}
+
+void UsdTextureLoader::_apply(Result &p_result) {
+    Entry &entry = _entries[p_result.entry];
+    if (p_result.image.is_valid()) {
+        entry.texture->set_image(p_result.image);
+    } else {
+        UtilityFunctions::printerr("USD Import: Failed to load texture ", String::utf8(p_result.stats.resolved_path.c_str()));
+    }
+    _stats.push_back(p_result.stats);
+    _outstanding--;
+}
+
+} // namespace godot
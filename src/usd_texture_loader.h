@@ -0,0 +1,115 @@
+#ifndef USD_TEXTURE_LOADER_H
+#define USD_TEXTURE_LOADER_H
+
+#include <godot_cpp/classes/image.hpp>
+#include <godot_cpp/classes/image_texture.hpp>
+
+// USD headers
+#include <pxr/usd/sdf/assetPath.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// Decode statistics for one texture file
+struct UsdTextureStats {
+    std::string resolved_path;
+    int width = 0;
+    int height = 0;
+    int64_t encoded_bytes = 0;
+    int64_t decoded_bytes = 0; // including mipmaps
+    int64_t decode_usec = 0;
+    bool failed = false;
+};
+
+// Loads the image files behind UsdUVTexture inputs.
+//
+// Asset paths are resolved and read through ArResolver, so package
+// (.usdz) and custom resolver paths work. Each resolved path is decoded
+// once. After start(), decoding runs on worker threads: request() hands
+// out a 1x1 placeholder ImageTexture right away and the decoded image is
+// swapped into that same resource by poll() or finish(), so materials
+// built in the meantime pick it up. Decoded images waiting for the swap
+// are capped, which bounds memory when decoding outpaces the main thread.
+//
+// request(), poll() and finish() belong to the main thread.
+class UsdTextureLoader {
+public:
+    UsdTextureLoader() = default;
+    ~UsdTextureLoader();
+
+    UsdTextureLoader(const UsdTextureLoader &) = delete;
+    UsdTextureLoader &operator=(const UsdTextureLoader &) = delete;
+
+    // Start p_thread_count decode workers (zero means one per core).
+    // Without start(), request() decodes on the calling thread.
+    void start(int p_thread_count, int p_max_ready_images = 16);
+
+    // Texture for p_asset, shared by every request resolving to the same
+    // file. Null when the path does not resolve or, without workers, when
+    // the file cannot be decoded.
+    Ref<Texture2D> request(const SdfAssetPath &p_asset);
+
+    // Swap in every decode completed so far
+    void poll();
+
+    // Wait for outstanding decodes, swap them in and stop the workers
+    void finish();
+
+    int64_t get_texture_count() const { return (int64_t)_entries.size(); }
+    int64_t get_decoded_bytes() const;
+    const std::vector<UsdTextureStats> &get_stats() const { return _stats; }
+
+    // Per-texture decode time and size, then totals, to the import log
+    void print_summary() const;
+
+private:
+    struct Job {
+        size_t entry = 0;
+        std::string resolved_path;
+    };
+
+    struct Result {
+        size_t entry = 0;
+        Ref<Image> image;
+        UsdTextureStats stats;
+    };
+
+    struct Entry {
+        Ref<ImageTexture> texture;
+    };
+
+    static Ref<Image> _decode(const std::string &p_resolved_path, UsdTextureStats *r_stats);
+    void _worker();
+    void _apply(Result &p_result);
+
+    std::unordered_map<std::string, size_t> _entry_indices; // by resolved path
+    std::vector<Entry> _entries;
+    std::vector<UsdTextureStats> _stats;
+    Ref<Image> _placeholder_image;
+    int64_t _outstanding = 0;
+    int _thread_count = 0;
+
+    // Shared with the workers
+    std::mutex _mutex;
+    std::condition_variable _job_available;
+    std::condition_variable _result_available;
+    std::condition_variable _ready_space;
+    std::deque<Job> _jobs;
+    std::deque<Result> _ready;
+    size_t _max_ready = 16;
+    bool _stopping = false;
+    std::vector<std::thread> _workers;
+};
+
+} // namespace godot
+
+#endif // USD_TEXTURE_LOADER_H
@@ -0,0 +1,82 @@
+#include "usd_transform_batch.h"
+#include "usd_parallel.h"
+#include <godot_cpp/core/object.hpp>
+
+#include <algorithm>
+
+namespace godot {
+
+UsdTransformBatch::UsdTransformBatch() {
+}
+
+UsdTransformBatch::~UsdTransformBatch() {
+}
+
+Transform3D UsdTransformBatch::to_transform(const GfMatrix4d &p_matrix) {
+    Basis basis;
+    basis.set_column(0, Vector3(p_matrix[0][0], p_matrix[0][1], p_matrix[0][2]));
+    basis.set_column(1, Vector3(p_matrix[1][0], p_matrix[1][1], p_matrix[1][2]));
+    basis.set_column(2, Vector3(p_matrix[2][0], p_matrix[2][1], p_matrix[2][2]));
+    return Transform3D(basis, Vector3(p_matrix[3][0], p_matrix[3][1], p_matrix[3][2]));
+}
+
+void UsdTransformBatch::clear() {
+    _prims.clear();
+    _node_ids.clear();
+    _transforms.clear();
+    _caches.clear();
+}
+
+void UsdTransformBatch::reserve(int64_t p_count) {
+    _prims.reserve(p_count);
+    _node_ids.reserve(p_count);
+}
+
+void UsdTransformBatch::add(const UsdPrim &p_prim, Node3D *p_node) {
+    _prims.push_back(p_prim);
+    _node_ids.push_back(p_node->get_instance_id());
+}
+
+void UsdTransformBatch::compute(UsdTimeCode p_time, int p_thread_count) {
+    const int64_t count = size();
+    _transforms.resize(count);
+    if (count == 0) {
+        return;
+    }
+
+    // Slices are fixed for a given batch size and thread count so each
+    // cache keeps seeing the same prims
+    const int thread_count = count < _parallel_threshold ? 1 : UsdParallel::resolve_thread_count(p_thread_count);
+    const int64_t slice_count = std::min<int64_t>(count, thread_count == 1 ? 1 : (int64_t)thread_count * 4);
+    if ((int64_t)_caches.size() != slice_count) {
+        _caches.clear();
+        for (int64_t i = 0; i < slice_count; ++i) {
+            _caches.push_back(std::make_unique<UsdGeomXformCache>(p_time));
+        }
+    }
+
+    const int64_t slice_size = (count + slice_count - 1) / slice_count;
+    UsdParallel::for_range(slice_count, thread_count, [&](int64_t p_begin, int64_t p_end) {
+        for (int64_t slice = p_begin; slice < p_end; ++slice) {
+            UsdGeomXformCache &cache = *_caches[slice];
+            cache.SetTime(p_time);
+            const int64_t end = std::min(count, (slice + 1) * slice_size);
+            for (int64_t i = slice * slice_size; i < end; ++i) {
+                bool resets_xform_stack = false;
+                _transforms[i] = to_transform(cache.GetLocalTransformation(_prims[i], &resets_xform_stack));
+            }
+        }
+    });
+}
+
+void UsdTransformBatch::apply() const {
+    const int64_t count = std::min<int64_t>(size(), (int64_t)_transforms.size());
+    for (int64_t i = 0; i < count; ++i) {
+        Node3D *node = Object::cast_to<Node3D>(ObjectDB::get_instance(_node_ids[i]));
+        if (node) {
+            node->set_transform(_transforms[i]);
+        }
+    }
+}
+
+} // namespace godot
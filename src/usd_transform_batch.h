@@ -0,0 +1,75 @@
+#ifndef USD_TRANSFORM_BATCH_H
+#define USD_TRANSFORM_BATCH_H
+
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+// USD headers
+#include <pxr/usd/usd/prim.h>
+#include <pxr/usd/usd/timeCode.h>
+#include <pxr/usd/usdGeom/xformCache.h>
+#include <pxr/base/gf/matrix4d.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace godot {
+
+// Updates the local transforms of many nodes from their prims in two
+// passes: compute() evaluates every prim's local matrix, on worker threads
+// for large batches, and apply() writes the results to the nodes in one
+// main-thread sweep.
+//
+// Each slice of the batch keeps its own UsdGeomXformCache across calls, so
+// xformOp queries are built once and later updates only re-evaluate values.
+// Keep a batch alive and call update() every frame for playback.
+class UsdTransformBatch {
+public:
+    UsdTransformBatch();
+    ~UsdTransformBatch();
+
+    void clear();
+    void reserve(int64_t p_count);
+
+    // Node IDs are checked on apply(), so nodes freed in the meantime are
+    // skipped rather than dereferenced
+    void add(const UsdPrim &p_prim, Node3D *p_node);
+    int64_t size() const { return (int64_t)_prims.size(); }
+
+    // Batches smaller than this are evaluated on the calling thread
+    void set_parallel_threshold(int64_t p_threshold) { _parallel_threshold = p_threshold; }
+
+    // Evaluate local transforms at p_time. Thread count zero means one per
+    // core. Touches no Godot objects.
+    void compute(UsdTimeCode p_time, int p_thread_count = 0);
+
+    // Write computed transforms to the nodes. Main thread only.
+    void apply() const;
+
+    void update(UsdTimeCode p_time, int p_thread_count = 0) {
+        compute(p_time, p_thread_count);
+        apply();
+    }
+
+    const Transform3D &get_transform(int64_t p_index) const { return _transforms[p_index]; }
+
+    // USD matrices are row-vector: row i is basis column i, row 3 the origin
+    static Transform3D to_transform(const GfMatrix4d &p_matrix);
+
+private:
+    std::vector<UsdPrim> _prims;
+    std::vector<uint64_t> _node_ids;
+    std::vector<Transform3D> _transforms;
+
+    // One cache per slice of the batch; a slice is only ever evaluated by
+    // one thread at a time
+    std::vector<std::unique_ptr<UsdGeomXformCache>> _caches;
+    int64_t _parallel_threshold = 1024;
+};
+
+} // namespace godot
+
+#endif // USD_TRANSFORM_BATCH_H
@@ -0,0 +1,67 @@
+extends GutTest
+## Animation export benchmark. Not part of the default test run; use
+## ./run_tests.sh --bench. Exports a 10-minute animation driving 500 nodes
+## at 30 fps (18001 frames, 2 animated ops per node).
+
+const BENCH_DIR = "user://bench/"
+const NODE_COUNT = 500
+const LENGTH_SECONDS = 600.0
+const BAKE_FPS = 30.0
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _make_scene() -> Node3D:
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var animation = Animation.new()
+	animation.length = LENGTH_SECONDS
+
+	for i in NODE_COUNT:
+		var node = Node3D.new()
+		node.name = "Joint_%d" % i
+		scene.add_child(node)
+
+		# One key per second on position and rotation
+		var position_track = animation.add_track(Animation.TYPE_POSITION_3D)
+		animation.track_set_path(position_track, NodePath(node.name))
+		var rotation_track = animation.add_track(Animation.TYPE_ROTATION_3D)
+		animation.track_set_path(rotation_track, NodePath(node.name))
+		for second in int(LENGTH_SECONDS) + 1:
+			animation.position_track_insert_key(position_track, second, Vector3(i, sin(second * 0.1), 0))
+			animation.rotation_track_insert_key(rotation_track, second, Quaternion(Vector3.UP, second * 0.05))
+
+	var library = AnimationLibrary.new()
+	library.add_animation("take", animation)
+	var player = AnimationPlayer.new()
+	player.name = "AnimationPlayer"
+	player.add_animation_library("", library)
+	scene.add_child(player)
+	return scene
+
+
+func test_bench_export_10_minute_500_node_animation():
+	var scene = _make_scene()
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.export_animations = true
+	state.bake_fps = BAKE_FPS
+
+	var start = Time.get_ticks_usec()
+	var err = doc.append_from_scene(scene, state)
+	var sample_usec = Time.get_ticks_usec() - start
+	assert_eq(err, OK, "Export should succeed")
+
+	start = Time.get_ticks_usec()
+	err = doc.write_to_filesystem(state, ProjectSettings.globalize_path(BENCH_DIR + "animation_500.usdc"))
+	var write_usec = Time.get_ticks_usec() - start
+	assert_eq(err, OK, "Write should succeed")
+
+	var samples = NODE_COUNT * 2 * (int(LENGTH_SECONDS * BAKE_FPS) + 1)
+	gut.p("append_from_scene: %d time samples in %.3f s (%.0f samples/s)" % [samples, sample_usec / 1000000.0,
+			samples / max(sample_usec / 1000000.0, 0.000001)])
+	gut.p("write_to_filesystem (usdc): %.3f s" % (write_usec / 1000000.0))
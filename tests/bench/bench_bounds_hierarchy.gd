@@ -0,0 +1,85 @@
+extends GutTest
+## Spatial queries on UsdStageProxy's cached bounds hierarchy: the one-off
+## build, ray and box queries against it, and the cost of bringing it up to
+## date after a single edit.
+
+const BENCH_DIR = "user://bench/"
+const GRID = 50 # GRID * GRID cubes, 4 units apart
+const ITERATIONS = 1000
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _create_grid_stage(p_path: String) -> UsdStageProxy:
+	var stage = UsdStageProxy.new()
+	stage.create_new(p_path)
+	stage.define_prim("/World", "Xform")
+	for x in GRID:
+		for z in GRID:
+			var prim_path = "/World/Cube_%d_%d" % [x, z]
+			stage.define_prim(prim_path, "Cube")
+			stage.set_prim_transform(prim_path, x * 4, 0, z * 4, 0, 45, 0, 1, 1, 1)
+	return stage
+
+
+func _report(p_label: String, p_samples: PackedInt64Array):
+	p_samples.sort()
+	var count = p_samples.size()
+	gut.p("%s: median %d us, p99 %d us, max %d us over %d queries" % [
+			p_label, p_samples[count / 2], p_samples[count * 99 / 100], p_samples[count - 1], count])
+
+
+func test_bench_build_and_query():
+	var stage = _create_grid_stage(BENCH_DIR + "bounds_grid.usda")
+
+	var start = Time.get_ticks_usec()
+	var bounds = stage.get_bounds()
+	var build_usec = Time.get_ticks_usec() - start
+	var stats = stage.get_bounds_stats()
+	assert_eq(stats.leaf_count, GRID * GRID, "Every cube should be a leaf")
+	gut.p("Built hierarchy over %d leaves (%d nodes) in %.3f ms" % [stats.leaf_count, stats.node_count, build_usec / 1000.0])
+
+	var rng = RandomNumberGenerator.new()
+	rng.seed = 1
+
+	var samples = PackedInt64Array()
+	samples.resize(ITERATIONS)
+	var hits = 0
+	for i in ITERATIONS:
+		var origin = Vector3(rng.randf_range(0, GRID * 4), 20, rng.randf_range(0, GRID * 4))
+		start = Time.get_ticks_usec()
+		var hit = stage.raycast(origin, Vector3(0, -1, 0))
+		samples[i] = Time.get_ticks_usec() - start
+		if not hit.is_empty():
+			hits += 1
+	assert_gt(hits, 0, "Downward rays over the grid should hit cubes")
+	_report("raycast", samples)
+
+	for i in ITERATIONS:
+		var corner = Vector3(rng.randf_range(0, GRID * 4), -1, rng.randf_range(0, GRID * 4))
+		start = Time.get_ticks_usec()
+		stage.query_aabb(AABB(corner, Vector3(10, 2, 10)))
+		samples[i] = Time.get_ticks_usec() - start
+	_report("query_aabb (10x10 area)", samples)
+
+	assert_true(bounds.has_volume(), "Grid should have bounds")
+
+
+func test_bench_update_after_edit():
+	var stage = _create_grid_stage(BENCH_DIR + "bounds_grid_edit.usda")
+	stage.get_bounds()
+	var before = stage.get_bounds_stats()
+
+	var samples = PackedInt64Array()
+	samples.resize(ITERATIONS)
+	for i in ITERATIONS:
+		stage.set_prim_transform("/World/Cube_0_0", i, 0, 0, 0, 0, 0, 1, 1, 1)
+		var start = Time.get_ticks_usec()
+		stage.get_bounds("/World/Cube_0_0")
+		samples[i] = Time.get_ticks_usec() - start
+
+	var after = stage.get_bounds_stats()
+	assert_eq(after.rebuild_count, before.rebuild_count, "Transform edits should refit, not rebuild")
+	_report("update after one transform edit", samples)
@@ -0,0 +1,74 @@
+extends GutTest
+## Live edit latency: time from an edit on a UsdStageProxy to the reflected
+## node showing it. Runs UsdGroupReflector.sync(), the same call the editor
+## plugin makes each frame for reflected scene groups, so the change
+## listener, the incremental sync and UsdTransformBatch are all measured.
+
+const BENCH_DIR = "user://bench/"
+const ITERATIONS = 1000
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _reflect(p_name: String) -> Dictionary:
+	var path = BENCH_DIR + p_name + ".usda"
+	DirAccess.copy_absolute("res://tests/fixtures/hierarchy.usda", path)
+
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var reflector = UsdGroupReflector.new()
+	var root = reflector.reflect(path, parent, p_name)
+	assert_not_null(root, "Reflect should succeed")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should open stage")
+	return {"reflector": reflector, "root": root, "stage": stage}
+
+
+func _report(p_label: String, p_samples: PackedInt64Array):
+	p_samples.sort()
+	var count = p_samples.size()
+	gut.p("%s: median %d us, p99 %d us, max %d us over %d edits" % [
+			p_label, p_samples[count / 2], p_samples[count * 99 / 100], p_samples[count - 1], count])
+
+
+func test_bench_set_transform_to_node_update():
+	var ctx = _reflect("live_sync")
+	var node = ctx.root.get_node("Root/Parent")
+
+	var samples = PackedInt64Array()
+	samples.resize(ITERATIONS)
+	var sync_samples = PackedInt64Array()
+	sync_samples.resize(ITERATIONS)
+	for i in ITERATIONS:
+		var start = Time.get_ticks_usec()
+		ctx.stage.set_prim_transform("/Root/Parent", i, 0, 0, 0, 0, 0, 1, 1, 1)
+		if not ctx.reflector.sync():
+			fail_test("Transform edits should sync incrementally")
+			return
+		samples[i] = Time.get_ticks_usec() - start
+		sync_samples[i] = ctx.reflector.get_sync_stats().sync_usec
+
+	assert_eq(node.position, Vector3(ITERATIONS - 1, 0, 0), "Node should show the last edit")
+	assert_eq(ctx.root.get_node("Root/Parent"), node, "Node should be updated in place")
+	_report("set_prim_transform -> node update", samples)
+	_report("UsdGroupReflector.sync alone", sync_samples)
+
+
+func test_bench_coalesced_edits_per_frame():
+	var ctx = _reflect("live_sync_batch")
+
+	# Many edits between two frames collapse into one sync
+	var start = Time.get_ticks_usec()
+	for i in ITERATIONS:
+		ctx.stage.set_prim_transform("/Root/Parent", i, 0, 0, 0, 0, 0, 1, 1, 1)
+	var edit_usec = Time.get_ticks_usec() - start
+	assert_true(ctx.reflector.sync(), "Batch should sync incrementally")
+
+	var stats = ctx.reflector.get_sync_stats()
+	assert_lt(stats.change_count, 10, "Edits should coalesce by path")
+	assert_eq(ctx.root.get_node("Root/Parent").position, Vector3(ITERATIONS - 1, 0, 0), "Node should show the last edit")
+	gut.p("%d edits in %.3f ms coalesced into %d changed paths, synced in %d us" % [ITERATIONS, edit_usec / 1000.0,
+			stats.change_count, stats.sync_usec])
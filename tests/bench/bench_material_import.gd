@@ -0,0 +1,112 @@
+extends GutTest
+## Material import benchmarks. Not part of the default test run; use
+## ./run_tests.sh --bench.
+
+const BENCH_DIR = "user://bench/"
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _write_bound_cubes(p_path: String, p_cube_count: int, p_material_count: int) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"World\"\n)\n\n")
+	file.store_string("def Xform \"World\"\n{\n    def Scope \"Materials\"\n    {\n")
+	for m in p_material_count:
+		file.store_string("        def Material \"Material_%d\"\n        {\n" % m)
+		file.store_string("            token outputs:surface.connect = </World/Materials/Material_%d/Surface.outputs:surface>\n" % m)
+		file.store_string("            def Shader \"Surface\"\n            {\n")
+		file.store_string("                uniform token info:id = \"UsdPreviewSurface\"\n")
+		file.store_string("                color3f inputs:diffuseColor = (%f, 0.5, 0.5)\n" % (float(m) / p_material_count))
+		file.store_string("                float inputs:roughness = 0.4\n                token outputs:surface\n            }\n        }\n")
+	file.store_string("    }\n")
+	for i in p_cube_count:
+		file.store_string("    def Cube \"Cube_%d\" (\n        prepend apiSchemas = [\"MaterialBindingAPI\"]\n    )\n    {\n" % i)
+		file.store_string("        rel material:binding = </World/Materials/Material_%d>\n" % (i % p_material_count))
+		file.store_string("        double3 xformOp:translate = (%d, 0, %d)\n" % [i % 100, i / 100])
+		file.store_string("        uniform token[] xformOpOrder = [\"xformOp:translate\"]\n    }\n")
+	file.store_string("}\n")
+	file.close()
+	return OK
+
+
+func test_bench_import_10k_prims_20_materials():
+	var cube_count = 10000
+	var material_count = 20
+	var path = BENCH_DIR + "bound_cubes_10k.usda"
+	assert_eq(_write_bound_cubes(path, cube_count, material_count), OK, "Should write benchmark stage")
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var start = Time.get_ticks_usec()
+	var err = doc.import_from_file(path, parent, state)
+	var seconds = max(Time.get_ticks_usec() - start, 1) / 1000000.0
+	assert_eq(err, OK, "Import should succeed")
+
+	var materials = {}
+	for node in parent.find_children("Cube_*", "MeshInstance3D", true, false):
+		var material = node.get_surface_override_material(0)
+		if material != null:
+			materials[material.get_instance_id()] = true
+	assert_eq(materials.size(), material_count, "Each USD material should become one Godot material")
+	gut.p("import_from_file %d cubes bound to %d materials: %.3f s, %d distinct materials" % [cube_count, material_count,
+			seconds, materials.size()])
+
+
+func _write_textured_materials(p_path: String, p_texture_count: int, p_size: int) -> Error:
+	# Noise compresses poorly, so decoding costs about what it does for
+	# real photographic textures
+	var dir = p_path.get_base_dir()
+	var noise = FastNoiseLite.new()
+	noise.frequency = 0.2
+	for t in p_texture_count:
+		noise.seed = t
+		var image = noise.get_image(p_size, p_size)
+		var err = image.save_png(dir.path_join("texture_%d.png" % t))
+		if err != OK:
+			return err
+
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"World\"\n)\n\ndef Xform \"World\"\n{\n")
+	for t in p_texture_count:
+		file.store_string("    def Material \"Material_%d\"\n    {\n" % t)
+		file.store_string("        token outputs:surface.connect = </World/Material_%d/Surface.outputs:surface>\n" % t)
+		file.store_string("        def Shader \"Surface\"\n        {\n")
+		file.store_string("            uniform token info:id = \"UsdPreviewSurface\"\n")
+		file.store_string("            color3f inputs:diffuseColor.connect = </World/Material_%d/Texture.outputs:rgb>\n" % t)
+		file.store_string("            token outputs:surface\n        }\n")
+		file.store_string("        def Shader \"Texture\"\n        {\n")
+		file.store_string("            uniform token info:id = \"UsdUVTexture\"\n")
+		file.store_string("            asset inputs:file = @./texture_%d.png@\n            float3 outputs:rgb\n        }\n    }\n" % t)
+		file.store_string("    def Cube \"Cube_%d\" (\n        prepend apiSchemas = [\"MaterialBindingAPI\"]\n    )\n    {\n" % t)
+		file.store_string("        rel material:binding = </World/Material_%d>\n    }\n" % t)
+	file.store_string("}\n")
+	file.close()
+	return OK
+
+
+func test_bench_import_texture_decode_thread_scaling():
+	var texture_count = 32
+	var path = BENCH_DIR + "textured_materials.usda"
+	assert_eq(_write_textured_materials(path, texture_count, 1024), OK, "Should write benchmark stage")
+
+	for threads in [1, 2, 4, 0]:
+		var doc = UsdDocument.new()
+		var state = UsdState.new()
+		state.thread_count = threads
+		var parent = Node3D.new()
+		add_child_autofree(parent)
+		var start = Time.get_ticks_usec()
+		var err = doc.import_from_file(path, parent, state)
+		var seconds = max(Time.get_ticks_usec() - start, 1) / 1000000.0
+		assert_eq(err, OK, "Import should succeed")
+		gut.p("import_from_file %d 1024x1024 textures, %s: %.3f s" % [texture_count,
+				"all threads" if threads == 0 else "%d thread(s)" % threads, seconds])
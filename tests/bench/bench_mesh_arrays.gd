@@ -0,0 +1,84 @@
+extends GutTest
+## Micro-benchmarks for the PackedArray <-> VtArray conversion layer
+## (UsdArrayUtils), exercised through the public export and attribute APIs.
+## Run with ./run_tests.sh --bench and compare elements/second across builds.
+
+const BENCH_DIR = "user://bench/"
+const VERTEX_COUNT = 3000000
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _make_mesh_instance(p_vertex_count: int) -> MeshInstance3D:
+	var vertices = PackedVector3Array()
+	var normals = PackedVector3Array()
+	var uvs = PackedVector2Array()
+	var indices = PackedInt32Array()
+	vertices.resize(p_vertex_count)
+	normals.resize(p_vertex_count)
+	uvs.resize(p_vertex_count)
+	indices.resize(p_vertex_count)
+	normals.fill(Vector3.UP)
+	for i in p_vertex_count:
+		vertices[i] = Vector3(i % 1000, 0, i / 1000)
+		uvs[i] = Vector2((i % 1000) / 1000.0, (i / 1000) / 1000.0)
+		indices[i] = i
+
+	var arrays = []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = vertices
+	arrays[Mesh.ARRAY_NORMAL] = normals
+	arrays[Mesh.ARRAY_TEX_UV] = uvs
+	arrays[Mesh.ARRAY_INDEX] = indices
+
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, arrays)
+
+	var instance = MeshInstance3D.new()
+	instance.name = "Big"
+	instance.mesh = mesh
+	return instance
+
+
+func _report(p_label: String, p_elements: int, p_usec: int) -> void:
+	var seconds = max(p_usec, 1) / 1000000.0
+	gut.p("%s: %d elements in %.3f s (%.0f elements/s)" % [p_label, p_elements, seconds, p_elements / seconds])
+
+
+func test_bench_array_round_trip():
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	add_child_autofree(scene)
+	scene.add_child(_make_mesh_instance(VERTEX_COUNT))
+
+	# Godot -> USD: points, normals, st and faceVertexIndices
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var start = Time.get_ticks_usec()
+	var err = doc.append_from_scene(scene, state)
+	var elapsed = Time.get_ticks_usec() - start
+	assert_eq(err, OK, "Export should succeed")
+	_report("PackedArray -> VtArray (4 arrays)", VERTEX_COUNT * 4, elapsed)
+
+	var path = BENCH_DIR + "array_round_trip.usdc"
+	err = doc.write_to_filesystem(state, ProjectSettings.globalize_path(path))
+	assert_eq(err, OK, "Write should succeed")
+
+	# USD -> Godot: points and faceVertexIndices through UsdPrimProxy
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	var prim = stage.get_prim_at_path("/Root/Scene/Big/Mesh")
+	assert_not_null(prim, "Should find exported mesh")
+	if prim == null:
+		return
+
+	start = Time.get_ticks_usec()
+	var points = prim.get_attribute("points")
+	var face_indices = prim.get_attribute("faceVertexIndices")
+	elapsed = Time.get_ticks_usec() - start
+	assert_eq(points.size(), VERTEX_COUNT, "Points should round trip")
+	assert_eq(face_indices.size(), VERTEX_COUNT, "Indices should round trip")
+	_report("VtArray -> PackedArray (2 arrays)", VERTEX_COUNT * 2, elapsed)
+	stage.close()
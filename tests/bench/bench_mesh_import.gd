@@ -0,0 +1,111 @@
+extends GutTest
+## Mesh import benchmarks. Not part of the default test run; use
+## ./run_tests.sh --bench. To compare against an older build, run the same
+## benchmark on both builds and compare the reported corners/second.
+
+const GridMeshWriter = preload("res://tests/support/grid_mesh_writer.gd")
+
+const BENCH_DIR = "user://bench/"
+const QUADS_PER_SIDE = 1000  # 1M faces
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _import_and_time(p_path: String, p_weld: bool = false, p_thread_count: int = 0) -> Dictionary:
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.weld_vertices = p_weld
+	state.thread_count = p_thread_count
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+
+	var start = Time.get_ticks_usec()
+	var err = doc.import_from_file(p_path, parent, state)
+	var elapsed = Time.get_ticks_usec() - start
+
+	return {"err": err, "usec": elapsed, "parent": parent}
+
+
+func _report(p_label: String, p_faces: int, p_usec: int) -> void:
+	var corners = p_faces * 6  # two triangles per quad
+	var seconds = max(p_usec, 1) / 1000000.0
+	gut.p("%s: %d faces, %d corners in %.3f s (%.0f corners/s)" % [p_label, p_faces, corners, seconds, corners / seconds])
+
+
+func test_bench_import_1m_face_mesh():
+	var path = BENCH_DIR + "grid_1m.usda"
+	var err = GridMeshWriter.write_grid(path, QUADS_PER_SIDE, {
+		"normals": "vertex",
+		"uvs": "faceVarying",
+		"colors": "constant",
+	})
+	assert_eq(err, OK, "Should write benchmark mesh")
+
+	var result = _import_and_time(path)
+	assert_eq(result.err, OK, "Import should succeed")
+	_report("import_geom_mesh (normals, st, displayColor)", QUADS_PER_SIDE * QUADS_PER_SIDE, result.usec)
+
+
+func test_bench_import_1m_face_mesh_welded():
+	var path = BENCH_DIR + "grid_1m.usda"
+	var err = GridMeshWriter.write_grid(path, QUADS_PER_SIDE, {
+		"normals": "vertex",
+		"uvs": "faceVarying",
+		"colors": "constant",
+	})
+	assert_eq(err, OK, "Should write benchmark mesh")
+
+	var result = _import_and_time(path, true)
+	assert_eq(result.err, OK, "Import should succeed")
+	_report("import_geom_mesh welded (faceVarying st)", QUADS_PER_SIDE * QUADS_PER_SIDE, result.usec)
+
+	path = BENCH_DIR + "grid_1m_vertex.usda"
+	err = GridMeshWriter.write_grid(path, QUADS_PER_SIDE, {"normals": "vertex", "uvs": "vertex"})
+	assert_eq(err, OK, "Should write benchmark mesh")
+
+	result = _import_and_time(path, true)
+	assert_eq(result.err, OK, "Import should succeed")
+	_report("import_geom_mesh welded (vertex st)", QUADS_PER_SIDE * QUADS_PER_SIDE, result.usec)
+
+
+func test_bench_import_thread_scaling():
+	var path = BENCH_DIR + "grid_1m.usda"
+	var err = GridMeshWriter.write_grid(path, QUADS_PER_SIDE, {
+		"normals": "vertex",
+		"uvs": "faceVarying",
+		"colors": "constant",
+	})
+	assert_eq(err, OK, "Should write benchmark mesh")
+
+	for threads in [1, 2, 4, 8]:
+		var result = _import_and_time(path, false, threads)
+		assert_eq(result.err, OK, "Import should succeed")
+		_report("import_geom_mesh %d thread(s)" % threads, QUADS_PER_SIDE * QUADS_PER_SIDE, result.usec)
+
+
+func test_bench_import_synthesized_normals():
+	# No authored normals: exercises the UsdMeshNormals kernel
+	var path = BENCH_DIR + "grid_1m_no_normals.usda"
+	var err = GridMeshWriter.write_grid(path, QUADS_PER_SIDE, {"normals": "", "uvs": "vertex"})
+	assert_eq(err, OK, "Should write benchmark mesh")
+
+	for weld in [false, true]:
+		var result = _import_and_time(path, weld)
+		assert_eq(result.err, OK, "Import should succeed")
+		_report("import_geom_mesh synthesized normals%s" % (" welded" if weld else ""), QUADS_PER_SIDE * QUADS_PER_SIDE, result.usec)
+
+
+func test_bench_import_5000_mesh_stage():
+	# Set-dressing style stage: many small meshes
+	var mesh_count = 5000
+	var path = BENCH_DIR + "grid_set_5000.usda"
+	var err = GridMeshWriter.write_grid_set(path, mesh_count, 16)
+	assert_eq(err, OK, "Should write benchmark stage")
+
+	for threads in [1, 0]:
+		var result = _import_and_time(path, false, threads)
+		assert_eq(result.err, OK, "Import should succeed")
+		gut.p("import_from_file %d meshes, %s: %.3f s" % [mesh_count,
+				"1 thread" if threads == 1 else "all threads", result.usec / 1000000.0])
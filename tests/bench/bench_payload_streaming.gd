@@ -0,0 +1,107 @@
+extends GutTest
+## Lazy payload import benchmark. Not part of the default test run; use
+## ./run_tests.sh --bench. Compares an eager import of a grid of payloads
+## with a lazy import that streams in only the payloads near a viewer.
+
+const BENCH_DIR = "user://bench/"
+const GRID_SIZE = 30 # payloads per side
+const SPACING = 20.0
+const BLOCK_QUADS = 64 # quads per side of each payload's ground mesh
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _write_block(p_path: String) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	var points = PackedStringArray()
+	for z in BLOCK_QUADS + 1:
+		for x in BLOCK_QUADS + 1:
+			points.append("(%f, 0, %f)" % [x * 8.0 / BLOCK_QUADS - 4.0, z * 8.0 / BLOCK_QUADS - 4.0])
+	var counts = PackedStringArray()
+	var indices = PackedStringArray()
+	for z in BLOCK_QUADS:
+		for x in BLOCK_QUADS:
+			var i = z * (BLOCK_QUADS + 1) + x
+			counts.append("4")
+			indices.append("%d, %d, %d, %d" % [i, i + BLOCK_QUADS + 1, i + BLOCK_QUADS + 2, i + 1])
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"Block\"\n)\n\ndef Xform \"Block\"\n{\n")
+	file.store_string("    def Mesh \"Ground\"\n    {\n")
+	file.store_string("        int[] faceVertexCounts = [%s]\n" % ", ".join(counts))
+	file.store_string("        int[] faceVertexIndices = [%s]\n" % ", ".join(indices))
+	file.store_string("        point3f[] points = [%s]\n    }\n" % ", ".join(points))
+	file.store_string("    def Cube \"Tower\"\n    {\n        double size = 4\n    }\n}\n")
+	file.close()
+	return OK
+
+
+func _write_city(p_path: String) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"City\"\n)\n\ndef Xform \"City\"\n{\n")
+	for z in GRID_SIZE:
+		for x in GRID_SIZE:
+			file.store_string("    def Xform \"Block_%d_%d\" (\n        prepend payload = @./payload_block.usda@\n    )\n    {\n" % [x, z])
+			file.store_string("        float3[] extentsHint = [(-4, -2, -4), (4, 2, 4)]\n")
+			file.store_string("        double3 xformOp:translate = (%f, 0, %f)\n" % [x * SPACING, z * SPACING])
+			file.store_string("        uniform token[] xformOpOrder = [\"xformOp:translate\"]\n    }\n")
+	file.store_string("}\n")
+	file.close()
+	return OK
+
+
+func _count_mesh_instances(p_node: Node) -> int:
+	var count = 1 if p_node is MeshInstance3D else 0
+	for child in p_node.get_children():
+		count += _count_mesh_instances(child)
+	return count
+
+
+func test_bench_lazy_payload_streaming():
+	var path = BENCH_DIR + "payload_city.usda"
+	assert_eq(_write_block(BENCH_DIR + "payload_block.usda"), OK, "Should write payload")
+	assert_eq(_write_city(path), OK, "Should write city")
+	var payload_count = GRID_SIZE * GRID_SIZE
+
+	var eager = Node3D.new()
+	add_child_autofree(eager)
+	var start = Time.get_ticks_usec()
+	assert_eq(UsdDocument.new().import_from_file(path, eager, UsdState.new()), OK, "Eager import should succeed")
+	gut.p("eager import, %d payloads: %.3f s, %d meshes" % [payload_count,
+			(Time.get_ticks_usec() - start) / 1000000.0, _count_mesh_instances(eager)])
+	eager.free()
+
+	var lazy = Node3D.new()
+	add_child_autofree(lazy)
+	var state = UsdState.new()
+	state.lazy_payloads = true
+	start = Time.get_ticks_usec()
+	assert_eq(UsdDocument.new().import_from_file(path, lazy, state), OK, "Lazy import should succeed")
+	var loader = UsdPayloadLoader.new()
+	loader.stage_path = path
+	loader.load_radius = 3.0 * SPACING
+	loader.max_loads_per_frame = 0
+	lazy.add_child(loader)
+	assert_eq(loader.open(), OK, "Open should succeed")
+	gut.p("lazy import + open: %.3f s" % ((Time.get_ticks_usec() - start) / 1000000.0))
+
+	# Walk the viewer diagonally across the city
+	var steps = 60
+	var slowest_ms = 0.0
+	start = Time.get_ticks_usec()
+	for step in steps:
+		var t = float(step) / (steps - 1)
+		var frame_start = Time.get_ticks_usec()
+		loader.update_streaming(Vector3(t, 0, t) * SPACING * (GRID_SIZE - 1))
+		slowest_ms = max(slowest_ms, (Time.get_ticks_usec() - frame_start) / 1000.0)
+	gut.p("streamed %d steps: %.3f s total, slowest step %.3f ms, %d of %d payloads loaded at the end, %d meshes" % [steps,
+			(Time.get_ticks_usec() - start) / 1000000.0, slowest_ms, loader.get_loaded_payload_count(), payload_count,
+			_count_mesh_instances(lazy)])
+	assert_lt(loader.get_loaded_payload_count(), payload_count, "Only nearby payloads should be loaded")
@@ -0,0 +1,185 @@
+extends GutTest
+## Scene export benchmarks. Not part of the default test run; use
+## ./run_tests.sh --bench. To compare against an older build, run the same
+## benchmark on both builds and compare the reported nodes/second.
+
+const BENCH_DIR = "user://bench/"
+const GROUP_COUNT = 500
+const NODES_PER_GROUP = 100  # 50k nodes
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _make_scene() -> Node3D:
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var box = BoxMesh.new()
+	for g in GROUP_COUNT:
+		var group = Node3D.new()
+		group.name = "Group_%d" % g
+		group.position = Vector3(g, 0, 0)
+		scene.add_child(group)
+		for n in NODES_PER_GROUP:
+			# Every tenth node carries a mesh, the rest are plain transforms
+			var node: Node3D
+			if n % 10 == 0:
+				node = MeshInstance3D.new()
+				node.mesh = box
+			else:
+				node = Node3D.new()
+			node.name = "Node_%d" % n
+			node.position = Vector3(0, n, 0)
+			group.add_child(node)
+	return scene
+
+
+func test_bench_export_50k_node_scene():
+	var scene = _make_scene()
+	add_child_autofree(scene)
+	var node_count = 1 + GROUP_COUNT * (NODES_PER_GROUP + 1)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var start = Time.get_ticks_usec()
+	var err = doc.append_from_scene(scene, state)
+	var elapsed = Time.get_ticks_usec() - start
+	assert_eq(err, OK, "Export should succeed")
+	var seconds = max(elapsed, 1) / 1000000.0
+	gut.p("append_from_scene: %d nodes in %.3f s (%.0f nodes/s)" % [node_count, seconds, node_count / seconds])
+
+	start = Time.get_ticks_usec()
+	err = doc.write_to_filesystem(state, ProjectSettings.globalize_path(BENCH_DIR + "scene_50k.usda"))
+	assert_eq(err, OK, "Write should succeed")
+	gut.p("write_to_filesystem: %.3f s" % ((Time.get_ticks_usec() - start) / 1000000.0))
+
+
+func _make_mesh_scene(p_mesh_count: int, p_vertex_count: int) -> Node3D:
+	var vertices = PackedVector3Array()
+	var normals = PackedVector3Array()
+	var uvs = PackedVector2Array()
+	var indices = PackedInt32Array()
+	vertices.resize(p_vertex_count)
+	normals.resize(p_vertex_count)
+	uvs.resize(p_vertex_count)
+	indices.resize(p_vertex_count)
+	normals.fill(Vector3.UP)
+	for i in p_vertex_count:
+		vertices[i] = Vector3(i % 100, 0, i / 100)
+		uvs[i] = Vector2((i % 100) / 100.0, (i / 100) / 100.0)
+		indices[i] = i
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	for m in p_mesh_count:
+		# Distinct meshes so nothing is shared between nodes
+		vertices[0] = Vector3(m, 0, 0)
+		var arrays = []
+		arrays.resize(Mesh.ARRAY_MAX)
+		arrays[Mesh.ARRAY_VERTEX] = vertices
+		arrays[Mesh.ARRAY_NORMAL] = normals
+		arrays[Mesh.ARRAY_TEX_UV] = uvs
+		arrays[Mesh.ARRAY_INDEX] = indices
+		var mesh = ArrayMesh.new()
+		mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, arrays)
+
+		var instance = MeshInstance3D.new()
+		instance.name = "Mesh_%d" % m
+		instance.mesh = mesh
+		scene.add_child(instance)
+	return scene
+
+
+func test_bench_export_mesh_heavy_scene_thread_scaling():
+	var mesh_count = 500
+	var vertex_count = 60000  # 30M vertices in total
+	var scene = _make_mesh_scene(mesh_count, vertex_count)
+	add_child_autofree(scene)
+
+	for threads in [1, 2, 4, 8]:
+		var doc = UsdDocument.new()
+		var state = UsdState.new()
+		state.thread_count = threads
+		var start = Time.get_ticks_usec()
+		var err = doc.append_from_scene(scene, state)
+		var seconds = max(Time.get_ticks_usec() - start, 1) / 1000000.0
+		assert_eq(err, OK, "Export should succeed")
+		gut.p("append_from_scene %d meshes, %d thread(s): %.3f s (%.0f vertices/s)" % [mesh_count, threads, seconds,
+				mesh_count * vertex_count / seconds])
+
+
+func _make_multi_surface_scene(p_mesh_count: int, p_surface_count: int) -> Node3D:
+	# 768 vertices per mesh, split evenly between the surfaces
+	var vertices_per_surface = 768 / p_surface_count
+	var vertices = PackedVector3Array()
+	vertices.resize(vertices_per_surface)
+	for i in vertices_per_surface:
+		vertices[i] = Vector3(i % 3, i / 3, 0)
+	var arrays = []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = vertices
+
+	var materials = []
+	for s in p_surface_count:
+		var material = StandardMaterial3D.new()
+		material.resource_name = "Surface_%d" % s
+		materials.append(material)
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	for m in p_mesh_count:
+		var mesh = ArrayMesh.new()
+		for s in p_surface_count:
+			mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, arrays)
+			mesh.surface_set_material(s, materials[s])
+		var instance = MeshInstance3D.new()
+		instance.name = "Mesh_%d" % m
+		instance.mesh = mesh
+		scene.add_child(instance)
+	return scene
+
+
+func test_bench_export_per_surface_cost():
+	# Same vertex count per mesh; only the number of surfaces changes, so the
+	# difference is the cost of extra GeomSubsets and bindings
+	var mesh_count = 500
+	for surface_count in [1, 8, 64]:
+		var scene = _make_multi_surface_scene(mesh_count, surface_count)
+		add_child_autofree(scene)
+		var doc = UsdDocument.new()
+		var state = UsdState.new()
+		var start = Time.get_ticks_usec()
+		var err = doc.append_from_scene(scene, state)
+		var usec = max(Time.get_ticks_usec() - start, 1)
+		assert_eq(err, OK, "Export should succeed")
+		gut.p("append_from_scene %d meshes x %d surface(s): %.3f s (%.3f ms per surface)" % [mesh_count, surface_count,
+				usec / 1000000.0, usec / 1000.0 / (mesh_count * surface_count)])
+
+
+func test_bench_export_shared_mesh_scene():
+	# Many nodes drawing one mesh: geometry is authored once under
+	# /Prototypes, so time and file size should barely depend on node count
+	var vertex_count = 60000
+	var scene = _make_mesh_scene(1, vertex_count)
+	var mesh = scene.get_child(0).mesh
+	for i in range(1, 1000):
+		var instance = MeshInstance3D.new()
+		instance.name = "Mesh_%d" % i
+		instance.mesh = mesh
+		scene.add_child(instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.use_binary_format = true
+	var start = Time.get_ticks_usec()
+	var err = doc.append_from_scene(scene, state)
+	var append_seconds = max(Time.get_ticks_usec() - start, 1) / 1000000.0
+	assert_eq(err, OK, "Export should succeed")
+
+	var path = ProjectSettings.globalize_path(BENCH_DIR + "shared_mesh.usd")
+	assert_eq(doc.write_to_filesystem(state, path), OK, "Write should succeed")
+	var size = FileAccess.open(path, FileAccess.READ).get_length()
+	gut.p("append_from_scene 1000 nodes sharing a %d-vertex mesh: %.3f s, %.1f KiB written" % [vertex_count,
+			append_seconds, size / 1024.0])
@@ -0,0 +1,60 @@
+extends GutTest
+## UsdStagePlayer playback benchmark. Not part of the default test run; use
+## ./run_tests.sh --bench. Target: 10k animated prims within a 16.6 ms
+## frame.
+
+const BENCH_DIR = "user://bench/"
+const PRIM_COUNT = 10000
+const FRAME_COUNT = 600
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(BENCH_DIR)
+
+
+func _write_animated_stage(p_path: String, p_count: int) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"World\"\n    upAxis = \"Y\"\n")
+	file.store_string("    startTimeCode = 0\n    endTimeCode = %d\n    timeCodesPerSecond = 60\n)\n\n" % FRAME_COUNT)
+	file.store_string("def Xform \"World\"\n{\n")
+	for i in p_count:
+		var x = (i % 100) * 2
+		var z = (i / 100) * 2
+		file.store_string("    def Xform \"Item_%d\"\n    {\n" % i)
+		file.store_string("        double3 xformOp:translate.timeSamples = {\n")
+		file.store_string("            0: (%d, 0, %d),\n            %d: (%d, 10, %d),\n        }\n" % [x, z, FRAME_COUNT, x, z])
+		file.store_string("        float xformOp:rotateY.timeSamples = {\n            0: 0,\n            %d: 360,\n        }\n" % FRAME_COUNT)
+		file.store_string("        uniform token[] xformOpOrder = [\"xformOp:translate\", \"xformOp:rotateY\"]\n    }\n")
+	file.store_string("}\n")
+	file.close()
+	return OK
+
+
+func test_bench_play_10k_animated_prims():
+	var path = BENCH_DIR + "animated_10k.usda"
+	assert_eq(_write_animated_stage(path, PRIM_COUNT), OK, "Should write benchmark stage")
+
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(UsdDocument.new().import_from_file(path, parent, UsdState.new()), OK, "Import should succeed")
+
+	var player = UsdStagePlayer.new()
+	player.stage_path = path
+	parent.add_child(player)
+
+	var start = Time.get_ticks_usec()
+	assert_eq(player.load(), OK, "Load should succeed")
+	gut.p("load + index %d prims: %.3f s" % [player.get_animated_prim_count(), (Time.get_ticks_usec() - start) / 1000000.0])
+	assert_eq(player.get_animated_prim_count(), PRIM_COUNT)
+
+	for threads in [1, 0]:
+		player.thread_count = threads
+		start = Time.get_ticks_usec()
+		for frame in FRAME_COUNT:
+			player.seek(frame)
+		var per_frame_ms = (Time.get_ticks_usec() - start) / 1000.0 / FRAME_COUNT
+		gut.p("%d animated prims, %s: %.3f ms/frame" % [PRIM_COUNT,
+				"1 thread" if threads == 1 else "all threads", per_frame_ms])
@@ -0,0 +1,137 @@
+// Benchmark for UsdMeshNormals. Compares the SoA kernels against the AoS
+// loop import_geom_mesh used before them. Has no Godot or USD dependency:
+//
+//   cmake -S . -B build -DUSD_GODOT_BUILD_NATIVE_BENCHMARKS=ON
+//   cmake --build build --target bench_mesh_normals && ./build/bench_mesh_normals
+//
+// or simply:
+//
+//   c++ -O2 -std=c++17 -Isrc tests/bench/native/bench_mesh_normals.cpp src/usd_mesh_normals.cpp
+
+#include "usd_mesh_normals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using godot::UsdMeshNormals;
+
+namespace {
+
+struct Vec3 {
+    float x, y, z;
+
+    Vec3 operator-(const Vec3 &p_v) const { return { x - p_v.x, y - p_v.y, z - p_v.z }; }
+    Vec3 operator*(float p_s) const { return { x * p_s, y * p_s, z * p_s }; }
+    Vec3 &operator+=(const Vec3 &p_v) { x += p_v.x; y += p_v.y; z += p_v.z; return *this; }
+    Vec3 cross(const Vec3 &p_v) const { return { y * p_v.z - z * p_v.y, z * p_v.x - x * p_v.z, x * p_v.y - y * p_v.x }; }
+    float length() const { return std::sqrt(x * x + y * y + z * z); }
+    Vec3 normalized() const {
+        const float l = length();
+        return l == 0.0f ? Vec3{ 0, 0, 0 } : Vec3{ x / l, y / l, z / l };
+    }
+};
+
+// The previous import_geom_mesh loop: AoS, a length and normalize per face.
+void legacy_normals(const std::vector<Vec3> &p_vertices, const std::vector<int32_t> &p_indices, std::vector<Vec3> &r_normals) {
+    r_normals.assign(p_vertices.size(), Vec3{ 0, 0, 0 });
+    for (size_t i = 0; i + 2 < p_indices.size(); i += 3) {
+        const int32_t i0 = p_indices[i], i1 = p_indices[i + 1], i2 = p_indices[i + 2];
+        Vec3 face_normal = (p_vertices[i1] - p_vertices[i0]).cross(p_vertices[i2] - p_vertices[i0]);
+        const float area = face_normal.length() * 0.5f;
+        face_normal = face_normal.normalized();
+        r_normals[i0] += face_normal * area;
+        r_normals[i1] += face_normal * area;
+        r_normals[i2] += face_normal * area;
+    }
+    for (Vec3 &n : r_normals) {
+        n = n.normalized();
+    }
+}
+
+template <typename F>
+double best_of(int p_runs, F p_body) {
+    double best = 1e30;
+    for (int run = 0; run < p_runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        p_body();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int quads_per_side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const int row = quads_per_side + 1;
+    const size_t vertex_count = (size_t)row * row;
+
+    // Bumpy grid, two triangles per quad, shared vertices
+    std::vector<Vec3> aos(vertex_count);
+    std::vector<float> x(vertex_count), y(vertex_count), z(vertex_count);
+    for (int j = 0; j < row; ++j) {
+        for (int i = 0; i < row; ++i) {
+            const size_t v = (size_t)j * row + i;
+            aos[v] = { (float)i, std::sin(i * 0.1f) * std::cos(j * 0.1f), (float)j };
+            x[v] = aos[v].x;
+            y[v] = aos[v].y;
+            z[v] = aos[v].z;
+        }
+    }
+    std::vector<int32_t> indices;
+    indices.reserve((size_t)quads_per_side * quads_per_side * 6);
+    for (int j = 0; j < quads_per_side; ++j) {
+        for (int i = 0; i < quads_per_side; ++i) {
+            const int32_t v0 = j * row + i;
+            indices.insert(indices.end(), { v0 + 1, v0 + row, v0, v0 + row + 1, v0 + row, v0 + 1 });
+        }
+    }
+    const size_t triangle_count = indices.size() / 3;
+    const int runs = 5;
+
+    std::printf("%zu vertices, %zu triangles, best of %d runs\n", vertex_count, triangle_count, runs);
+
+    std::vector<Vec3> legacy;
+    const double legacy_seconds = best_of(runs, [&]() { legacy_normals(aos, indices, legacy); });
+    std::printf("  %-8s %8.2f ms  %7.1f Mtri/s\n", "legacy", legacy_seconds * 1e3, triangle_count / legacy_seconds / 1e6);
+
+    std::vector<float> nx(vertex_count), ny(vertex_count), nz(vertex_count);
+    std::vector<float> ref_x, ref_y, ref_z;
+    const UsdMeshNormals::Kernel kernels[] = { UsdMeshNormals::KERNEL_SCALAR, UsdMeshNormals::KERNEL_SSE, UsdMeshNormals::KERNEL_AVX2 };
+    int failures = 0;
+    for (UsdMeshNormals::Kernel kernel : kernels) {
+        if (!UsdMeshNormals::is_kernel_supported(kernel)) {
+            std::printf("  %-8s (not supported)\n", UsdMeshNormals::get_kernel_name(kernel));
+            continue;
+        }
+        const double seconds = best_of(runs, [&]() {
+            UsdMeshNormals::compute_area_weighted(kernel, x.data(), y.data(), z.data(), vertex_count,
+                    indices.data(), indices.size(), nx.data(), ny.data(), nz.data());
+        });
+
+        // Kernels must agree exactly with the scalar kernel, and with the
+        // legacy loop up to rounding
+        if (kernel == UsdMeshNormals::KERNEL_SCALAR) {
+            ref_x = nx;
+            ref_y = ny;
+            ref_z = nz;
+        }
+        size_t mismatches = 0;
+        float legacy_error = 0.0f;
+        for (size_t v = 0; v < vertex_count; ++v) {
+            mismatches += nx[v] != ref_x[v] || ny[v] != ref_y[v] || nz[v] != ref_z[v];
+            legacy_error = std::max({ legacy_error, std::fabs(nx[v] - legacy[v].x), std::fabs(ny[v] - legacy[v].y), std::fabs(nz[v] - legacy[v].z) });
+        }
+        failures += mismatches > 0 || legacy_error > 1e-5f;
+
+        std::printf("  %-8s %8.2f ms  %7.1f Mtri/s  %5.2fx  mismatches vs scalar: %zu  max error vs legacy: %g\n",
+                UsdMeshNormals::get_kernel_name(kernel), seconds * 1e3, triangle_count / seconds / 1e6,
+                legacy_seconds / seconds, mismatches, legacy_error);
+    }
+    return failures == 0 ? 0 : 1;
+}
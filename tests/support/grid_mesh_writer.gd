@@ -0,0 +1,156 @@
+extends RefCounted
+## Writes synthetic grid meshes as .usda text for tests and benchmarks.
+##
+## The grid lies in the XZ plane with quads_per_side * quads_per_side quad
+## faces. Primvars are optional so callers can exercise specific import paths.
+
+
+## Write a grid mesh to p_path. Supported options:
+##   normals: "" (none), "vertex" or "faceVarying"
+##   uvs: "" (none), "vertex" or "faceVarying"
+##   colors: "" (none), "constant", "uniform" or "vertex"
+static func write_grid(p_path: String, p_quads_per_side: int, p_options: Dictionary = {}) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	var n = p_quads_per_side
+	var row = n + 1
+	var normals_interp: String = p_options.get("normals", "vertex")
+	var uvs_interp: String = p_options.get("uvs", "faceVarying")
+	var colors_interp: String = p_options.get("colors", "")
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"World\"\n    upAxis = \"Y\"\n)\n\n")
+	file.store_string("def Xform \"World\"\n{\n    def Mesh \"Grid\"\n    {\n")
+
+	# Topology
+	file.store_string("        int[] faceVertexCounts = [")
+	var counts = PackedStringArray()
+	counts.resize(n)
+	counts.fill("4")
+	for z in n:
+		file.store_string(", ".join(counts))
+		if z < n - 1:
+			file.store_string(", ")
+	file.store_string("]\n")
+
+	file.store_string("        int[] faceVertexIndices = [")
+	for z in n:
+		var parts = PackedStringArray()
+		for x in n:
+			var i0 = z * row + x
+			parts.append("%d, %d, %d, %d" % [i0, i0 + row, i0 + row + 1, i0 + 1])
+		file.store_string(", ".join(parts))
+		if z < n - 1:
+			file.store_string(", ")
+	file.store_string("]\n")
+
+	# Points
+	file.store_string("        point3f[] points = [")
+	for z in row:
+		var parts = PackedStringArray()
+		for x in row:
+			parts.append("(%d, 0, %d)" % [x, z])
+		file.store_string(", ".join(parts))
+		if z < row - 1:
+			file.store_string(", ")
+	file.store_string("]\n")
+
+	if normals_interp != "":
+		var count = row * row if normals_interp == "vertex" else n * n * 4
+		_store_repeated(file, "        normal3f[] normals = [", "(0, 1, 0)", count)
+		file.store_string(" (\n            interpolation = \"%s\"\n        )\n" % normals_interp)
+
+	if uvs_interp != "":
+		file.store_string("        texCoord2f[] primvars:st = [")
+		for z in (row if uvs_interp == "vertex" else n):
+			var parts = PackedStringArray()
+			if uvs_interp == "vertex":
+				for x in row:
+					parts.append("(%f, %f)" % [float(x) / n, float(z) / n])
+			else:
+				for x in n:
+					var u0 = float(x) / n
+					var u1 = float(x + 1) / n
+					var v0 = float(z) / n
+					var v1 = float(z + 1) / n
+					parts.append("(%f, %f), (%f, %f), (%f, %f), (%f, %f)" % [u0, v0, u0, v1, u1, v1, u1, v0])
+			file.store_string(", ".join(parts))
+			if z < (row if uvs_interp == "vertex" else n) - 1:
+				file.store_string(", ")
+		file.store_string("] (\n            interpolation = \"%s\"\n        )\n" % uvs_interp)
+
+	if colors_interp != "":
+		var count = 1
+		if colors_interp == "uniform":
+			count = n * n
+		elif colors_interp == "vertex":
+			count = row * row
+		_store_repeated(file, "        color3f[] primvars:displayColor = [", "(0.8, 0.4, 0.2)", count)
+		file.store_string(" (\n            interpolation = \"%s\"\n        )\n" % colors_interp)
+
+	file.store_string("    }\n}\n")
+	file.close()
+	return OK
+
+
+## Write p_mesh_count small grid meshes, each under its own Xform, to
+## exercise per-prim import overhead rather than per-face cost.
+static func write_grid_set(p_path: String, p_mesh_count: int, p_quads_per_side: int) -> Error:
+	var file = FileAccess.open(p_path, FileAccess.WRITE)
+	if file == null:
+		return FileAccess.get_open_error()
+
+	var n = p_quads_per_side
+	var row = n + 1
+
+	var counts = PackedStringArray()
+	counts.resize(n * n)
+	counts.fill("4")
+	var indices = PackedStringArray()
+	for z in n:
+		for x in n:
+			var i0 = z * row + x
+			indices.append("%d, %d, %d, %d" % [i0, i0 + row, i0 + row + 1, i0 + 1])
+	var points = PackedStringArray()
+	for z in row:
+		for x in row:
+			points.append("(%d, 0, %d)" % [x, z])
+
+	var mesh_body = "            int[] faceVertexCounts = [%s]\n" % ", ".join(counts)
+	mesh_body += "            int[] faceVertexIndices = [%s]\n" % ", ".join(indices)
+	mesh_body += "            point3f[] points = [%s]\n" % ", ".join(points)
+
+	file.store_string("#usda 1.0\n(\n    defaultPrim = \"World\"\n    upAxis = \"Y\"\n)\n\n")
+	file.store_string("def Xform \"World\"\n{\n")
+	for i in p_mesh_count:
+		file.store_string("    def Xform \"Item_%d\"\n    {\n" % i)
+		file.store_string("        double3 xformOp:translate = (%d, 0, %d)\n" % [(i % 100) * (n + 1), (i / 100) * (n + 1)])
+		file.store_string("        uniform token[] xformOpOrder = [\"xformOp:translate\"]\n\n")
+		file.store_string("        def Mesh \"Mesh\"\n        {\n")
+		file.store_string(mesh_body)
+		file.store_string("        }\n    }\n")
+	file.store_string("}\n")
+	file.close()
+	return OK
+
+
+static func _store_repeated(p_file: FileAccess, p_prefix: String, p_value: String, p_count: int) -> void:
+	p_file.store_string(p_prefix)
+	var chunk_size = 4096
+	var chunk = PackedStringArray()
+	chunk.resize(chunk_size)
+	chunk.fill(p_value)
+	var chunk_text = ", ".join(chunk)
+	var written = 0
+	while written + chunk_size <= p_count:
+		if written > 0:
+			p_file.store_string(", ")
+		p_file.store_string(chunk_text)
+		written += chunk_size
+	if written < p_count:
+		chunk.resize(p_count - written)
+		if written > 0:
+			p_file.store_string(", ")
+		p_file.store_string(", ".join(chunk))
+	p_file.store_string("]")
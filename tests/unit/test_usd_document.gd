@@ -54,3 +54,453 @@ func test_file_extension_for_ascii_format():
 	var ext = doc.get_file_extension_for_format(false)
 	assert_eq(ext, "usda", "ASCII format should use .usda extension")
 	# RefCounted objects are auto-freed
+
+
+func _make_animated_scene(p_length: float) -> Node3D:
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var mover = Node3D.new()
+	mover.name = "Mover"
+	scene.add_child(mover)
+
+	var animation = Animation.new()
+	animation.length = p_length
+	var track = animation.add_track(Animation.TYPE_POSITION_3D)
+	animation.track_set_path(track, NodePath("Mover"))
+	animation.position_track_insert_key(track, 0.0, Vector3.ZERO)
+	animation.position_track_insert_key(track, p_length, Vector3(p_length, 0, 0))
+	var library = AnimationLibrary.new()
+	library.add_animation("move", animation)
+
+	var player = AnimationPlayer.new()
+	player.name = "AnimationPlayer"
+	player.add_animation_library("", library)
+	scene.add_child(player)
+	player.root_node = NodePath("..")
+	return scene
+
+
+func test_export_animations_writes_time_samples():
+	var scene = _make_animated_scene(1.0)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.export_animations = true
+	state.bake_fps = 10.0
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/animation_export.usda"
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	assert_eq(stage.get_end_time_code(), 10.0, "One second at 10 fps is time codes 0-10")
+	var prim = stage.get_prim_at_path("/Root/Scene/Mover")
+	assert_not_null(prim, "Should find the animated node")
+	if prim != null:
+		assert_true(prim.has_attribute("xformOp:translate"), "Animated nodes get a translate op")
+		assert_almost_eq(prim.get_local_transform_at_time(5.0).origin.x, 0.5, 0.001, "Frame 5 is half way")
+		assert_almost_eq(prim.get_local_transform_at_time(10.0).origin.x, 1.0, 0.001)
+	stage.close()
+
+
+func test_export_without_animations_keeps_static_transforms():
+	var scene = _make_animated_scene(1.0)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/animation_export_disabled.usda"
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	var prim = stage.get_prim_at_path("/Root/Scene/Mover")
+	assert_not_null(prim)
+	if prim != null:
+		assert_false(prim.has_attribute("xformOp:translate"), "Static nodes keep a single transform op")
+	stage.close()
+
+
+func _export_simple_scene(p_path: String, p_binary: bool) -> Error:
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	add_child_autofree(scene)
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.use_binary_format = p_binary
+	var err = doc.append_from_scene(scene, state)
+	if err != OK:
+		return err
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	return doc.write_to_filesystem(state, p_path)
+
+
+func _read_header(p_path: String, p_length: int) -> String:
+	var file = FileAccess.open(p_path, FileAccess.READ)
+	if file == null:
+		return ""
+	return file.get_buffer(p_length).get_string_from_ascii()
+
+
+func test_use_binary_format_writes_crate_for_usd_extension():
+	var path = "res://tests/output/binary_export.usd"
+	assert_eq(_export_simple_scene(path, true), OK, "Export should succeed")
+	assert_eq(_read_header(path, 8), "PXR-USDC", "Binary export should write a crate file")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Crate file should reopen")
+	assert_true(stage.has_prim_at_path("/Root/Scene"))
+	stage.close()
+
+
+func test_text_format_for_usd_extension_without_binary():
+	var path = "res://tests/output/text_export.usd"
+	assert_eq(_export_simple_scene(path, false), OK, "Export should succeed")
+	assert_eq(_read_header(path, 5), "#usda", "Text export should write usda")
+
+
+func _make_triangle_surface(p_offset: float) -> Array:
+	var arrays = []
+	arrays.resize(Mesh.ARRAY_MAX)
+	arrays[Mesh.ARRAY_VERTEX] = PackedVector3Array([
+		Vector3(p_offset, 0, 0), Vector3(p_offset + 1, 0, 0), Vector3(p_offset, 1, 0)])
+	return arrays
+
+
+func test_multi_surface_mesh_exports_geom_subsets_with_materials():
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(0.0))
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(2.0))
+	var red = StandardMaterial3D.new()
+	red.resource_name = "Red"
+	var blue = StandardMaterial3D.new()
+	blue.resource_name = "Blue"
+	mesh.surface_set_material(0, red)
+	mesh.surface_set_material(1, blue)
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var mesh_instance = MeshInstance3D.new()
+	mesh_instance.name = "TwoTone"
+	mesh_instance.mesh = mesh
+	scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/multi_surface_export.usda"
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	var prim = stage.get_prim_at_path("/Root/Scene/TwoTone/Mesh")
+	assert_not_null(prim, "Should find the mesh prim")
+	if prim != null:
+		assert_eq(prim.get_attribute("points").size(), 6, "Both surfaces share one point list")
+		var bound = []
+		for child in prim.get_children():
+			if child.get_type_name() != "GeomSubset":
+				continue
+			assert_eq(child.get_attribute("elementType"), "face")
+			assert_eq(child.get_attribute("familyName"), "materialBind")
+			assert_eq(child.get_attribute("indices").size(), 1, "One triangle per surface")
+			bound.append_array(Array(child.get_relationship_targets("material:binding")))
+		bound.sort()
+		assert_eq(bound, ["/Root/Materials/Blue", "/Root/Materials/Red"], "Each subset binds its surface material")
+	assert_true(stage.has_prim_at_path("/Root/Materials"), "Materials live under one scope")
+	stage.close()
+
+
+func test_shared_mesh_is_authored_once_and_referenced():
+	var mesh = ArrayMesh.new()
+	mesh.resource_name = "Shared"
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(0.0))
+	var override = StandardMaterial3D.new()
+	override.resource_name = "Override"
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	for i in 3:
+		var mesh_instance = MeshInstance3D.new()
+		mesh_instance.name = "Copy_%d" % i
+		mesh_instance.mesh = mesh
+		if i == 2:
+			mesh_instance.material_override = override
+		scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/shared_mesh_export.usda"
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	var text = FileAccess.get_file_as_string(path)
+	assert_eq(text.count("point3f[] points"), 1, "Shared geometry should be written once")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	assert_true(stage.has_prim_at_path("/Prototypes/Shared"), "Shared mesh should live in the prototype scope")
+	for i in 3:
+		var prim = stage.get_prim_at_path("/Root/Scene/Copy_%d/Mesh" % i)
+		assert_not_null(prim)
+		if prim != null:
+			assert_eq(prim.get_attribute("points").size(), 3, "Each copy composes the prototype's points")
+	var overridden = stage.get_prim_at_path("/Root/Scene/Copy_2/Mesh")
+	if overridden != null:
+		assert_eq(Array(overridden.get_relationship_targets("material:binding")), ["/Root/Materials/Override"],
+				"Bindings stay per instance")
+	stage.close()
+
+
+func _find_mesh_instances(p_node: Node, r_found: Array) -> void:
+	if p_node is MeshInstance3D:
+		r_found.append(p_node)
+	for child in p_node.get_children():
+		_find_mesh_instances(child, r_found)
+
+
+func _export_painted_scene(p_path: String, p_export_materials: bool) -> void:
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(0.0))
+	var paint = StandardMaterial3D.new()
+	paint.resource_name = "Paint"
+	paint.albedo_color = Color(0.8, 0.2, 0.1)
+	paint.roughness = 0.3
+	paint.metallic = 0.8
+	paint.emission_enabled = true
+	paint.emission = Color(1, 0.5, 0)
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	for i in 2:
+		var mesh_instance = MeshInstance3D.new()
+		mesh_instance.name = "Painted_%d" % i
+		mesh_instance.mesh = mesh
+		mesh_instance.material_override = paint
+		scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.export_materials = p_export_materials
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(p_path)), OK, "Write should succeed")
+
+
+func test_standard_material_exports_as_preview_surface():
+	var path = "res://tests/output/preview_surface_export.usda"
+	_export_painted_scene(path, true)
+
+	var text = FileAccess.get_file_as_string(path)
+	assert_eq(text.count("def Material"), 1, "Shared material should be written once")
+	assert_eq(text.count("uniform token info:id = \"UsdPreviewSurface\""), 1, "Material should carry a UsdPreviewSurface")
+
+	# Round trip through the importer
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.import_from_file(path, parent, state), OK, "Import should succeed")
+	var found = []
+	_find_mesh_instances(parent, found)
+	assert_eq(found.size(), 2, "Both instances should be imported")
+	if found.size() == 2:
+		var material = found[0].get_surface_override_material(0) as StandardMaterial3D
+		assert_not_null(material, "Imported mesh should carry the exported material")
+		if material != null:
+			assert_almost_eq(material.roughness, 0.3, 0.001)
+			assert_almost_eq(material.metallic, 0.8, 0.001)
+			assert_true(material.albedo_color.is_equal_approx(Color(0.8, 0.2, 0.1)), "Albedo should survive the linear round trip")
+			assert_true(material.emission_enabled, "Emission should round trip")
+		assert_same(found[1].get_surface_override_material(0), material, "Both instances share the material")
+
+
+func test_textured_mesh_round_trips_uvs():
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	var texture_path = "res://tests/output/uv_checker.png"
+	var image = Image.create(2, 2, false, Image.FORMAT_RGBA8)
+	image.fill(Color(1, 0, 0))
+	image.set_pixel(0, 0, Color(0, 0, 1))
+	assert_eq(image.save_png(ProjectSettings.globalize_path(texture_path)), OK, "Texture should be written")
+	var texture = ImageTexture.create_from_image(image)
+	texture.take_over_path(texture_path)
+
+	var uvs = PackedVector2Array([Vector2(0, 0), Vector2(1, 0), Vector2(0, 0.25)])
+	var arrays = _make_triangle_surface(0.0)
+	arrays[Mesh.ARRAY_TEX_UV] = uvs
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, arrays)
+	var material = StandardMaterial3D.new()
+	material.resource_name = "Checker"
+	material.albedo_texture = texture
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var mesh_instance = MeshInstance3D.new()
+	mesh_instance.name = "Textured"
+	mesh_instance.mesh = mesh
+	mesh_instance.material_override = material
+	scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/textured_export.usda"
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	# st follows USD's convention, with V running up the texture
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should reopen exported stage")
+	var prim = stage.get_prim_at_path("/Root/Scene/Textured/Mesh")
+	assert_not_null(prim, "Should find the mesh prim")
+	if prim != null:
+		var st = prim.get_attribute("primvars:st")
+		var points = prim.get_attribute("points")
+		assert_eq(st.size(), 3, "st should be per-vertex")
+		for i in st.size():
+			var source = Array(arrays[Mesh.ARRAY_VERTEX]).find(points[i])
+			assert_almost_eq(st[i], Vector2(uvs[source].x, 1.0 - uvs[source].y), Vector2.ONE * 0.001,
+					"Exported st should be V-flipped")
+	stage.close()
+
+	# Importing flips back to Godot's UVs
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(UsdDocument.new().import_from_file(path, parent, UsdState.new()), OK, "Import should succeed")
+	var found = []
+	_find_mesh_instances(parent, found)
+	assert_eq(found.size(), 1, "Mesh should be imported")
+	if found.size() == 1:
+		var imported = found[0].mesh.surface_get_arrays(0)
+		var imported_points = imported[Mesh.ARRAY_VERTEX]
+		var imported_uvs = imported[Mesh.ARRAY_TEX_UV]
+		for i in imported_points.size():
+			var source = Array(arrays[Mesh.ARRAY_VERTEX]).find(imported_points[i])
+			assert_almost_eq(imported_uvs[i], uvs[source], Vector2.ONE * 0.001, "UVs should survive the round trip")
+		var imported_material = found[0].get_surface_override_material(0) as StandardMaterial3D
+		assert_not_null(imported_material, "Material should round trip")
+		if imported_material != null:
+			assert_not_null(imported_material.albedo_texture, "Albedo texture should round trip")
+
+
+func test_texture_paths_are_relative_to_the_export():
+	DirAccess.make_dir_recursive_absolute("res://tests/output/relative")
+	var texture_path = "res://tests/output/relative_checker.png"
+	var image = Image.create(2, 2, false, Image.FORMAT_RGBA8)
+	image.fill(Color(0, 1, 0))
+	assert_eq(image.save_png(ProjectSettings.globalize_path(texture_path)), OK, "Texture should be written")
+	var texture = ImageTexture.create_from_image(image)
+	texture.take_over_path(texture_path)
+
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(0.0))
+	var material = StandardMaterial3D.new()
+	material.albedo_texture = texture
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var mesh_instance = MeshInstance3D.new()
+	mesh_instance.name = "Textured"
+	mesh_instance.mesh = mesh
+	mesh_instance.material_override = material
+	scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	# The same export written next to the texture and one directory below it
+	var beside = "res://tests/output/relative_beside.usda"
+	var below = "res://tests/output/relative/relative_below.usda"
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(beside)), OK, "Write should succeed")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(below)), OK, "Write should succeed")
+
+	var beside_text = FileAccess.get_file_as_string(beside)
+	var below_text = FileAccess.get_file_as_string(below)
+	assert_string_contains(beside_text, "asset inputs:file = @./relative_checker.png@")
+	assert_string_contains(below_text, "asset inputs:file = @../relative_checker.png@")
+	assert_false(below_text.contains(ProjectSettings.globalize_path(texture_path)), "No absolute texture path should be written")
+
+	# The relative path resolves against the written layer
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(UsdDocument.new().import_from_file(below, parent, UsdState.new()), OK, "Import should succeed")
+	var found = []
+	_find_mesh_instances(parent, found)
+	assert_eq(found.size(), 1, "Mesh should be imported")
+	if found.size() == 1:
+		var imported_material = found[0].get_surface_override_material(0) as StandardMaterial3D
+		assert_not_null(imported_material, "Material should round trip")
+		if imported_material != null:
+			assert_not_null(imported_material.albedo_texture, "Albedo texture should resolve from the relative path")
+
+
+func test_multi_material_mesh_round_trips_per_surface():
+	var mesh = ArrayMesh.new()
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(0.0))
+	mesh.add_surface_from_arrays(Mesh.PRIMITIVE_TRIANGLES, _make_triangle_surface(2.0))
+	var red = StandardMaterial3D.new()
+	red.resource_name = "Red"
+	red.albedo_color = Color(1, 0, 0)
+	var blue = StandardMaterial3D.new()
+	blue.resource_name = "Blue"
+	blue.albedo_color = Color(0, 0, 1)
+	mesh.surface_set_material(0, red)
+	mesh.surface_set_material(1, blue)
+
+	var scene = Node3D.new()
+	scene.name = "Scene"
+	var mesh_instance = MeshInstance3D.new()
+	mesh_instance.name = "TwoTone"
+	mesh_instance.mesh = mesh
+	scene.add_child(mesh_instance)
+	add_child_autofree(scene)
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	assert_eq(doc.append_from_scene(scene, state), OK, "Export should succeed")
+	var path = "res://tests/output/two_material_export.usda"
+	DirAccess.make_dir_recursive_absolute("res://tests/output")
+	assert_eq(doc.write_to_filesystem(state, ProjectSettings.globalize_path(path)), OK, "Write should succeed")
+
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(UsdDocument.new().import_from_file(path, parent, UsdState.new()), OK, "Import should succeed")
+	assert_null(parent.find_child("Materials", true, false), "Materials should not become nodes")
+	assert_null(parent.find_child("Surface_*", true, false), "GeomSubsets should not become nodes")
+
+	var found = []
+	_find_mesh_instances(parent, found)
+	assert_eq(found.size(), 1, "Mesh should be imported")
+	if found.size() != 1:
+		return
+	var imported = found[0]
+	assert_eq(imported.mesh.get_surface_count(), 2, "Each GeomSubset should become a surface")
+	var colors = {}
+	for surface in imported.mesh.get_surface_count():
+		var points = imported.mesh.surface_get_arrays(surface)[Mesh.ARRAY_VERTEX]
+		assert_eq(points.size(), 3, "Each surface should keep only its own triangle")
+		var material = imported.get_surface_override_material(surface) as StandardMaterial3D
+		assert_not_null(material, "Each surface should carry its subset's material")
+		if material != null and points.size() == 3:
+			colors[points[0].x < 1.5] = material.albedo_color
+	assert_true(colors.get(true, Color()).is_equal_approx(Color(1, 0, 0)), "First triangle should be red")
+	assert_true(colors.get(false, Color()).is_equal_approx(Color(0, 0, 1)), "Second triangle should be blue")
+
+
+func test_export_materials_can_be_disabled():
+	var path = "res://tests/output/no_materials_export.usda"
+	_export_painted_scene(path, false)
+
+	var text = FileAccess.get_file_as_string(path)
+	assert_eq(text.count("def Material"), 0, "No materials should be written")
+	assert_eq(text.count("material:binding"), 0, "No bindings should be written")
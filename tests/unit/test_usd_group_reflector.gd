@@ -0,0 +1,270 @@
+extends GutTest
+## Tests for UsdGroupReflector - reflecting a stage into a scene group and
+## applying later stage edits to it incrementally
+
+
+const FIXTURES_PATH = "res://tests/fixtures/"
+const OUTPUT_DIR = "user://tests/reflector/"
+
+
+func before_all():
+	DirAccess.make_dir_recursive_absolute(OUTPUT_DIR)
+
+
+# Copy a fixture so edits never touch the original, reflect it under a new
+# parent and open the same file for editing
+func _reflect(p_fixture: String, p_name: String) -> Dictionary:
+	var path = OUTPUT_DIR + p_name + ".usda"
+	DirAccess.copy_absolute(FIXTURES_PATH + p_fixture, path)
+
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var reflector = UsdGroupReflector.new()
+	var root = reflector.reflect(path, parent, p_name)
+	assert_not_null(root, "Reflect should succeed")
+
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should open stage")
+	return {"reflector": reflector, "root": root, "stage": stage}
+
+
+func test_reflect_builds_group():
+	var ctx = _reflect("live_sync.usda", "reflect_group")
+	var root = ctx.root
+	assert_true(ctx.reflector.is_reflected())
+	assert_eq(root.name, "reflect_group")
+	assert_not_null(root.get_node_or_null("Root/A/Box"), "Gprims should be converted")
+	assert_true(root.get_node("Root/B").is_in_group("reflect_group"), "Nodes should join the group")
+	assert_false(ctx.reflector.has_pending_changes(), "Nothing should be pending after reflect")
+
+
+func test_sync_updates_transform_only():
+	var ctx = _reflect("live_sync.usda", "sync_transform")
+	var root = ctx.root
+	var a = root.get_node("Root/A")
+	var b = root.get_node("Root/B")
+	var box = root.get_node("Root/A/Box")
+
+	ctx.stage.set_prim_transform("/Root/A", 0, 3, 0, 0, 0, 0, 1, 1, 1)
+	assert_true(ctx.reflector.has_pending_changes(), "Edit should be pending")
+	assert_true(ctx.reflector.sync(), "Transform edits should sync incrementally")
+
+	assert_eq(root.get_node("Root/A"), a, "Edited prim should keep its node")
+	assert_eq(root.get_node("Root/A/Box"), box, "Children of the edited prim should keep their nodes")
+	assert_eq(root.get_node("Root/B"), b, "Siblings should keep their nodes")
+	assert_almost_eq(a.position, Vector3(0, 3, 0), Vector3.ONE * 0.001)
+
+	var stats = ctx.reflector.get_sync_stats()
+	assert_eq(stats.rebuilt_count, 0, "Transform edits should not rebuild")
+	assert_gt(stats.updated_count, 0, "Transform edit should be applied")
+
+
+func test_sync_rebuilds_resynced_prim_in_place():
+	var ctx = _reflect("live_sync.usda", "sync_resync")
+	var root = ctx.root
+	var parent = root.get_node("Root")
+	var a = root.get_node("Root/A")
+	var b = root.get_node("Root/B")
+	var c = root.get_node("Root/C")
+	var index = b.get_index()
+
+	# Retyping a prim recomposes it
+	ctx.stage.define_prim("/Root/B", "Scope")
+	assert_true(ctx.reflector.sync(), "Resync should be applied in place")
+
+	var rebuilt = parent.get_node("B")
+	assert_ne(rebuilt, b, "Resynced prim should get a new node")
+	assert_eq(rebuilt.get_index(), index, "Rebuilt node should keep its sibling position")
+	assert_true(rebuilt.is_in_group("sync_resync"), "Rebuilt node should join the group")
+	assert_eq(parent.get_node("A"), a, "Untouched siblings should keep their nodes")
+	assert_eq(parent.get_node("C"), c, "Untouched siblings should keep their nodes")
+	assert_eq(ctx.reflector.get_sync_stats().rebuilt_count, 1)
+
+
+func test_sync_adds_new_prim():
+	var ctx = _reflect("live_sync.usda", "sync_add")
+	var root = ctx.root
+	var b = root.get_node("Root/B")
+
+	ctx.stage.define_prim("/Root/B/Extra", "Cube")
+	assert_true(ctx.reflector.sync(), "Added prims should sync incrementally")
+	assert_eq(root.get_node("Root/B"), b, "Parent should keep its node")
+	assert_true(root.get_node_or_null("Root/B/Extra") is MeshInstance3D, "Added gprim should be converted")
+
+
+func test_sync_reimports_mesh_attribute():
+	var ctx = _reflect("live_sync.usda", "sync_mesh")
+	var box = ctx.root.get_node("Root/A/Box") as MeshInstance3D
+	var old_mesh = box.mesh
+
+	ctx.stage.set_prim_attribute("/Root/A/Box", "size", "double", "3")
+	assert_true(ctx.reflector.sync(), "Gprim attributes should sync incrementally")
+
+	assert_eq(ctx.root.get_node("Root/A/Box"), box, "Gprim should keep its node")
+	assert_ne(box.mesh, old_mesh, "Mesh should be re-imported")
+	assert_almost_eq((box.mesh as BoxMesh).size, Vector3(3, 3, 3), Vector3.ONE * 0.001)
+	assert_eq(ctx.reflector.get_sync_stats().rebuilt_count, 0, "Attribute edits should not rebuild")
+
+
+func test_sync_rebuilds_point_instancer():
+	var ctx = _reflect("live_sync.usda", "sync_instancer")
+	var parent = ctx.root.get_node("Root")
+	var scatter = parent.get_node("Scatter")
+	var c = parent.get_node("C")
+	var index = scatter.get_index()
+
+	ctx.stage.set_prim_attribute("/Root/Scatter", "userValue", "int", "1")
+	assert_true(ctx.reflector.sync(), "Instancer attributes should sync incrementally")
+
+	var rebuilt = parent.get_node("Scatter")
+	assert_ne(rebuilt, scatter, "Instancer should be rebuilt")
+	assert_eq(rebuilt.get_index(), index, "Rebuilt instancer should keep its sibling position")
+	assert_eq(parent.get_node("C"), c, "Siblings should keep their nodes")
+
+
+func test_sync_requests_rebuild_for_instance_groups():
+	var ctx = _reflect("instancing.usda", "sync_instances")
+
+	# Box_A is merged into an instance MultiMesh that no node stands for
+	ctx.stage.set_prim_transform("/Root/Box_A", 0, 10, 0, 0, 0, 0, 1, 1, 1)
+	assert_false(ctx.reflector.sync(), "Edits to instances should ask for a full reflect")
+
+
+func test_sync_without_changes_is_a_no_op():
+	var ctx = _reflect("live_sync.usda", "sync_none")
+	assert_true(ctx.reflector.sync())
+	assert_eq(ctx.reflector.get_sync_stats().change_count, 0)
+
+
+# Reflect p_path into a new parent, for the disk cache tests
+func _reflect_file(p_path: String, p_name: String) -> UsdGroupReflector:
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var reflector = UsdGroupReflector.new()
+	assert_not_null(reflector.reflect(p_path, parent, p_name), "Reflect should succeed")
+	return reflector
+
+
+func _copy_fixture(p_fixture: String, p_name: String) -> String:
+	var path = OUTPUT_DIR + p_name + ".usda"
+	DirAccess.copy_absolute(FIXTURES_PATH + p_fixture, path)
+	return path
+
+
+func test_disk_cache_hits_by_prim_path():
+	var path = _copy_fixture("cached_meshes.usda", "disk_cache_hit")
+	var cold = _reflect_file(path, "disk_cache_cold").get_reflect_stats()
+	assert_eq(cold.mesh_count, 2, "Both meshes should be converted")
+	assert_ne(cold.disk_cache_path, "", "File-backed stages should be cached")
+	assert_true(FileAccess.file_exists(cold.disk_cache_path), "Reflect should write the cache")
+
+	var warm_reflector = _reflect_file(path, "disk_cache_warm")
+	var warm = warm_reflector.get_reflect_stats()
+	assert_eq(warm.disk_cache_hits, 2, "Every mesh should load from the cache")
+	assert_eq(warm.disk_cache_path, cold.disk_cache_path, "The same file should map to the same cache")
+
+	# Unwelded, the quad has two triangles' worth of corners and the
+	# triangle one, so swapped entries would show
+	var root = warm_reflector.get_group_root()
+	assert_eq((root.get_node("Root/Quad") as MeshInstance3D).mesh.surface_get_array_len(0), 6)
+	assert_eq((root.get_node("Root/Offset/Triangle") as MeshInstance3D).mesh.surface_get_array_len(0), 3)
+
+
+func test_disk_cache_misses_after_file_changes():
+	var path = _copy_fixture("cached_meshes.usda", "disk_cache_edit")
+	_reflect_file(path, "disk_cache_edit_cold")
+	assert_eq(_reflect_file(path, "disk_cache_edit_warm").get_reflect_stats().disk_cache_hits, 2)
+
+	# A different size invalidates the key
+	var file = FileAccess.open(path, FileAccess.READ_WRITE)
+	file.seek_end()
+	file.store_string("\n# edited\n")
+	file.close()
+	var resized = _reflect_file(path, "disk_cache_resized").get_reflect_stats()
+	assert_eq(resized.disk_cache_hits, 0, "A resized layer should miss")
+	assert_eq(resized.mesh_count, 2, "Meshes should be converted again")
+	assert_eq(_reflect_file(path, "disk_cache_rewarmed").get_reflect_stats().disk_cache_hits, 2,
+			"The cache should be rewritten for the new key")
+
+	# So does a new modification time with the same size
+	OS.delay_msec(1100)
+	var text = FileAccess.get_file_as_string(path)
+	file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_string(text)
+	file.close()
+	assert_eq(_reflect_file(path, "disk_cache_touched").get_reflect_stats().disk_cache_hits, 0,
+			"A layer with a new mtime should miss")
+
+
+func test_disk_cache_rejects_damaged_file():
+	var path = _copy_fixture("cached_meshes.usda", "disk_cache_damaged")
+	var cache_path = _reflect_file(path, "disk_cache_damaged_cold").get_reflect_stats().disk_cache_path
+	var bytes = FileAccess.get_file_as_bytes(cache_path)
+	assert_gt(bytes.size(), 0, "Reflect should write the cache")
+
+	# Truncated: the header is intact but the arrays are cut off
+	var file = FileAccess.open(cache_path, FileAccess.WRITE)
+	file.store_buffer(bytes.slice(0, bytes.size() / 2))
+	file.close()
+	var truncated_reflector = _reflect_file(path, "disk_cache_truncated")
+	var truncated = truncated_reflector.get_reflect_stats()
+	assert_eq(truncated.disk_cache_hits, 0, "A truncated cache should not be used")
+	assert_eq(truncated.mesh_count, 2, "Meshes should be converted instead")
+	assert_eq((truncated_reflector.get_group_root().get_node("Root/Quad") as MeshInstance3D).mesh.surface_get_array_len(0), 6)
+	assert_eq(_reflect_file(path, "disk_cache_repaired").get_reflect_stats().disk_cache_hits, 2,
+			"The truncated cache should be replaced")
+
+	# Corrupt: garbage of the right length
+	var garbage = PackedByteArray()
+	garbage.resize(bytes.size())
+	garbage.fill(0xAB)
+	file = FileAccess.open(cache_path, FileAccess.WRITE)
+	file.store_buffer(garbage)
+	file.close()
+	var corrupt = _reflect_file(path, "disk_cache_corrupt").get_reflect_stats()
+	assert_eq(corrupt.disk_cache_hits, 0, "A corrupt cache should not be used")
+	assert_eq(corrupt.mesh_count, 2, "Meshes should be converted instead")
+
+
+func test_disk_cache_is_skipped_for_unsaved_edits():
+	var path = _copy_fixture("cached_meshes.usda", "disk_cache_unsaved")
+	_reflect_file(path, "disk_cache_unsaved_cold")
+	assert_eq(_reflect_file(path, "disk_cache_unsaved_warm").get_reflect_stats().disk_cache_hits, 2)
+
+	# The edit lives only in the shared layer; the file is unchanged
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should open stage")
+	stage.define_prim("/Root/Extra", "Cube")
+	var edited_reflector = _reflect_file(path, "disk_cache_unsaved_edited")
+	var edited = edited_reflector.get_reflect_stats()
+	assert_eq(edited.disk_cache_path, "", "A layer with unsaved edits should not be cached")
+	assert_eq(edited.disk_cache_hits, 0, "Meshes should be converted from the edited layer")
+	assert_not_null(edited_reflector.get_group_root().get_node_or_null("Root/Extra"), "Reflect should see the edit")
+	stage.close()
+
+
+func test_disk_cache_follows_file_changed_under_open_layer():
+	var path = _copy_fixture("cached_meshes.usda", "disk_cache_stale")
+	var stage = UsdStageProxy.new()
+	assert_eq(stage.open(path), OK, "Should open stage")
+	_reflect_file(path, "disk_cache_stale_cold")
+
+	# Rewrite the quad as a triangle behind the open layer's back
+	OS.delay_msec(1100)
+	var text = FileAccess.get_file_as_string(path)
+	text = text.replace("int[] faceVertexCounts = [4]", "int[] faceVertexCounts = [3]")
+	text = text.replace("int[] faceVertexIndices = [0, 1, 2, 3]", "int[] faceVertexIndices = [0, 1, 2]")
+	var file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_string(text)
+	file.close()
+
+	var changed_reflector = _reflect_file(path, "disk_cache_stale_changed")
+	assert_eq(changed_reflector.get_reflect_stats().disk_cache_hits, 0, "A changed file should miss")
+	assert_eq((changed_reflector.get_group_root().get_node("Root/Quad") as MeshInstance3D).mesh.surface_get_array_len(0), 3,
+			"Meshes should come from the file on disk, not the stale layer")
+
+	# And what was stored under the new key is the new content
+	var warm_reflector = _reflect_file(path, "disk_cache_stale_warm")
+	assert_eq(warm_reflector.get_reflect_stats().disk_cache_hits, 2)
+	assert_eq((warm_reflector.get_group_root().get_node("Root/Quad") as MeshInstance3D).mesh.surface_get_array_len(0), 3)
+	stage.close()
@@ -4,7 +4,10 @@ extends GutTest
 ## They are currently skipped in headless mode due to ArDefaultResolver issues.
 
 
+const GridMeshWriter = preload("res://tests/support/grid_mesh_writer.gd")
+
 const FIXTURES_PATH = "res://tests/fixtures/"
+const OUTPUT_PATH = "res://tests/output/"
 
 
 func test_import_simple_cube_file():
@@ -72,6 +75,225 @@ func test_imported_cube_is_mesh_instance():
 	# RefCounted objects are auto-freed
 
 
+func _import_grid_mesh(p_file: String, p_options: Dictionary, p_state_settings: Dictionary, p_quads_per_side: int = 4) -> ArrayMesh:
+	var path = OUTPUT_PATH + p_file
+	assert_eq(GridMeshWriter.write_grid(path, p_quads_per_side, p_options), OK, "Should write grid mesh")
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	for key in p_state_settings:
+		state.set(key, p_state_settings[key])
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+
+	assert_eq(doc.import_from_file(path, parent, state), OK, "Import should succeed")
+	var grid = _find_node_recursive(parent, "Grid")
+	assert_not_null(grid, "Should find Grid node")
+	return grid.mesh if grid else null
+
+
+func test_weld_vertices_reuses_usd_points():
+	# 4x4 quads: 25 points, 32 triangles
+	var options = {"normals": "vertex", "uvs": "vertex", "colors": "constant"}
+	var unwelded = _import_grid_mesh("grid_unwelded.usda", options, {"weld_vertices": false})
+	var welded = _import_grid_mesh("grid_welded.usda", options, {"weld_vertices": true})
+	if unwelded == null or welded == null:
+		return
+
+	var unwelded_arrays = unwelded.surface_get_arrays(0)
+	var welded_arrays = welded.surface_get_arrays(0)
+	assert_eq(unwelded_arrays[Mesh.ARRAY_VERTEX].size(), 96, "Unwelded import emits one vertex per corner")
+	assert_eq(welded_arrays[Mesh.ARRAY_VERTEX].size(), 25, "Welded import keeps the USD points")
+	assert_eq(welded_arrays[Mesh.ARRAY_INDEX].size(), 96, "Index count is unchanged")
+	assert_eq(welded_arrays[Mesh.ARRAY_TEX_UV].size(), 25, "UVs follow the welded vertices")
+
+
+func test_weld_vertices_merges_face_varying_corners():
+	# Continuous faceVarying UVs and normals weld back to one vertex per point
+	var options = {"normals": "faceVarying", "uvs": "faceVarying"}
+	var welded = _import_grid_mesh("grid_welded_fv.usda", options, {"weld_vertices": true})
+	if welded == null:
+		return
+
+	var arrays = welded.surface_get_arrays(0)
+	assert_eq(arrays[Mesh.ARRAY_VERTEX].size(), 25, "Identical corners should share a vertex")
+	assert_eq(arrays[Mesh.ARRAY_INDEX].size(), 96, "Index count is unchanged")
+
+
+func test_missing_uvs_default_to_zero():
+	# faceVarying normals send the welded import down the hashed path
+	var options = {"normals": "faceVarying", "uvs": ""}
+	for weld in [false, true]:
+		var mesh = _import_grid_mesh("grid_no_uvs.usda", options, {"weld_vertices": weld})
+		if mesh == null:
+			return
+
+		var uvs = mesh.surface_get_arrays(0)[Mesh.ARRAY_TEX_UV]
+		var zeros = PackedVector2Array()
+		zeros.resize(uvs.size())
+		assert_eq(uvs, zeros, "Meshes without st should get (0, 0) UVs (weld_vertices = %s)" % weld)
+
+
+func test_parallel_triangulation_matches_serial():
+	var options = {"normals": "faceVarying", "uvs": "faceVarying", "colors": "uniform"}
+	for weld in [false, true]:
+		var serial = _import_grid_mesh("grid_serial.usda", options,
+				{"weld_vertices": weld, "parallel_face_threshold": 0}, 64)
+		var parallel = _import_grid_mesh("grid_parallel.usda", options,
+				{"weld_vertices": weld, "parallel_face_threshold": 1, "thread_count": 4}, 64)
+		if serial == null or parallel == null:
+			return
+
+		var serial_arrays = serial.surface_get_arrays(0)
+		var parallel_arrays = parallel.surface_get_arrays(0)
+		for array_type in [Mesh.ARRAY_VERTEX, Mesh.ARRAY_NORMAL, Mesh.ARRAY_TEX_UV, Mesh.ARRAY_COLOR, Mesh.ARRAY_INDEX]:
+			assert_eq(parallel_arrays[array_type], serial_arrays[array_type],
+					"Array %d should be identical (weld_vertices = %s)" % [array_type, weld])
+
+
+func _import_grid_set(p_file: String, p_deduplicate: bool) -> Node3D:
+	var path = OUTPUT_PATH + p_file
+	assert_eq(GridMeshWriter.write_grid_set(path, 3, 2), OK, "Should write grid set")
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.deduplicate_meshes = p_deduplicate
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(path, parent, state), OK, "Import should succeed")
+	return parent
+
+
+func test_identical_meshes_share_one_resource():
+	var parent = _import_grid_set("grid_set_dedup.usda", true)
+	var first = _find_node_recursive(parent, "Item_0")
+	var last = _find_node_recursive(parent, "Item_2")
+	assert_not_null(first, "Should find first item")
+	assert_not_null(last, "Should find last item")
+	if first == null or last == null:
+		return
+
+	var first_mesh = first.get_node("Mesh").mesh
+	var last_mesh = last.get_node("Mesh").mesh
+	assert_not_null(first_mesh, "Item should have a mesh")
+	assert_same(first_mesh, last_mesh, "Identical meshes should share one resource")
+
+
+func test_deduplicate_meshes_can_be_disabled():
+	var parent = _import_grid_set("grid_set_no_dedup.usda", false)
+	var first = _find_node_recursive(parent, "Item_0")
+	var last = _find_node_recursive(parent, "Item_2")
+	if first == null or last == null:
+		fail_test("Should find grid set items")
+		return
+
+	assert_not_same(first.get_node("Mesh").mesh, last.get_node("Mesh").mesh, "Each prim should get its own mesh")
+
+
+func test_point_instancer_becomes_multimesh_per_prototype():
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(FIXTURES_PATH + "instancing.usda", parent, state), OK, "Import should succeed")
+
+	var scatter = _find_node_recursive(parent, "Scatter")
+	assert_not_null(scatter, "Should create a node for the instancer")
+	if scatter == null:
+		return
+	assert_null(_find_node_recursive(scatter, "Prototypes"), "Prototypes should not be imported as nodes")
+
+	var cubes = scatter.get_node_or_null("Cube") as MultiMeshInstance3D
+	var spheres = scatter.get_node_or_null("Sphere") as MultiMeshInstance3D
+	assert_not_null(cubes, "Cube prototype should be a MultiMeshInstance3D")
+	assert_not_null(spheres, "Sphere prototype should be a MultiMeshInstance3D")
+	if cubes == null or spheres == null:
+		return
+	assert_eq(cubes.multimesh.instance_count, 3, "Three instances use the cube prototype")
+	assert_eq(spheres.multimesh.instance_count, 1, "One instance uses the sphere prototype")
+	assert_eq(spheres.multimesh.get_instance_transform(0).origin, Vector3(2, 0, 0), "Instance position should be preserved")
+
+
+func test_instanceable_prims_share_one_multimesh():
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(FIXTURES_PATH + "instancing.usda", parent, state), OK, "Import should succeed")
+
+	assert_null(_find_node_recursive(parent, "Box_B"), "Instances should not be expanded into nodes")
+	var boxes = _find_node_recursive(parent, "Box_A_instances") as MultiMeshInstance3D
+	assert_not_null(boxes, "Instances of one prototype should become one MultiMeshInstance3D")
+	if boxes == null:
+		return
+	assert_eq(boxes.multimesh.instance_count, 2, "Both instances should be in the MultiMesh")
+	assert_eq(boxes.multimesh.get_instance_transform(1).origin, Vector3(5, 3, 0), "Instances should keep their world transform")
+
+
+
+func _import_animation(p_tolerance: float, p_fixture: String = "animated_xform") -> Animation:
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	state.import_animation = true
+	state.animation_decimation_tolerance = p_tolerance
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(FIXTURES_PATH + p_fixture + ".usda", parent, state), OK, "Import should succeed")
+
+	var player = parent.get_node_or_null("AnimationPlayer") as AnimationPlayer
+	assert_not_null(player, "Should create an AnimationPlayer")
+	if player == null:
+		return null
+	assert_true(player.has_animation(p_fixture), "Animation should be named after the file")
+	return player.get_animation(p_fixture)
+
+
+func test_import_bakes_time_samples_into_animation():
+	var animation = _import_animation(0.0)
+	if animation == null:
+		return
+	# Mover: position, rotation, scale; Blinker: visibility. Static has none.
+	assert_eq(animation.get_track_count(), 4, "Only time-sampled prims should get tracks")
+	assert_almost_eq(animation.length, 1.0, 0.001, "10 time codes at 10 per second")
+
+	var position_track = animation.find_track(NodePath("Root/Mover"), Animation.TYPE_POSITION_3D)
+	assert_ne(position_track, -1, "Mover should have a position track")
+	assert_eq(animation.track_get_key_count(position_track), 3, "Every authored sample becomes a key")
+	assert_almost_eq(animation.position_track_interpolate(position_track, 0.25).x, 2.5, 0.001)
+
+	var visible_track = animation.find_track(NodePath("Root/Blinker:visible"), Animation.TYPE_VALUE)
+	assert_ne(visible_track, -1, "Blinker should have a visibility track")
+	assert_eq(animation.track_get_key_value(visible_track, 1), false, "Blinker is hidden from time code 5")
+
+
+func test_import_animation_decimates_redundant_keys():
+	var animation = _import_animation(0.001)
+	if animation == null:
+		return
+	var position_track = animation.find_track(NodePath("Root/Mover"), Animation.TYPE_POSITION_3D)
+	var rotation_track = animation.find_track(NodePath("Root/Mover"), Animation.TYPE_ROTATION_3D)
+	assert_eq(animation.track_get_key_count(position_track), 2, "The collinear middle key should be dropped")
+	assert_eq(animation.track_get_key_count(rotation_track), 1, "A constant curve needs one key")
+	assert_almost_eq(animation.position_track_interpolate(position_track, 0.5).x, 5.0, 0.001)
+
+
+func test_import_animation_keeps_full_turns():
+	# rotateY goes 0 -> 360 between two samples; the endpoints are the same
+	# orientation, so the bake has to add keys in between to spin at all
+	for tolerance in [0.0, 0.001]:
+		var animation = _import_animation(tolerance, "spinning_xform")
+		if animation == null:
+			return
+		var rotation_track = animation.find_track(NodePath("Root/Spinner"), Animation.TYPE_ROTATION_3D)
+		assert_ne(rotation_track, -1, "Spinner should have a rotation track")
+		assert_gt(animation.track_get_key_count(rotation_track), 2, "A full turn needs keys between the authored samples")
+		for step in 9:
+			var expected = Quaternion(Vector3.UP, deg_to_rad(45.0 * step))
+			var rotation = animation.rotation_track_interpolate(rotation_track, animation.length * step / 8.0)
+			assert_almost_eq(rotation.angle_to(expected), 0.0, 0.01,
+					"Spinner should be at %d degrees (tolerance %s)" % [45 * step, tolerance])
+
+
 func _find_node_recursive(node: Node, name: String) -> Node:
 	if node.name == name:
 		return node
@@ -80,3 +302,121 @@ func _find_node_recursive(node: Node, name: String) -> Node:
 		if found:
 			return found
 	return null
+
+
+func _import_materials() -> Node3D:
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(FIXTURES_PATH + "preview_surface_materials.usda", parent, state), OK, "Import should succeed")
+	return parent
+
+
+func test_preview_surface_material_is_shared_by_bound_prims():
+	var parent = _import_materials()
+	var metal_a = _find_node_recursive(parent, "Metal_A") as MeshInstance3D
+	var metal_b = _find_node_recursive(parent, "Metal_B") as MeshInstance3D
+	var inherited = _find_node_recursive(parent, "Inherited") as MeshInstance3D
+	if metal_a == null or metal_b == null or inherited == null:
+		fail_test("Should find the bound cubes")
+		return
+
+	var material = metal_a.get_surface_override_material(0) as StandardMaterial3D
+	assert_not_null(material, "UsdPreviewSurface should become a StandardMaterial3D")
+	if material == null:
+		return
+	assert_same(metal_b.get_surface_override_material(0), material, "Prims bound to one material share it")
+	assert_same(inherited.get_surface_override_material(0), material, "Bindings are inherited from ancestors")
+	assert_eq(material.resource_name, "Metal")
+	assert_almost_eq(material.metallic, 1.0, 0.001)
+	assert_almost_eq(material.roughness, 0.25, 0.001)
+	assert_almost_eq(material.albedo_color.r, 1.0, 0.001)
+
+
+func test_preview_surface_emission_and_opacity():
+	var parent = _import_materials()
+	var window = _find_node_recursive(parent, "Window") as MeshInstance3D
+	if window == null:
+		fail_test("Should find the window cube")
+		return
+	var material = window.get_surface_override_material(0) as StandardMaterial3D
+	assert_not_null(material)
+	if material == null:
+		return
+	assert_true(material.emission_enabled, "Non-black emissiveColor enables emission")
+	assert_almost_eq(material.emission.b, 1.0, 0.001)
+	assert_eq(material.transparency, BaseMaterial3D.TRANSPARENCY_ALPHA, "Opacity below one is alpha blended")
+	assert_almost_eq(material.albedo_color.a, 0.5, 0.001)
+
+
+func test_display_color_still_applies_without_binding():
+	var parent = _import_materials()
+	var painted = _find_node_recursive(parent, "Painted") as MeshInstance3D
+	if painted == null:
+		fail_test("Should find the painted cube")
+		return
+	var material = painted.get_surface_override_material(0) as StandardMaterial3D
+	assert_not_null(material, "displayColor should still produce a material")
+	if material != null:
+		assert_eq(material.albedo_color, Color(0, 1, 0))
+
+
+func test_preview_surface_diffuse_texture():
+	DirAccess.make_dir_recursive_absolute(OUTPUT_PATH)
+	var image = Image.create(4, 4, false, Image.FORMAT_RGBA8)
+	image.fill(Color(1, 0.5, 0, 1))
+	assert_eq(image.save_png(OUTPUT_PATH + "diffuse.png"), OK, "Should write texture")
+
+	var usda = """#usda 1.0
+def Material "Textured"
+{
+    token outputs:surface.connect = </Textured/Surface.outputs:surface>
+
+    def Shader "Surface"
+    {
+        uniform token info:id = "UsdPreviewSurface"
+        color3f inputs:diffuseColor.connect = </Textured/Diffuse.outputs:rgb>
+        float inputs:roughness.connect = </Textured/Diffuse.outputs:g>
+        token outputs:surface
+    }
+
+    def Shader "Diffuse"
+    {
+        uniform token info:id = "UsdUVTexture"
+        asset inputs:file = @./diffuse.png@
+        float3 outputs:rgb
+        float outputs:g
+    }
+}
+
+def Cube "Box" (
+    prepend apiSchemas = ["MaterialBindingAPI"]
+)
+{
+    rel material:binding = </Textured>
+}
+"""
+	var path = OUTPUT_PATH + "textured_material.usda"
+	var file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_string(usda)
+	file.close()
+
+	var doc = UsdDocument.new()
+	var state = UsdState.new()
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	assert_eq(doc.import_from_file(path, parent, state), OK, "Import should succeed")
+	var box = _find_node_recursive(parent, "Box") as MeshInstance3D
+	if box == null:
+		fail_test("Should find the textured cube")
+		return
+	var material = box.get_surface_override_material(0) as StandardMaterial3D
+	assert_not_null(material)
+	if material == null:
+		return
+	assert_not_null(material.albedo_texture, "Connected diffuseColor should load the texture")
+	if material.albedo_texture != null:
+		assert_eq(material.albedo_texture.get_width(), 4, "The decoded image should replace the placeholder")
+	assert_same(material.roughness_texture, material.albedo_texture, "One file should be loaded once")
+	assert_eq(material.roughness_texture_channel, BaseMaterial3D.TEXTURE_CHANNEL_GREEN)
@@ -0,0 +1,85 @@
+extends GutTest
+## Tests for lazy payload import and UsdPayloadLoader
+
+
+const FIXTURE = "res://tests/fixtures/payload_city.usda"
+
+
+func _import(p_lazy: bool) -> Node3D:
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var state = UsdState.new()
+	state.lazy_payloads = p_lazy
+	assert_eq(UsdDocument.new().import_from_file(FIXTURE, parent, state), OK, "Import should succeed")
+	return parent
+
+
+func _import_with_loader() -> UsdPayloadLoader:
+	var parent = _import(true)
+	var loader = UsdPayloadLoader.new()
+	loader.stage_path = FIXTURE
+	parent.add_child(loader)
+	assert_eq(loader.open(), OK, "Open should succeed")
+	return loader
+
+
+func test_lazy_import_creates_placeholders_with_bounds():
+	var parent = _import(true)
+	var near = parent.get_node_or_null("City/Near") as Node3D
+	assert_not_null(near, "Payload prim should have a placeholder")
+	if near != null:
+		assert_eq(near.get_child_count(), 0, "Payload contents should not be converted")
+		assert_eq(near.get_meta("usd_payload"), "/City/Near")
+		assert_eq(near.get_meta("usd_payload_bounds"), AABB(Vector3(-1, 0, -1), Vector3(2, 2, 2)), "Bounds come from extentsHint")
+	var far = parent.get_node_or_null("City/Far") as Node3D
+	if far != null:
+		assert_almost_eq(far.position.x, 1000.0, 0.001, "Placeholders keep the prim's transform")
+
+
+func test_eager_import_converts_payloads():
+	var parent = _import(false)
+	assert_true(parent.get_node_or_null("City/Near/Tower") is MeshInstance3D, "Payloads load by default")
+	assert_false(parent.get_node("City/Near").has_meta("usd_payload"))
+
+
+func test_load_and_unload_payload():
+	var loader = _import_with_loader()
+	var city = loader.get_parent().get_node("City")
+	assert_eq(loader.get_payload_paths(), PackedStringArray(["/City/Far", "/City/Near"]))
+	assert_eq(loader.get_loaded_payload_count(), 0)
+
+	watch_signals(loader)
+	assert_eq(loader.load_payload("/City/Near"), OK, "Load should succeed")
+	assert_true(loader.is_payload_loaded("/City/Near"))
+	assert_true(city.get_node_or_null("Near/Tower") is MeshInstance3D, "Payload contents should be converted")
+	assert_eq(city.get_child(0).name, "Near", "Converted prim keeps the placeholder's place")
+	assert_signal_emitted_with_parameters(loader, "payload_loaded", ["/City/Near"])
+
+	assert_eq(loader.unload_payload("/City/Near"), OK, "Unload should succeed")
+	assert_false(loader.is_payload_loaded("/City/Near"))
+	var placeholder = city.get_node("Near")
+	assert_true(placeholder.has_meta("usd_payload"), "Placeholder should be restored")
+	assert_eq(placeholder.get_child_count(), 0)
+	assert_signal_emitted_with_parameters(loader, "payload_unloaded", ["/City/Near"])
+
+	assert_eq(loader.load_payload("/City/Nowhere"), ERR_DOES_NOT_EXIST)
+
+
+func test_streaming_follows_viewer_distance():
+	var loader = _import_with_loader()
+	loader.load_radius = 20.0
+	loader.unload_margin = 5.0
+	loader.max_loads_per_frame = 0
+
+	loader.update_streaming(Vector3(0, 0, 10))
+	assert_true(loader.is_payload_loaded("/City/Near"), "Payload within the radius should load")
+	assert_false(loader.is_payload_loaded("/City/Far"), "Distant payload should stay unloaded")
+
+	# Inside the unload margin: stays loaded
+	loader.update_streaming(Vector3(0, 0, 23))
+	assert_true(loader.is_payload_loaded("/City/Near"))
+
+	loader.update_streaming(Vector3(1000, 0, 10))
+	assert_false(loader.is_payload_loaded("/City/Near"), "Payload beyond radius + margin should unload")
+	assert_true(loader.is_payload_loaded("/City/Far"))
+	assert_eq(loader.get_loaded_payload_count(), 1)
@@ -0,0 +1,67 @@
+extends GutTest
+## Tests for UsdStagePlayer time-sampled playback
+
+
+const FIXTURE = "res://tests/fixtures/animated_xform.usda"
+
+
+func _import_with_player() -> UsdStagePlayer:
+	var parent = Node3D.new()
+	add_child_autofree(parent)
+	var err = UsdDocument.new().import_from_file(FIXTURE, parent, UsdState.new())
+	assert_eq(err, OK, "Import should succeed")
+
+	var player = UsdStagePlayer.new()
+	player.stage_path = FIXTURE
+	parent.add_child(player)
+	return player
+
+
+func test_load_indexes_only_animated_prims():
+	var player = _import_with_player()
+	assert_eq(player.load(), OK, "Load should succeed")
+	assert_true(player.is_loaded())
+	# Mover's translate and Blinker's visibility; Static is skipped
+	assert_eq(player.get_animated_prim_count(), 2, "Should index two animated prims")
+	assert_eq(player.get_start_time_code(), 0.0)
+	assert_eq(player.get_end_time_code(), 10.0)
+
+
+func test_seek_updates_transform_and_visibility():
+	var player = _import_with_player()
+	assert_eq(player.load(), OK, "Load should succeed")
+	var root = player.get_parent().get_node("Root")
+	var mover = root.get_node("Mover") as Node3D
+	var blinker = root.get_node("Blinker") as Node3D
+
+	player.seek(5.0)
+	assert_almost_eq(mover.position.x, 5.0, 0.001, "Translate should be interpolated")
+	assert_false(blinker.visible, "Blinker should be hidden from time code 5")
+
+	player.seek(2.0)
+	assert_almost_eq(mover.position.x, 2.0, 0.001)
+	assert_true(blinker.visible, "Blinker should be visible before time code 5")
+
+
+func test_playback_advances_and_clamps_without_loop():
+	var player = _import_with_player()
+	assert_eq(player.load(), OK, "Load should succeed")
+	player.loop = false
+	watch_signals(player)
+	player.play()
+
+	# 10 time codes per second in the fixture
+	player._process(0.5)
+	assert_almost_eq(player.time_code, 5.0, 0.001)
+	player._process(1.0)
+	assert_eq(player.time_code, 10.0, "Should clamp at the end time code")
+	assert_false(player.is_playing())
+	assert_signal_emitted(player, "finished")
+
+
+func test_load_fails_for_missing_stage():
+	var player = UsdStagePlayer.new()
+	add_child_autofree(player)
+	player.stage_path = "res://tests/fixtures/does_not_exist.usda"
+	assert_ne(player.load(), OK, "Load should fail for a missing file")
+	assert_false(player.is_loaded())
@@ -118,6 +118,117 @@ func test_get_time_range():
 	# RefCounted objects are auto-freed
 
 
+# -----------------------------------------------------------------------------
+# Change Notification Tests
+# -----------------------------------------------------------------------------
+
+func test_take_changes_reports_edited_paths():
+	var stage = UsdStageProxy.new()
+	stage.create_new("res://tests/output/changes_test.usda")
+	stage.define_prim("/World", "Xform")
+	stage.take_changes()
+
+	stage.set_prim_transform("/World", 1, 2, 3, 0, 0, 0, 1, 1, 1)
+	var changes = stage.take_changes()
+	var paths = changes.changed_info + changes.resynced
+	assert_gt(paths.size(), 0, "Edit should be reported")
+	for path in paths:
+		assert_true(path.begins_with("/World."), "Only /World properties changed, got " + path)
+
+	changes = stage.take_changes()
+	assert_eq(changes.changed_info.size() + changes.resynced.size(), 0, "Changes should be consumed")
+	# RefCounted objects are auto-freed
+
+
+# -----------------------------------------------------------------------------
+# Spatial Query Tests
+# -----------------------------------------------------------------------------
+
+# Two unit-extent cubes: /World/A at the origin, /World/B at x=10 turned 45
+# degrees about Y
+func _create_bounds_stage(path: String) -> UsdStageProxy:
+	var stage = UsdStageProxy.new()
+	stage.create_new(path)
+	stage.define_prim("/World", "Xform")
+	stage.define_prim("/World/A", "Cube")
+	stage.define_prim("/World/B", "Cube")
+	stage.set_prim_transform("/World/B", 10, 0, 0, 0, 45, 0, 1, 1, 1)
+	return stage
+
+
+func test_get_bounds_encloses_rotated_prims():
+	var stage = _create_bounds_stage("res://tests/output/bounds_test.usda")
+
+	var bounds = stage.get_bounds("/World/B")
+	var half_diagonal = sqrt(2.0)
+	assert_almost_eq(bounds.position, Vector3(10 - half_diagonal, -1, -half_diagonal), Vector3.ONE * 0.001)
+	assert_almost_eq(bounds.size, Vector3(2 * half_diagonal, 2, 2 * half_diagonal), Vector3.ONE * 0.001)
+
+	var world = stage.get_bounds("/World")
+	assert_almost_eq(world.position.x, -1.0, 0.001, "World bounds should start at /World/A")
+	assert_almost_eq(world.end.x, 10 + half_diagonal, 0.001, "World bounds should end at /World/B")
+
+	assert_eq(stage.get_bounds("/Missing"), AABB(), "No geometry should give an empty AABB")
+	# RefCounted objects are auto-freed
+
+
+func test_raycast_returns_nearest_prim():
+	var stage = _create_bounds_stage("res://tests/output/raycast_test.usda")
+
+	var hit = stage.raycast(Vector3(-10, 0, 0), Vector3(1, 0, 0))
+	assert_eq(hit.get("prim_path"), "/World/A", "Ray along +X should hit the nearer cube")
+	assert_almost_eq(hit.get("distance", 0.0), 9.0, 0.001)
+	assert_almost_eq(hit.get("position", Vector3.ZERO), Vector3(-1, 0, 0), Vector3.ONE * 0.001)
+
+	hit = stage.raycast(Vector3(20, 0, 0), Vector3(-1, 0, 0))
+	assert_eq(hit.get("prim_path"), "/World/B", "Ray along -X should hit the other cube first")
+
+	assert_true(stage.raycast(Vector3(-10, 0, 0), Vector3(0, 1, 0)).is_empty(), "Ray along +Y should miss")
+	assert_true(stage.raycast(Vector3(-10, 0, 0), Vector3(1, 0, 0), 5.0).is_empty(), "Hit beyond max_distance should miss")
+	# RefCounted objects are auto-freed
+
+
+func test_query_aabb_and_frustum():
+	var stage = _create_bounds_stage("res://tests/output/query_test.usda")
+
+	var paths = stage.query_aabb(AABB(Vector3(8, -1, -1), Vector3(4, 2, 2)))
+	assert_eq(Array(paths), ["/World/B"], "Box around x=10 should only contain /World/B")
+
+	# Normals point out of the volume, as in Camera3D.get_frustum()
+	var planes = [
+		Plane(Vector3(1, 0, 0), 0.5),
+		Plane(Vector3(-1, 0, 0), 0.5),
+		Plane(Vector3(0, 1, 0), 0.5),
+		Plane(Vector3(0, -1, 0), 0.5),
+		Plane(Vector3(0, 0, 1), 0.5),
+		Plane(Vector3(0, 0, -1), 0.5),
+	]
+	paths = stage.query_frustum(planes)
+	assert_eq(Array(paths), ["/World/A"], "Volume around the origin should only contain /World/A")
+	# RefCounted objects are auto-freed
+
+
+func test_bounds_follow_edits_without_rebuilding():
+	var stage = _create_bounds_stage("res://tests/output/bounds_update_test.usda")
+	stage.get_bounds()
+	var before = stage.get_bounds_stats()
+	assert_eq(before.leaf_count, 2, "Both cubes should be leaves")
+
+	# Moving a prim refits its leaf in place
+	stage.set_prim_transform("/World/A", 0, 5, 0, 0, 0, 0, 1, 1, 1)
+	var bounds = stage.get_bounds("/World/A")
+	assert_almost_eq(bounds.get_center(), Vector3(0, 5, 0), Vector3.ONE * 0.001)
+	var after = stage.get_bounds_stats()
+	assert_eq(after.rebuild_count, before.rebuild_count, "A transform edit should not rebuild the tree")
+	assert_gt(after.refit_count, before.refit_count, "A transform edit should refit")
+
+	# Adding a prim re-reads that subtree
+	stage.define_prim("/World/C", "Sphere")
+	assert_eq(stage.get_bounds_stats().leaf_count, 3, "New prim should become a leaf")
+	assert_eq(stage.raycast(Vector3(0, 0, -10), Vector3(0, 0, 1)).get("prim_path"), "/World/C")
+	# RefCounted objects are auto-freed
+
+
 # -----------------------------------------------------------------------------
 # Metadata Tests
 # -----------------------------------------------------------------------------